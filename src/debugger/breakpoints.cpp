@@ -10,6 +10,7 @@
 #include "debugger/breakpoint_hotreload.h"
 #include "debugger/breakpoints.h"
 #include "debugger/breakpointutils.h"
+#include "debugger/snapshots.h"
 
 #include <mutex>
 #include <unordered_set>
@@ -89,11 +90,24 @@ HRESULT Breakpoints::DisableAll(ICorDebugProcess *pProcess)
 
 HRESULT Breakpoints::SetFuncBreakpoints(bool haveProcess, const std::vector<FuncBreakpoint> &funcBreakpoints, std::vector<Breakpoint> &breakpoints)
 {
-    return m_uniqueFuncBreakpoints->SetFuncBreakpoints(haveProcess, funcBreakpoints, breakpoints, [&]() -> uint32_t
+    for (const auto &fb : funcBreakpoints)
+    {
+        if (fb.triggerId && !IsTriggerBreakpoint(fb.triggerId))
+        {
+            LOGE("Unknown trigger breakpoint id %u", (unsigned)fb.triggerId);
+            return E_INVALIDARG;
+        }
+    }
+
+    HRESULT Status;
+    IfFailRet(m_uniqueFuncBreakpoints->SetFuncBreakpoints(haveProcess, funcBreakpoints, breakpoints, [&]() -> uint32_t
     {
         std::lock_guard<std::mutex> lock(m_nextBreakpointIdMutex);
         return m_nextBreakpointId++;
-    });
+    }));
+
+    ResetRemovedTriggers();
+    return S_OK;
 }
 
 HRESULT Breakpoints::UpdateLineBreakpoint(bool haveProcess, int id, int linenum, Breakpoint &breakpoint)
@@ -103,11 +117,24 @@ HRESULT Breakpoints::UpdateLineBreakpoint(bool haveProcess, int id, int linenum,
 
 HRESULT Breakpoints::SetLineBreakpoints(bool haveProcess, const std::string& filename, const std::vector<LineBreakpoint> &lineBreakpoints, std::vector<Breakpoint> &breakpoints)
 {
-    return m_uniqueLineBreakpoints->SetLineBreakpoints(haveProcess, filename, lineBreakpoints, breakpoints, [&]() -> uint32_t
+    for (const auto &lb : lineBreakpoints)
+    {
+        if (lb.triggerId && !IsTriggerBreakpoint(lb.triggerId))
+        {
+            LOGE("Unknown trigger breakpoint id %u", (unsigned)lb.triggerId);
+            return E_INVALIDARG;
+        }
+    }
+
+    HRESULT Status;
+    IfFailRet(m_uniqueLineBreakpoints->SetLineBreakpoints(haveProcess, filename, lineBreakpoints, breakpoints, [&]() -> uint32_t
     {
         std::lock_guard<std::mutex> lock(m_nextBreakpointIdMutex);
         return m_nextBreakpointId++;
-    });
+    }));
+
+    ResetRemovedTriggers();
+    return S_OK;
 }
 
 HRESULT Breakpoints::SetExceptionBreakpoints(const std::vector<ExceptionBreakpoint> &exceptionBreakpoints, std::vector<Breakpoint> &breakpoints)
@@ -164,16 +191,31 @@ HRESULT Breakpoints::ManagedCallbackBreakpoint(ICorDebugThread *pThread, ICorDeb
         return S_OK; // forced to interrupt this callback (breakpoint in not user code, continue process execution)
     }
 
+    auto BreakpointHit = [&]() -> HRESULT
+    {
+        // Trigger breakpoint never stop debuggee, enable dependent breakpoints and continue.
+        bool trigger = TriggerBreakpoints(breakpoint.id);
+
+        if (!breakpoint.snapshot.IsEnabled())
+            return trigger ? S_OK : S_FALSE; // S_FALSE - not affect on callback (callback will emit stop event)
+
+        // Snapshot breakpoint never stop debuggee, capture data and continue (error here is not fatal for debug process).
+        if (FAILED(m_sharedSnapshots->CaptureSnapshot(pThread, breakpoint)))
+            LOGE("Snapshot capture failed for breakpoint %u", (unsigned)breakpoint.id);
+
+        return S_OK; // forced to interrupt this callback (snapshot captured, continue process execution)
+    };
+
     if (SUCCEEDED(Status = m_uniqueLineBreakpoints->CheckBreakpointHit(pThread, pBreakpoint, breakpoint)) &&
         Status == S_OK) // S_FALSE - no breakpoint hit
     {
-        return S_FALSE; // S_FALSE - not affect on callback (callback will emit stop event)
+        return BreakpointHit();
     }
 
     if (SUCCEEDED(Status = m_uniqueFuncBreakpoints->CheckBreakpointHit(pThread, pBreakpoint, breakpoint)) &&
         Status == S_OK) // S_FALSE - no breakpoint hit
     {
-        return S_FALSE; // S_FALSE - not affect on callback (callback will emit stop event)
+        return BreakpointHit();
     }
 
     return S_OK; // no breakpoints hit, forced to interrupt this callback
@@ -213,6 +255,46 @@ HRESULT Breakpoints::BreakpointActivate(uint32_t id, bool act)
     return m_uniqueFuncBreakpoints->BreakpointActivate(id, act);
 }
 
+bool Breakpoints::IsTriggerBreakpoint(uint32_t id)
+{
+    // Note, only line and function breakpoints hit could enable dependent breakpoints.
+    return m_uniqueLineBreakpoints->HaveBreakpoint(id) || m_uniqueFuncBreakpoints->HaveBreakpoint(id);
+}
+
+bool Breakpoints::TriggerBreakpoints(uint32_t id)
+{
+    // Note, dependent breakpoint is enabled only once after it was armed (set with trigger breakpoint id),
+    // so, user's explicit disable is not changed by next trigger breakpoint hit.
+    std::vector<uint32_t> ids;
+    bool haveLineDependent = m_uniqueLineBreakpoints->GetTriggeredBreakpoints(id, ids);
+    bool haveFuncDependent = m_uniqueFuncBreakpoints->GetTriggeredBreakpoints(id, ids);
+
+    for (auto triggeredId : ids)
+    {
+        if (FAILED(BreakpointActivate(triggeredId, true)))
+            LOGE("Dependent breakpoint %u activation failed", (unsigned)triggeredId);
+    }
+
+    return haveLineDependent || haveFuncDependent;
+}
+
+void Breakpoints::ResetRemovedTriggers()
+{
+    std::unordered_set<uint32_t> existingIds;
+    m_uniqueLineBreakpoints->AddBreakpointsIds(existingIds);
+    m_uniqueFuncBreakpoints->AddBreakpointsIds(existingIds);
+
+    std::vector<uint32_t> ids;
+    m_uniqueLineBreakpoints->ResetRemovedTriggers(existingIds, ids);
+    m_uniqueFuncBreakpoints->ResetRemovedTriggers(existingIds, ids);
+
+    for (auto dependentId : ids)
+    {
+        if (FAILED(BreakpointActivate(dependentId, true)))
+            LOGE("Dependent breakpoint %u activation failed", (unsigned)dependentId);
+    }
+}
+
 // This function allows to enumerate breakpoints (sorted by number).
 // Callback which is called for each breakpoint might return `false` to stop iteration over breakpoints list.
 void Breakpoints::EnumerateBreakpoints(std::function<bool (const IDebugger::BreakpointInfo&)>&& callback)
@@ -23,12 +23,14 @@ class ExceptionBreakpoints;
 class FuncBreakpoints;
 class LineBreakpoints;
 class HotReloadBreakpoint;
+class Snapshots;
 
 class Breakpoints
 {
 public:
 
-    Breakpoints(std::shared_ptr<Modules> &sharedModules, std::shared_ptr<Evaluator> &sharedEvaluator, std::shared_ptr<EvalHelpers> &sharedEvalHelpers, std::shared_ptr<Variables> &sharedVariables) :
+    Breakpoints(std::shared_ptr<Modules> &sharedModules, std::shared_ptr<Evaluator> &sharedEvaluator, std::shared_ptr<EvalHelpers> &sharedEvalHelpers, std::shared_ptr<Variables> &sharedVariables, std::shared_ptr<Snapshots> &sharedSnapshots) :
+        m_sharedSnapshots(sharedSnapshots),
         m_uniqueBreakBreakpoint(new BreakBreakpoint(sharedModules)),
         m_uniqueEntryBreakpoint(new EntryBreakpoint(sharedModules)),
         m_uniqueExceptionBreakpoints(new ExceptionBreakpoints(sharedEvaluator)),
@@ -78,6 +80,7 @@ public:
 
 private:
 
+    std::shared_ptr<Snapshots> m_sharedSnapshots;
     std::unique_ptr<BreakBreakpoint> m_uniqueBreakBreakpoint;
     std::unique_ptr<EntryBreakpoint> m_uniqueEntryBreakpoint;
     std::unique_ptr<ExceptionBreakpoints> m_uniqueExceptionBreakpoints;
@@ -88,6 +91,13 @@ private:
     std::mutex m_nextBreakpointIdMutex;
     uint32_t m_nextBreakpointId;
 
+    // Check that `id` could be used as trigger breakpoint id for dependent breakpoint.
+    bool IsTriggerBreakpoint(uint32_t id);
+    // Enable dependent breakpoints of `id` breakpoint. Return `true` in case `id` is trigger breakpoint.
+    bool TriggerBreakpoints(uint32_t id);
+    // Dependent breakpoints of removed trigger breakpoint become regular breakpoints (enabled, if still wait for trigger).
+    void ResetRemovedTriggers();
+
 };
 
 } // namespace netcoredbg
@@ -21,6 +21,8 @@ void FuncBreakpoints::ManagedFuncBreakpoint::ToBreakpoint(Breakpoint &breakpoint
     breakpoint.module = this->module;
     breakpoint.funcname = this->name;
     breakpoint.params = this->params;
+    breakpoint.snapshot = this->snapshot;
+    breakpoint.commands = this->commands;
 }
 
 void FuncBreakpoints::DeleteAll()
@@ -86,6 +88,7 @@ HRESULT FuncBreakpoints::CheckBreakpointHit(ICorDebugThread *pThread, ICorDebugB
         for (auto &funcBreakpoint : fbp.funcBreakpoints)
         {
             if (FAILED(BreakpointUtils::IsSameFunctionBreakpoint(pFunctionBreakpoint, funcBreakpoint.iCorFuncBreakpoint)) ||
+                FAILED(BreakpointUtils::IsEnableByThread(fbp.thread, pThread)) ||
                 FAILED(BreakpointUtils::IsEnableByCondition(fbp.condition, m_sharedVariables.get(), pThread)))
                 continue;
             
@@ -171,6 +174,16 @@ HRESULT FuncBreakpoints::SetFuncBreakpoints(bool haveProcess, const std::vector<
             fbp.name = fb.func;
             fbp.params = fb.params;
             fbp.condition = fb.condition;
+            fbp.snapshot = fb.snapshot;
+            fbp.commands = fb.commands;
+            fbp.thread = fb.thread;
+            fbp.triggerId = fb.triggerId;
+            fbp.enabled = !fb.triggerId; // dependent breakpoint enabled by trigger breakpoint hit only
+            fbp.triggerArmed = !!fb.triggerId;
+
+            std::shared_ptr<FuncNameMatcher> matcher = std::make_shared<FuncNameMatcher>();
+            if (SUCCEEDED(matcher->Init(fb.func)))
+                fbp.matcher = std::move(matcher);
 
             if (haveProcess)
                 ResolveFuncBreakpoint(fbp);
@@ -183,6 +196,21 @@ HRESULT FuncBreakpoints::SetFuncBreakpoints(bool haveProcess, const std::vector<
             ManagedFuncBreakpoint &fbp = b->second;
 
             fbp.condition = fb.condition;
+            fbp.snapshot = fb.snapshot;
+            fbp.commands = fb.commands;
+            fbp.thread = fb.thread;
+            if (fbp.triggerId != fb.triggerId)
+            {
+                // Breakpoint became dependent (or not dependent anymore), same as for new breakpoint.
+                fbp.triggerId = fb.triggerId;
+                fbp.enabled = !fb.triggerId;
+                fbp.triggerArmed = !!fb.triggerId;
+                for (auto &funcBreakpoint : fbp.funcBreakpoints)
+                {
+                    if (funcBreakpoint.iCorFuncBreakpoint)
+                        funcBreakpoint.iCorFuncBreakpoint->Activate(fbp.enabled ? TRUE : FALSE);
+                }
+            }
             fbp.ToBreakpoint(breakpoint);
         }
 
@@ -202,10 +230,12 @@ HRESULT FuncBreakpoints::UpdateBreakpointsOnHotReload(ICorDebugModule *pModule,
     {
         ManagedFuncBreakpoint &fbp = funcBreakpoints.second;
         bool initiallyResolved = !fbp.funcBreakpoints.empty();
+        if (!fbp.matcher)
+            continue;
 
         ResolvedFBP fbpResolved;
         IfFailRet(m_sharedModules->ResolveFuncBreakpointInModule(
-            pModule, fbp.module, fbp.module_checked, fbp.name,
+            pModule, fbp.module, fbp.module_checked, *fbp.matcher,
             [&](ICorDebugModule *pModule, mdMethodDef &methodToken) -> HRESULT
         {
             // Note, in case Hot Reload we ignore "resolved" status + setup breakpoints for new/changed methods only.
@@ -253,9 +283,10 @@ HRESULT FuncBreakpoints::AddFuncBreakpoint(ManagedFuncBreakpoint &fbp, ResolvedF
 
     for (auto &entry : fbpResolved)
     {
+        // Note, pattern could match a lot of methods, skipped method should not prevent breakpoints setup for others.
         IfFailRet(BreakpointUtils::SkipBreakpoint(entry.first, entry.second, m_justMyCode));
         if (Status == S_OK) // S_FALSE - don't skip breakpoint
-            return S_OK;
+            continue;
 
         ToRelease<ICorDebugFunction> pFunc;
         IfFailRet(entry.first->GetFunctionFromToken(entry.second, &pFunc));
@@ -264,7 +295,7 @@ HRESULT FuncBreakpoints::AddFuncBreakpoint(ManagedFuncBreakpoint &fbp, ResolvedF
 
         ULONG32 ilNextOffset = 0;
         if (FAILED(m_sharedModules->GetNextUserCodeILOffsetInMethod(entry.first, entry.second, currentVersion, 0, ilNextOffset)))
-            return S_OK;
+            continue;
 
         ToRelease<ICorDebugCode> pCode;
         IfFailRet(pFunc->GetILCode(&pCode));
@@ -283,9 +314,11 @@ HRESULT FuncBreakpoints::ResolveFuncBreakpoint(ManagedFuncBreakpoint &fbp)
 {
     HRESULT Status;
     ResolvedFBP fbpResolved;
+    if (!fbp.matcher)
+        return E_INVALIDARG;
 
     IfFailRet(m_sharedModules->ResolveFuncBreakpointInAny(
-        fbp.module, fbp.module_checked, fbp.name, 
+        fbp.module, fbp.module_checked, *fbp.matcher,
         [&](ICorDebugModule *pModule, mdMethodDef &methodToken) -> HRESULT
     {
         fbpResolved.emplace_back(std::make_pair(pModule, methodToken));
@@ -299,9 +332,11 @@ HRESULT FuncBreakpoints::ResolveFuncBreakpointInModule(ICorDebugModule *pModule,
 {
     HRESULT Status;
     ResolvedFBP fbpResolved;
+    if (!fbp.matcher)
+        return E_INVALIDARG;
 
     IfFailRet(m_sharedModules->ResolveFuncBreakpointInModule(
-        pModule, fbp.module, fbp.module_checked, fbp.name,
+        pModule, fbp.module, fbp.module_checked, *fbp.matcher,
         [&](ICorDebugModule *pModule, mdMethodDef &methodToken) -> HRESULT
     {
         fbpResolved.emplace_back(std::make_pair(pModule, methodToken));
@@ -327,6 +362,7 @@ HRESULT FuncBreakpoints::AllBreakpointsActivate(bool act)
             Status = FAILED(ret) ? ret : Status;
         }
         fbp.second.enabled = act;
+        fbp.second.triggerArmed = false; // explicit enable/disable, don't change it at trigger breakpoint hit
     }
 
     return Status;
@@ -351,12 +387,72 @@ HRESULT FuncBreakpoints::BreakpointActivate(uint32_t id, bool act)
             Status = FAILED(ret) ? ret : Status;
         }
         fbp.second.enabled = act;
+        fbp.second.triggerArmed = false; // explicit enable/disable, don't change it at trigger breakpoint hit
         return Status;
     }
 
     return E_FAIL;
 }
 
+bool FuncBreakpoints::HaveBreakpoint(uint32_t id)
+{
+    std::lock_guard<std::mutex> lock(m_breakpointsMutex);
+
+    for (const auto &fbp : m_funcBreakpoints)
+    {
+        if (fbp.second.id == id)
+            return true;
+    }
+
+    return false;
+}
+
+bool FuncBreakpoints::GetTriggeredBreakpoints(uint32_t triggerId, std::vector<uint32_t> &ids)
+{
+    std::lock_guard<std::mutex> lock(m_breakpointsMutex);
+
+    bool haveDependent = false;
+    for (auto &fbp : m_funcBreakpoints)
+    {
+        if (fbp.second.triggerId != triggerId)
+            continue;
+
+        haveDependent = true;
+        if (!fbp.second.triggerArmed)
+            continue;
+
+        fbp.second.triggerArmed = false;
+        ids.emplace_back(fbp.second.id);
+    }
+
+    return haveDependent;
+}
+
+void FuncBreakpoints::AddBreakpointsIds(std::unordered_set<uint32_t> &ids)
+{
+    std::lock_guard<std::mutex> lock(m_breakpointsMutex);
+
+    for (const auto &fbp : m_funcBreakpoints)
+    {
+        ids.insert(fbp.second.id);
+    }
+}
+
+void FuncBreakpoints::ResetRemovedTriggers(const std::unordered_set<uint32_t> &existingIds, std::vector<uint32_t> &ids)
+{
+    std::lock_guard<std::mutex> lock(m_breakpointsMutex);
+
+    for (auto &fbp : m_funcBreakpoints)
+    {
+        if (!fbp.second.triggerId || existingIds.find(fbp.second.triggerId) != existingIds.end())
+            continue;
+
+        fbp.second.triggerId = 0;
+        if (fbp.second.triggerArmed)
+            ids.emplace_back(fbp.second.id);
+    }
+}
+
 void FuncBreakpoints::AddAllBreakpointsInfo(std::vector<IDebugger::BreakpointInfo> &list)
 {
     std::lock_guard<std::mutex> lock(m_breakpointsMutex);
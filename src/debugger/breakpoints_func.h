@@ -14,6 +14,7 @@
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include "interfaces/idebugger.h"
 #include "utils/torelease.h"
 
@@ -22,6 +23,7 @@ namespace netcoredbg
 
 class Variables;
 class Modules;
+class FuncNameMatcher;
 
 class FuncBreakpoints
 {
@@ -41,6 +43,15 @@ public:
     HRESULT AllBreakpointsActivate(bool act);
     HRESULT BreakpointActivate(uint32_t id, bool act);
     void AddAllBreakpointsInfo(std::vector<IDebugger::BreakpointInfo> &list);
+    // Check that breakpoint with `id` exists, so, it could be used as trigger breakpoint.
+    bool HaveBreakpoint(uint32_t id);
+    // Get ids of dependent breakpoints, that should be enabled at `triggerId` breakpoint hit (breakpoints are disarmed,
+    // so, enabled only once). Return `true` in case `triggerId` breakpoint have dependent breakpoints.
+    bool GetTriggeredBreakpoints(uint32_t triggerId, std::vector<uint32_t> &ids);
+    void AddBreakpointsIds(std::unordered_set<uint32_t> &ids);
+    // Reset trigger of dependent breakpoints, that have removed trigger breakpoint (not in `existingIds`),
+    // get ids of breakpoints, that was armed and should be enabled now.
+    void ResetRemovedTriggers(const std::unordered_set<uint32_t> &existingIds, std::vector<uint32_t> &ids);
 
     // Important! Must provide succeeded return code:
     // S_OK - breakpoint hit
@@ -84,17 +95,23 @@ private:
         std::string module;
         bool module_checked; // in case "module" provided, we need mark that module was checked or not (since function could be not found by name)
         std::string name;
+        std::shared_ptr<const FuncNameMatcher> matcher; // null in case of invalid name
         std::string params;
         ULONG32 times;
         bool enabled;
         std::string condition;
+        SnapshotSettings snapshot;
+        ThreadFilter thread;
+        std::vector<std::string> commands;
+        uint32_t triggerId;
+        bool triggerArmed; // dependent breakpoint wait for trigger breakpoint hit (reset by any explicit enable/disable)
         std::list<internalFuncBreakpoint> funcBreakpoints;
 
-        bool IsResolved() const { return module_checked; }
+        bool IsResolved() const { return module_checked || !matcher; }
         bool IsVerified() const { return !funcBreakpoints.empty(); }
 
         ManagedFuncBreakpoint() :
-            id(0), module_checked(false), times(0), enabled(true)
+            id(0), module_checked(false), times(0), enabled(true), triggerId(0), triggerArmed(false)
         {}
 
         ~ManagedFuncBreakpoint()
@@ -21,6 +21,8 @@ void LineBreakpoints::ManagedLineBreakpoint::ToBreakpoint(Breakpoint &breakpoint
     breakpoint.line = this->linenum;
     breakpoint.endLine = this->endLine;
     breakpoint.hitCount = this->times;
+    breakpoint.snapshot = this->snapshot;
+    breakpoint.commands = this->commands;
 }
 
 void LineBreakpoints::DeleteAll()
@@ -74,6 +76,7 @@ HRESULT LineBreakpoints::CheckBreakpointHit(ICorDebugThread *pThread, ICorDebugB
         for (const auto &iCorFuncBreakpoint : b.iCorFuncBreakpoints)
         {
             if (FAILED(BreakpointUtils::IsSameFunctionBreakpoint(pFunctionBreakpoint, iCorFuncBreakpoint)) ||
+                FAILED(BreakpointUtils::IsEnableByThread(b.thread, pThread)) ||
                 FAILED(BreakpointUtils::IsEnableByCondition(b.condition, m_sharedVariables.get(), pThread)))
                 continue;
 
@@ -231,6 +234,9 @@ HRESULT LineBreakpoints::ManagedCallbackLoadModule(ICorDebugModule *pModule, std
             bp.linenum = initialBreakpoint.breakpoint.line;
             bp.endLine = initialBreakpoint.breakpoint.line;
             bp.condition = initialBreakpoint.breakpoint.condition;
+            bp.snapshot = initialBreakpoint.breakpoint.snapshot;
+            bp.commands = initialBreakpoint.breakpoint.commands;
+            bp.thread = initialBreakpoint.breakpoint.thread;
             unsigned resolved_fullname_index = 0;
             std::vector<ModulesSources::resolved_bp_t> resolvedPoints;
 
@@ -310,6 +316,9 @@ HRESULT LineBreakpoints::UpdateLineBreakpoint(bool haveProcess, int id, int line
             bp.linenum = initialBreakpoint.breakpoint.line;
             bp.endLine = initialBreakpoint.breakpoint.line;
             bp.condition = initialBreakpoint.breakpoint.condition;
+            bp.snapshot = initialBreakpoint.breakpoint.snapshot;
+            bp.commands = initialBreakpoint.breakpoint.commands;
+            bp.thread = initialBreakpoint.breakpoint.thread;
 
             unsigned resolved_fullname_index = 0;
             std::vector<ModulesSources::resolved_bp_t> resolvedPoints;
@@ -426,6 +435,8 @@ HRESULT LineBreakpoints::SetLineBreakpoints(bool haveProcess, const std::string&
             ManagedLineBreakpointMapping initialBreakpoint;
             initialBreakpoint.breakpoint = sb;
             initialBreakpoint.id = getId();
+            initialBreakpoint.enabled = !sb.triggerId; // dependent breakpoint enabled by trigger breakpoint hit only
+            initialBreakpoint.triggerArmed = !!sb.triggerId;
 
             // New breakpoint
             ManagedLineBreakpoint bp;
@@ -433,7 +444,11 @@ HRESULT LineBreakpoints::SetLineBreakpoints(bool haveProcess, const std::string&
             bp.module = initialBreakpoint.breakpoint.module;
             bp.linenum = line;
             bp.endLine = line;
+            bp.enabled = initialBreakpoint.enabled;
             bp.condition = initialBreakpoint.breakpoint.condition;
+            bp.snapshot = initialBreakpoint.breakpoint.snapshot;
+            bp.commands = initialBreakpoint.breakpoint.commands;
+            bp.thread = initialBreakpoint.breakpoint.thread;
             unsigned resolved_fullname_index = 0;
             std::vector<ModulesSources::resolved_bp_t> resolvedPoints;
 
@@ -464,6 +479,17 @@ HRESULT LineBreakpoints::SetLineBreakpoints(bool haveProcess, const std::string&
         {
             ManagedLineBreakpointMapping &initialBreakpoint = *b->second;
             initialBreakpoint.breakpoint.condition = sb.condition;
+            initialBreakpoint.breakpoint.snapshot = sb.snapshot;
+            initialBreakpoint.breakpoint.commands = sb.commands;
+            initialBreakpoint.breakpoint.thread = sb.thread;
+            // Breakpoint became dependent (or not dependent anymore), same as for new breakpoint.
+            const bool triggerChanged = initialBreakpoint.breakpoint.triggerId != sb.triggerId;
+            if (triggerChanged)
+            {
+                initialBreakpoint.breakpoint.triggerId = sb.triggerId;
+                initialBreakpoint.enabled = !sb.triggerId;
+                initialBreakpoint.triggerArmed = !!sb.triggerId;
+            }
 
             if (initialBreakpoint.resolved_linenum)
             {
@@ -482,6 +508,14 @@ HRESULT LineBreakpoints::SetLineBreakpoints(bool haveProcess, const std::string&
 
                     // Existing breakpoint
                     bp.condition = initialBreakpoint.breakpoint.condition;
+                    bp.snapshot = initialBreakpoint.breakpoint.snapshot;
+                    bp.commands = initialBreakpoint.breakpoint.commands;
+                    bp.thread = initialBreakpoint.breakpoint.thread;
+                    if (triggerChanged)
+                    {
+                        bp.enabled = initialBreakpoint.enabled;
+                        EnableOneICorBreakpointForLine(bList_it->second);
+                    }
                     std::string resolved_fullname;
                     m_sharedModules->GetSourceFullPathByIndex(initialBreakpoint.resolved_fullname_index, resolved_fullname);
                     bp.ToBreakpoint(breakpoint, resolved_fullname);
@@ -496,7 +530,11 @@ HRESULT LineBreakpoints::SetLineBreakpoints(bool haveProcess, const std::string&
                 bp.module = initialBreakpoint.breakpoint.module;
                 bp.linenum = line;
                 bp.endLine = line;
+                bp.enabled = initialBreakpoint.enabled;
                 bp.condition = initialBreakpoint.breakpoint.condition;
+                bp.snapshot = initialBreakpoint.breakpoint.snapshot;
+                bp.commands = initialBreakpoint.breakpoint.commands;
+                bp.thread = initialBreakpoint.breakpoint.thread;
                 bp.ToBreakpoint(breakpoint, filename);
                 if (!haveProcess)
                     breakpoint.message = "The breakpoint is pending and will be resolved when debugging starts.";
@@ -559,6 +597,9 @@ HRESULT LineBreakpoints::UpdateBreakpointsOnHotReload(ICorDebugModule *pModule,
             bp.linenum = initialBreakpoint.breakpoint.line;
             bp.endLine = initialBreakpoint.breakpoint.line;
             bp.condition = initialBreakpoint.breakpoint.condition;
+            bp.snapshot = initialBreakpoint.breakpoint.snapshot;
+            bp.commands = initialBreakpoint.breakpoint.commands;
+            bp.thread = initialBreakpoint.breakpoint.thread;
             unsigned resolved_fullname_index = 0;
             Breakpoint breakpoint;
             std::vector<ModulesSources::resolved_bp_t> resolvedPoints;
@@ -620,6 +661,7 @@ HRESULT LineBreakpoints::AllBreakpointsActivate(bool act)
         for (auto &bp: file_bps.second)
         {
             bp.enabled = act;
+            bp.triggerArmed = false; // explicit enable/disable, don't change it at trigger breakpoint hit
         }
     }
 
@@ -662,6 +704,7 @@ HRESULT LineBreakpoints::BreakpointActivate(uint32_t id, bool act)
                     continue;
 
                 bp.enabled = act;
+                bp.triggerArmed = false; // explicit enable/disable, don't change it at trigger breakpoint hit
                 if (!bp.resolved_linenum)
                     return S_OK; // no resolved breakpoint, we done with success
                 else
@@ -675,6 +718,77 @@ HRESULT LineBreakpoints::BreakpointActivate(uint32_t id, bool act)
     return activateAllMapped();
 }
 
+bool LineBreakpoints::HaveBreakpoint(uint32_t id)
+{
+    std::lock_guard<std::mutex> lock(m_breakpointsMutex);
+
+    for (const auto &file_bps : m_lineBreakpointMapping)
+    {
+        for (const auto &bp : file_bps.second)
+        {
+            if (bp.id == id)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+bool LineBreakpoints::GetTriggeredBreakpoints(uint32_t triggerId, std::vector<uint32_t> &ids)
+{
+    std::lock_guard<std::mutex> lock(m_breakpointsMutex);
+
+    bool haveDependent = false;
+    for (auto &file_bps : m_lineBreakpointMapping)
+    {
+        for (auto &bp : file_bps.second)
+        {
+            if (bp.breakpoint.triggerId != triggerId)
+                continue;
+
+            haveDependent = true;
+            if (!bp.triggerArmed)
+                continue;
+
+            bp.triggerArmed = false;
+            ids.emplace_back(bp.id);
+        }
+    }
+
+    return haveDependent;
+}
+
+void LineBreakpoints::AddBreakpointsIds(std::unordered_set<uint32_t> &ids)
+{
+    std::lock_guard<std::mutex> lock(m_breakpointsMutex);
+
+    for (const auto &file_bps : m_lineBreakpointMapping)
+    {
+        for (const auto &bp : file_bps.second)
+        {
+            ids.insert(bp.id);
+        }
+    }
+}
+
+void LineBreakpoints::ResetRemovedTriggers(const std::unordered_set<uint32_t> &existingIds, std::vector<uint32_t> &ids)
+{
+    std::lock_guard<std::mutex> lock(m_breakpointsMutex);
+
+    for (auto &file_bps : m_lineBreakpointMapping)
+    {
+        for (auto &bp : file_bps.second)
+        {
+            if (!bp.breakpoint.triggerId || existingIds.find(bp.breakpoint.triggerId) != existingIds.end())
+                continue;
+
+            bp.breakpoint.triggerId = 0;
+            if (bp.triggerArmed)
+                ids.emplace_back(bp.id);
+        }
+    }
+}
+
 void LineBreakpoints::AddAllBreakpointsInfo(std::vector<IDebugger::BreakpointInfo> &list)
 {
     std::lock_guard<std::mutex> lock(m_breakpointsMutex);
@@ -13,6 +13,7 @@
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include "interfaces/idebugger.h"
 #include "utils/torelease.h"
 
@@ -41,6 +42,15 @@ public:
     HRESULT AllBreakpointsActivate(bool act);
     HRESULT BreakpointActivate(uint32_t id, bool act);
     void AddAllBreakpointsInfo(std::vector<IDebugger::BreakpointInfo> &list);
+    // Check that breakpoint with `id` exists, so, it could be used as trigger breakpoint.
+    bool HaveBreakpoint(uint32_t id);
+    // Get ids of dependent breakpoints, that should be enabled at `triggerId` breakpoint hit (breakpoints are disarmed,
+    // so, enabled only once). Return `true` in case `triggerId` breakpoint have dependent breakpoints.
+    bool GetTriggeredBreakpoints(uint32_t triggerId, std::vector<uint32_t> &ids);
+    void AddBreakpointsIds(std::unordered_set<uint32_t> &ids);
+    // Reset trigger of dependent breakpoints, that have removed trigger breakpoint (not in `existingIds`),
+    // get ids of breakpoints, that was armed and should be enabled now.
+    void ResetRemovedTriggers(const std::unordered_set<uint32_t> &existingIds, std::vector<uint32_t> &ids);
 
     // Important! Must provide succeeded return code:
     // S_OK - breakpoint hit
@@ -66,6 +76,9 @@ public:
         bool enabled;
         ULONG32 times;
         std::string condition;
+        SnapshotSettings snapshot;
+        ThreadFilter thread;
+        std::vector<std::string> commands;
         // In case of code line in constructor, we could resolve multiple methods for breakpoints.
         // For example, `MyType obj = new MyType(1);` code will be added to all class constructors).
         std::vector<ToRelease<ICorDebugFunctionBreakpoint> > iCorFuncBreakpoints;
@@ -104,10 +117,11 @@ private:
         LineBreakpoint breakpoint;
         uint32_t id;
         bool enabled;
+        bool triggerArmed; // dependent breakpoint wait for trigger breakpoint hit (reset by any explicit enable/disable)
         unsigned resolved_fullname_index;
         int resolved_linenum; // if int is 0 - no resolved breakpoint available in m_lineResolvedBreakpoints
 
-        ManagedLineBreakpointMapping() : breakpoint("", 0, ""), id(0), enabled(true), resolved_fullname_index(0), resolved_linenum(0) {}
+        ManagedLineBreakpointMapping() : breakpoint("", 0, ""), id(0), enabled(true), triggerArmed(false), resolved_fullname_index(0), resolved_linenum(0) {}
         ~ManagedLineBreakpointMapping() = default;
     };
 
@@ -4,8 +4,11 @@
 
 #include "debugger/breakpointutils.h"
 #include "debugger/variables.h"
+#include "debugger/threads.h"
+#include "debugger/valueprint.h"
 #include "metadata/attributes.h"
 #include "utils/torelease.h"
+#include "utils/utility.h"
 
 namespace netcoredbg
 {
@@ -13,6 +16,54 @@ namespace netcoredbg
 namespace BreakpointUtils
 {
 
+namespace
+{
+
+// Read `_name` field of System.Threading.Thread object directly, we can't use func-eval (call property's getter)
+// at breakpoint callback before we know that this breakpoint should stop debuggee.
+HRESULT GetThreadName(ICorDebugThread *pThread, std::string &threadName)
+{
+    HRESULT Status;
+    ToRelease<ICorDebugValue> iCorThreadObject;
+    IfFailRet(pThread->GetObject(&iCorThreadObject));
+
+    BOOL isNull = TRUE;
+    ToRelease<ICorDebugValue> iCorValue;
+    IfFailRet(DereferenceAndUnboxValue(iCorThreadObject, &iCorValue, &isNull));
+    if (isNull)
+        return E_FAIL;
+
+    ToRelease<ICorDebugObjectValue> iCorObjectValue;
+    IfFailRet(iCorValue->QueryInterface(IID_ICorDebugObjectValue, (LPVOID*) &iCorObjectValue));
+    ToRelease<ICorDebugClass> iCorClass;
+    IfFailRet(iCorObjectValue->GetClass(&iCorClass));
+    mdTypeDef typeDef;
+    IfFailRet(iCorClass->GetToken(&typeDef));
+    ToRelease<ICorDebugModule> iCorModule;
+    IfFailRet(iCorClass->GetModule(&iCorModule));
+
+    ToRelease<IUnknown> iUnknown;
+    IfFailRet(iCorModule->GetMetaDataInterface(IID_IMetaDataImport, &iUnknown));
+    ToRelease<IMetaDataImport> iMD;
+    IfFailRet(iUnknown->QueryInterface(IID_IMetaDataImport, (LPVOID*) &iMD));
+
+    mdFieldDef fieldDef = mdFieldDefNil;
+    IfFailRet(iMD->FindField(typeDef, W("_name"), nullptr, 0, &fieldDef));
+
+    ToRelease<ICorDebugValue> iCorFieldValue;
+    IfFailRet(iCorObjectValue->GetFieldValue(iCorClass, fieldDef, &iCorFieldValue));
+    ToRelease<ICorDebugValue> iCorNameValue;
+    IfFailRet(DereferenceAndUnboxValue(iCorFieldValue, &iCorNameValue, &isNull));
+
+    threadName.clear();
+    if (!isNull)
+        IfFailRet(PrintStringValue(iCorNameValue, threadName));
+
+    return S_OK;
+}
+
+} // unnamed namespace
+
 HRESULT IsSameFunctionBreakpoint(ICorDebugFunctionBreakpoint *pBreakpoint1, ICorDebugFunctionBreakpoint *pBreakpoint2)
 {
     HRESULT Status;
@@ -93,6 +144,26 @@ HRESULT IsEnableByCondition(const std::string &condition, Variables *pVariables,
     return S_OK;
 }
 
+HRESULT IsEnableByThread(const ThreadFilter &filter, ICorDebugThread *pThread)
+{
+    if (!filter.IsEnabled())
+        return S_OK;
+
+    if (filter.threadId && getThreadId(pThread) != filter.threadId)
+        return E_FAIL;
+
+    if (!filter.namePattern.empty())
+    {
+        HRESULT Status;
+        std::string threadName;
+        IfFailRet(GetThreadName(pThread, threadName));
+        if (!Utility::MatchPattern(threadName, filter.namePattern))
+            return E_FAIL;
+    }
+
+    return S_OK;
+}
+
 HRESULT SkipBreakpoint(ICorDebugModule *pModule, mdMethodDef methodToken, bool justMyCode)
 {
     HRESULT Status;
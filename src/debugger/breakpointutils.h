@@ -8,6 +8,7 @@
 #include "cordebug.h"
 
 #include <string>
+#include "interfaces/types.h"
 
 namespace netcoredbg
 {
@@ -18,6 +19,7 @@ namespace BreakpointUtils
 {
     HRESULT IsSameFunctionBreakpoint(ICorDebugFunctionBreakpoint *pBreakpoint1, ICorDebugFunctionBreakpoint *pBreakpoint2);
     HRESULT IsEnableByCondition(const std::string &condition, Variables *pVariables, ICorDebugThread *pThread);
+    HRESULT IsEnableByThread(const ThreadFilter &filter, ICorDebugThread *pThread);
     HRESULT SkipBreakpoint(ICorDebugModule *pModule, mdMethodDef methodToken, bool justMyCode);
 }
 
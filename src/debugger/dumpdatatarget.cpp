@@ -0,0 +1,460 @@
+// Copyright (c) 2022 Samsung Electronics Co., LTD
+// Distributed under the MIT License.
+// See the LICENSE file in the project root for more information.
+
+#include "debugger/dumpdatatarget.h"
+
+#include <algorithm>
+#include <cstring>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <elf.h>
+#include <link.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/procfs.h>
+#include <sys/user.h>
+#endif // __linux__
+#include "utils/logger.h"
+
+namespace netcoredbg
+{
+
+DumpDataTarget::DumpDataTarget() :
+    m_refCount(0),
+    m_dumpData(nullptr),
+    m_dumpSize(0),
+    m_platform(CORDB_PLATFORM_POSIX_AMD64)
+{}
+
+DumpDataTarget::~DumpDataTarget()
+{
+    Close();
+}
+
+ULONG DumpDataTarget::GetRefCount()
+{
+    std::lock_guard<std::mutex> lock(m_refCountMutex);
+    return m_refCount;
+}
+
+#ifdef __linux__
+
+#if defined(_TARGET_ARM_)
+typedef struct user_regs DumpRegisters; // ARM32 Linux have `struct user_regs` instead of `user_regs_struct`
+#else
+typedef struct user_regs_struct DumpRegisters;
+#endif
+
+namespace
+{
+    size_t AlignNote(size_t size)
+    {
+        return (size + 3) & ~size_t(3);
+    }
+
+    // Convert registers stored in NT_PRSTATUS note into CoreCLR's context.
+    void ConvertRegisters(const DumpRegisters &regs, CONTEXT &context)
+    {
+        memset(&context, 0, sizeof(CONTEXT));
+#if defined(_TARGET_AMD64_)
+        context.ContextFlags = CONTEXT_CONTROL | CONTEXT_INTEGER | CONTEXT_SEGMENTS;
+        context.Rax = regs.rax;
+        context.Rbx = regs.rbx;
+        context.Rcx = regs.rcx;
+        context.Rdx = regs.rdx;
+        context.Rsi = regs.rsi;
+        context.Rdi = regs.rdi;
+        context.Rbp = regs.rbp;
+        context.Rsp = regs.rsp;
+        context.R8 = regs.r8;
+        context.R9 = regs.r9;
+        context.R10 = regs.r10;
+        context.R11 = regs.r11;
+        context.R12 = regs.r12;
+        context.R13 = regs.r13;
+        context.R14 = regs.r14;
+        context.R15 = regs.r15;
+        context.Rip = regs.rip;
+        context.EFlags = (DWORD)regs.eflags;
+        context.SegCs = (WORD)regs.cs;
+        context.SegSs = (WORD)regs.ss;
+        context.SegDs = (WORD)regs.ds;
+        context.SegEs = (WORD)regs.es;
+        context.SegFs = (WORD)regs.fs;
+        context.SegGs = (WORD)regs.gs;
+#elif defined(_TARGET_X86_)
+        context.ContextFlags = CONTEXT_CONTROL | CONTEXT_INTEGER | CONTEXT_SEGMENTS;
+        context.Eax = regs.eax;
+        context.Ebx = regs.ebx;
+        context.Ecx = regs.ecx;
+        context.Edx = regs.edx;
+        context.Esi = regs.esi;
+        context.Edi = regs.edi;
+        context.Ebp = regs.ebp;
+        context.Esp = regs.esp;
+        context.Eip = regs.eip;
+        context.EFlags = regs.eflags;
+        context.SegCs = regs.xcs;
+        context.SegSs = regs.xss;
+        context.SegDs = regs.xds;
+        context.SegEs = regs.xes;
+        context.SegFs = regs.xfs;
+        context.SegGs = regs.xgs;
+#elif defined(_TARGET_ARM_)
+        context.ContextFlags = CONTEXT_CONTROL | CONTEXT_INTEGER;
+        context.R0 = regs.uregs[0];
+        context.R1 = regs.uregs[1];
+        context.R2 = regs.uregs[2];
+        context.R3 = regs.uregs[3];
+        context.R4 = regs.uregs[4];
+        context.R5 = regs.uregs[5];
+        context.R6 = regs.uregs[6];
+        context.R7 = regs.uregs[7];
+        context.R8 = regs.uregs[8];
+        context.R9 = regs.uregs[9];
+        context.R10 = regs.uregs[10];
+        context.R11 = regs.uregs[11];
+        context.R12 = regs.uregs[12];
+        context.Sp = regs.uregs[13];
+        context.Lr = regs.uregs[14];
+        context.Pc = regs.uregs[15];
+        context.Cpsr = regs.uregs[16];
+#elif defined(_TARGET_ARM64_)
+        context.ContextFlags = CONTEXT_CONTROL | CONTEXT_INTEGER;
+        for (int i = 0; i < 29; i++)
+        {
+            context.X[i] = regs.regs[i];
+        }
+        context.Fp = regs.regs[29];
+        context.Lr = regs.regs[30];
+        context.Sp = regs.sp;
+        context.Pc = regs.pc;
+        context.Cpsr = (DWORD)regs.pstate;
+#else
+#error "Unsupported platform"
+#endif
+    }
+}
+
+HRESULT DumpDataTarget::Open(const std::string &dumpPath)
+{
+    LogFuncEntry();
+
+    Close();
+
+    int fd = open(dumpPath.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        LOGE("Can't open dump file %s: %s", dumpPath.c_str(), strerror(errno));
+        return E_INVALIDARG;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(ElfW(Ehdr)))
+    {
+        close(fd);
+        return E_INVALIDARG;
+    }
+
+    // Note, mapping with MAP_PRIVATE, so, dump file could be opened in parallel by other debugger instance.
+    void *data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // mapping holds its own reference to file
+    if (data == MAP_FAILED)
+    {
+        LOGE("Can't map dump file %s: %s", dumpPath.c_str(), strerror(errno));
+        return E_FAIL;
+    }
+    m_dumpData = static_cast<const BYTE*>(data);
+    m_dumpSize = (size_t)st.st_size;
+
+    ElfW(Ehdr) ehdr;
+    memcpy(&ehdr, m_dumpData, sizeof(ehdr));
+    if (memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 || ehdr.e_type != ET_CORE)
+    {
+        LOGE("%s is not ELF core file", dumpPath.c_str());
+        Close();
+        return E_INVALIDARG;
+    }
+
+    // Note, DAC and DBI libraries are native code for current architecture, so, only dumps of same architecture supported.
+    switch (ehdr.e_machine)
+    {
+#if defined(_TARGET_AMD64_)
+        case EM_X86_64: m_platform = CORDB_PLATFORM_POSIX_AMD64; break;
+#elif defined(_TARGET_X86_)
+        case EM_386: m_platform = CORDB_PLATFORM_POSIX_X86; break;
+#elif defined(_TARGET_ARM_)
+        case EM_ARM: m_platform = CORDB_PLATFORM_POSIX_ARM; break;
+#elif defined(_TARGET_ARM64_)
+        case EM_AARCH64: m_platform = CORDB_PLATFORM_POSIX_ARM64; break;
+#endif
+        default:
+            LOGE("Dump %s architecture (%d) is not supported", dumpPath.c_str(), (int)ehdr.e_machine);
+            Close();
+            return E_INVALIDARG;
+    }
+
+    if (ehdr.e_phentsize != sizeof(ElfW(Phdr)) ||
+        ehdr.e_phoff + (uint64_t)ehdr.e_phnum * sizeof(ElfW(Phdr)) > m_dumpSize)
+    {
+        Close();
+        return E_INVALIDARG;
+    }
+
+    HRESULT Status;
+    for (ElfW(Half) i = 0; i < ehdr.e_phnum; i++)
+    {
+        ElfW(Phdr) phdr;
+        memcpy(&phdr, m_dumpData + ehdr.e_phoff + i * sizeof(ElfW(Phdr)), sizeof(phdr));
+
+        // Segments could be truncated (for example, disk was full during dump creation), use only really stored data.
+        if (phdr.p_offset >= m_dumpSize)
+            continue;
+        uint64_t fileSize = std::min<uint64_t>(phdr.p_filesz, m_dumpSize - phdr.p_offset);
+
+        if (phdr.p_type == PT_LOAD && fileSize > 0)
+        {
+            m_segments.push_back(MemorySegment{phdr.p_vaddr, phdr.p_vaddr + fileSize, phdr.p_offset});
+        }
+        else if (phdr.p_type == PT_NOTE)
+        {
+            if (FAILED(Status = ParseNotes(m_dumpData + phdr.p_offset, (size_t)fileSize)))
+            {
+                Close();
+                return Status;
+            }
+        }
+    }
+
+    std::sort(m_segments.begin(), m_segments.end(), [](const MemorySegment &a, const MemorySegment &b)
+    {
+        return a.startAddr < b.startAddr;
+    });
+
+    if (m_segments.empty() || m_threads.empty())
+    {
+        LOGE("Dump %s don't have memory segments or threads", dumpPath.c_str());
+        Close();
+        return E_INVALIDARG;
+    }
+
+    return S_OK;
+}
+
+HRESULT DumpDataTarget::ParseNotes(const BYTE *notes, size_t notesSize)
+{
+    size_t offset = 0;
+    while (offset + sizeof(ElfW(Nhdr)) <= notesSize)
+    {
+        ElfW(Nhdr) nhdr;
+        memcpy(&nhdr, notes + offset, sizeof(nhdr));
+        offset += sizeof(nhdr) + AlignNote(nhdr.n_namesz);
+        if (offset + nhdr.n_descsz > notesSize)
+            return E_INVALIDARG;
+
+        const BYTE *desc = notes + offset;
+        offset += AlignNote(nhdr.n_descsz);
+
+        if (nhdr.n_type == NT_PRSTATUS && nhdr.n_descsz >= sizeof(struct elf_prstatus))
+        {
+            struct elf_prstatus prstatus;
+            memcpy(&prstatus, desc, sizeof(prstatus));
+
+            DumpRegisters regs;
+            static_assert(sizeof(regs) <= sizeof(prstatus.pr_reg), "Unexpected registers set size");
+            memcpy(&regs, &prstatus.pr_reg, sizeof(regs));
+
+            m_threads.emplace_back();
+            m_threads.back().threadId = (DWORD)prstatus.pr_pid;
+            ConvertRegisters(regs, m_threads.back().context);
+        }
+        else if (nhdr.n_type == NT_FILE && nhdr.n_descsz >= 2 * sizeof(unsigned long))
+        {
+            // NT_FILE layout: count, page size, `count` entries of {start, end, file offset}, `count` null-terminated paths.
+            unsigned long header[2];
+            memcpy(header, desc, sizeof(header));
+            const unsigned long count = header[0];
+            // Check count before multiplication, corrupted core could overflow entries size.
+            if (count > (nhdr.n_descsz - sizeof(header)) / (3 * sizeof(unsigned long)))
+                return E_INVALIDARG;
+            const size_t entriesSize = count * 3 * sizeof(unsigned long);
+
+            const char *path = reinterpret_cast<const char*>(desc + sizeof(header) + entriesSize);
+            const char *descEnd = reinterpret_cast<const char*>(desc + nhdr.n_descsz);
+            for (unsigned long i = 0; i < count && path < descEnd; i++)
+            {
+                unsigned long entry[3];
+                memcpy(entry, desc + sizeof(header) + i * sizeof(entry), sizeof(entry));
+
+                size_t pathLen = strnlen(path, descEnd - path);
+                m_mappedFiles.push_back(MappedFile{entry[0], entry[2], std::string(path, pathLen)});
+                path += pathLen + 1;
+            }
+        }
+    }
+
+    return S_OK;
+}
+
+void DumpDataTarget::Close()
+{
+    if (m_dumpData)
+        munmap(const_cast<BYTE*>(m_dumpData), m_dumpSize);
+
+    m_dumpData = nullptr;
+    m_dumpSize = 0;
+    m_segments.clear();
+    m_mappedFiles.clear();
+    m_threads.clear();
+}
+
+#else // __linux__
+
+HRESULT DumpDataTarget::Open(const std::string &dumpPath)
+{
+    LOGE("Dump debugging is not supported on this platform");
+    return E_NOTIMPL;
+}
+
+HRESULT DumpDataTarget::ParseNotes(const BYTE *notes, size_t notesSize)
+{
+    return E_NOTIMPL;
+}
+
+void DumpDataTarget::Close()
+{
+}
+
+#endif // __linux__
+
+HRESULT DumpDataTarget::FindModule(const std::string &fileName, CORDB_ADDRESS &baseAddress, std::string &fullPath)
+{
+    // Module could be mapped by several entries, first one (with zero file offset) is module's load address.
+    for (const auto &file : m_mappedFiles)
+    {
+        if (file.fileOffset != 0 || file.path.size() < fileName.size())
+            continue;
+
+        size_t pos = file.path.size() - fileName.size();
+        if (file.path.compare(pos, std::string::npos, fileName) != 0 || (pos > 0 && file.path[pos - 1] != '/'))
+            continue;
+
+        baseAddress = file.startAddr;
+        fullPath = file.path;
+        return S_OK;
+    }
+
+    return E_FAIL;
+}
+
+void DumpDataTarget::GetThreadIds(std::vector<DWORD> &threadIds)
+{
+    threadIds.reserve(m_threads.size());
+    for (const auto &thread : m_threads)
+    {
+        threadIds.push_back(thread.threadId);
+    }
+}
+
+// IUnknown
+
+HRESULT STDMETHODCALLTYPE DumpDataTarget::QueryInterface(REFIID riid, VOID** ppInterface)
+{
+    if (riid == IID_ICorDebugDataTarget)
+    {
+        *ppInterface = static_cast<ICorDebugDataTarget*>(this);
+    }
+    else if (riid == IID_IUnknown)
+    {
+        *ppInterface = static_cast<IUnknown*>(static_cast<ICorDebugDataTarget*>(this));
+    }
+    else
+    {
+        *ppInterface = NULL;
+        return E_NOINTERFACE;
+    }
+
+    this->AddRef();
+    return S_OK;
+}
+
+ULONG STDMETHODCALLTYPE DumpDataTarget::AddRef()
+{
+    std::lock_guard<std::mutex> lock(m_refCountMutex);
+    return ++m_refCount;
+}
+
+ULONG STDMETHODCALLTYPE DumpDataTarget::Release()
+{
+    std::lock_guard<std::mutex> lock(m_refCountMutex);
+
+    assert(m_refCount > 0);
+
+    // Note, we don't provide "delete" call for object itself for our fake "COM".
+    // External holder will care about this object during debugger lifetime.
+
+    return --m_refCount;
+}
+
+// ICorDebugDataTarget
+
+HRESULT STDMETHODCALLTYPE DumpDataTarget::GetPlatform(CorDebugPlatform *pTargetPlatform)
+{
+    if (pTargetPlatform == nullptr)
+        return E_INVALIDARG;
+
+    *pTargetPlatform = m_platform;
+    return S_OK;
+}
+
+HRESULT STDMETHODCALLTYPE DumpDataTarget::ReadVirtual(CORDB_ADDRESS address, BYTE *pBuffer, ULONG32 bytesRequested, ULONG32 *pBytesRead)
+{
+    if (pBuffer == nullptr || pBytesRead == nullptr)
+        return E_INVALIDARG;
+
+    *pBytesRead = 0;
+
+    // Find last segment with startAddr <= address, requested block could cross several adjacent segments.
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), address, [](CORDB_ADDRESS addr, const MemorySegment &segment)
+    {
+        return addr < segment.startAddr;
+    });
+    if (it == m_segments.begin())
+        return CORDBG_E_READVIRTUAL_FAILURE;
+    --it;
+
+    while (bytesRequested > 0 && it != m_segments.end() && it->startAddr <= address && address < it->endAddr)
+    {
+        ULONG32 size = (ULONG32)std::min<uint64_t>(bytesRequested, it->endAddr - address);
+        memcpy(pBuffer, m_dumpData + it->fileOffset + (address - it->startAddr), size);
+
+        pBuffer += size;
+        address += size;
+        bytesRequested -= size;
+        *pBytesRead += size;
+        ++it;
+    }
+
+    return *pBytesRead > 0 ? S_OK : CORDBG_E_READVIRTUAL_FAILURE;
+}
+
+HRESULT STDMETHODCALLTYPE DumpDataTarget::GetThreadContext(DWORD dwThreadId, ULONG32 contextFlags, ULONG32 contextSize, BYTE *pContext)
+{
+    if (pContext == nullptr || contextSize < sizeof(CONTEXT))
+        return E_INVALIDARG;
+
+    for (const auto &thread : m_threads)
+    {
+        if (thread.threadId != dwThreadId)
+            continue;
+
+        memcpy(pContext, &thread.context, sizeof(CONTEXT));
+        return S_OK;
+    }
+
+    return E_INVALIDARG;
+}
+
+} // namespace netcoredbg
@@ -0,0 +1,81 @@
+// Copyright (c) 2022 Samsung Electronics Co., LTD
+// Distributed under the MIT License.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "cor.h"
+#include "cordebug.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace netcoredbg
+{
+
+// Read-only data target for post-mortem debugging, provide debuggee memory and threads registers from
+// Linux ELF core file (for example, created by `createdump`). Dump file is mapped into memory, so, all
+// memory reads served by plain copy from mapped file without any syscalls.
+class DumpDataTarget final : public ICorDebugDataTarget
+{
+public:
+
+    DumpDataTarget();
+    ~DumpDataTarget();
+
+    HRESULT Open(const std::string &dumpPath);
+    // Find module (by file name) mapped into dumped process memory, provide load address and full path.
+    HRESULT FindModule(const std::string &fileName, CORDB_ADDRESS &baseAddress, std::string &fullPath);
+    void GetThreadIds(std::vector<DWORD> &threadIds);
+    ULONG GetRefCount();
+
+    // IUnknown
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, VOID** ppInterface) override;
+    ULONG STDMETHODCALLTYPE AddRef() override;
+    ULONG STDMETHODCALLTYPE Release() override;
+
+    // ICorDebugDataTarget
+
+    HRESULT STDMETHODCALLTYPE GetPlatform(CorDebugPlatform *pTargetPlatform) override;
+    HRESULT STDMETHODCALLTYPE ReadVirtual(CORDB_ADDRESS address, BYTE *pBuffer, ULONG32 bytesRequested, ULONG32 *pBytesRead) override;
+    HRESULT STDMETHODCALLTYPE GetThreadContext(DWORD dwThreadId, ULONG32 contextFlags, ULONG32 contextSize, BYTE *pContext) override;
+
+private:
+
+    struct MemorySegment
+    {
+        CORDB_ADDRESS startAddr;
+        CORDB_ADDRESS endAddr;   // startAddr + size of data stored in dump file
+        uint64_t fileOffset;
+    };
+
+    struct MappedFile
+    {
+        CORDB_ADDRESS startAddr;
+        uint64_t fileOffset;     // in pages
+        std::string path;
+    };
+
+    struct ThreadRegisters
+    {
+        DWORD threadId;
+        CONTEXT context;
+    };
+
+    std::mutex m_refCountMutex;
+    ULONG m_refCount;
+
+    const BYTE *m_dumpData;
+    size_t m_dumpSize;
+    CorDebugPlatform m_platform;
+    std::vector<MemorySegment> m_segments; // sorted by startAddr
+    std::vector<MappedFile> m_mappedFiles;
+    std::vector<ThreadRegisters> m_threads;
+
+    void Close();
+    HRESULT ParseNotes(const BYTE *notes, size_t notesSize);
+};
+
+} // namespace netcoredbg
@@ -8,6 +8,7 @@
 #include "debugger/evalwaiter.h"
 #include "debugger/evalutils.h"
 #include "utils/utf.h"
+#include "utils/filesystem.h"
 #include "metadata/modules.h"
 #include "metadata/typeprinter.h"
 #include "valueprint.h"
@@ -173,6 +174,93 @@ HRESULT EvalHelpers::FindMethodInModule(const std::string &moduleName, const WCH
     return S_OK;
 }
 
+// Get object instance properties values in one func-eval by debuggee side helper from startup hook assembly, since each
+// getter func-eval is a full process continue and callback round trip (see `ncdbGetPropertiesValues()` in ncdbhook.cs).
+// Note, startup hook assembly available only in case debugger injected it at launch (Hot Reload or properties helper
+// enabled), return error in all other cases, so caller must evaluate properties by regular getter calls.
+// [in] pThread - managed thread for evaluation;
+// [in] pObjectValue - reference value of object;
+// [in] properties - `<declaring type module MVID>:<declaring type token>:<getter token>` entries;
+// [out] results - value (or exception object) for each property, or nullptr in case property must be evaluated by regular getter call;
+// [in] evalFlags - evaluation flags.
+HRESULT EvalHelpers::GetPropertiesValues(
+    ICorDebugThread *pThread,
+    ICorDebugValue *pObjectValue,
+    const std::vector<std::string> &properties,
+    std::vector<ToRelease<ICorDebugValue>> &results,
+    int evalFlags)
+{
+#ifdef NCDB_DOTNET_STARTUP_HOOK
+    if (evalFlags & EVAL_NOFUNCEVAL)
+        return E_FAIL;
+
+    HRESULT Status;
+    // Value types can't be provided as `object` argument without boxing.
+    ToRelease<ICorDebugReferenceValue> iCorRefValue;
+    IfFailRet(pObjectValue->QueryInterface(IID_ICorDebugReferenceValue, (LPVOID*) &iCorRefValue));
+
+    // Find method first, no reason for string creation (eval) in case startup hook was not injected.
+    static const std::string assemblyName = GetBasename(NCDB_DOTNET_STARTUP_HOOK);
+    static const WCHAR className[] = W("StartupHook");
+    static const WCHAR methodName[] = W("ncdbGetPropertiesValues");
+    ToRelease<ICorDebugFunction> iCorFunc;
+    IfFailRet(FindMethodInModule(assemblyName, className, methodName, &iCorFunc));
+
+    std::string joinedProperties;
+    for (const auto &property : properties)
+    {
+        if (!joinedProperties.empty())
+            joinedProperties += ";";
+        joinedProperties += property;
+    }
+    ToRelease<ICorDebugValue> iCorPropertiesValue;
+    IfFailRet(CreateString(pThread, joinedProperties, &iCorPropertiesValue));
+
+    ToRelease<ICorDebugValue> iCorResultValue;
+    ICorDebugValue *ppArgsValue[] = {pObjectValue, iCorPropertiesValue};
+    IfFailRet(EvalFunction(pThread, iCorFunc, nullptr, 0, ppArgsValue, 2, &iCorResultValue, evalFlags));
+
+    BOOL isNull = TRUE;
+    ToRelease<ICorDebugValue> iCorArrayValue;
+    IfFailRet(DereferenceAndUnboxValue(iCorResultValue, &iCorArrayValue, &isNull));
+    if (isNull)
+        return E_FAIL;
+    ToRelease<ICorDebugArrayValue> iCorArray;
+    IfFailRet(iCorArrayValue->QueryInterface(IID_ICorDebugArrayValue, (LPVOID*) &iCorArray));
+    ULONG32 count = 0;
+    IfFailRet(iCorArray->GetCount(&count));
+    if (count != properties.size() * 2)
+        return E_FAIL;
+
+    auto GetNotNullElement = [&](ULONG32 position, ICorDebugValue **ppValue) -> bool
+    {
+        ToRelease<ICorDebugValue> iCorElement;
+        ToRelease<ICorDebugReferenceValue> iCorElementRef;
+        BOOL isNullElement = TRUE;
+        if (FAILED(iCorArray->GetElementAtPosition(position, &iCorElement)) ||
+            FAILED(iCorElement->QueryInterface(IID_ICorDebugReferenceValue, (LPVOID*) &iCorElementRef)) ||
+            FAILED(iCorElementRef->IsNull(&isNullElement)) || isNullElement)
+            return false;
+
+        *ppValue = iCorElement.Detach();
+        return true;
+    };
+
+    results.clear();
+    results.resize(properties.size());
+    for (ULONG32 i = 0; i < properties.size(); i++)
+    {
+        // Exception object have same meaning as eval result in case getter throws an exception during regular func-eval.
+        if (!GetNotNullElement(i * 2 + 1, results[i].GetRef()))
+            GetNotNullElement(i * 2, results[i].GetRef());
+    }
+
+    return S_OK;
+#else // NCDB_DOTNET_STARTUP_HOOK
+    return E_NOTIMPL;
+#endif // NCDB_DOTNET_STARTUP_HOOK
+}
+
 static bool TypeHaveStaticMembers(ICorDebugType *pType)
 {
     HRESULT Status;
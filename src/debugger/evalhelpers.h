@@ -9,6 +9,7 @@
 
 #include <string>
 #include <list>
+#include <vector>
 #include <mutex>
 #include <memory>
 #include "utils/torelease.h"
@@ -71,6 +72,13 @@ public:
 
     HRESULT FindMethodInModule(const std::string &moduleName, const WCHAR className[], const WCHAR methodName[], ICorDebugFunction **ppFunction);
 
+    HRESULT GetPropertiesValues(
+        ICorDebugThread *pThread,
+        ICorDebugValue *pObjectValue,
+        const std::vector<std::string> &properties,
+        std::vector<ToRelease<ICorDebugValue>> &results,
+        int evalFlags);
+
     void Cleanup();
 
 private:
@@ -666,8 +666,11 @@ static bool IsSynthesizedLocalName(WCHAR *mdName, ULONG nameLen)
            (nameLen > 4 && starts_with(mdName, W("CS$<")));
 }
 
+// Same as Evaluator::WalkMembersCallback, but also provide property getter token (mdMethodDefNil for other members).
+typedef std::function<HRESULT(ICorDebugType*,bool,const std::string&,Evaluator::GetValueCallback,Evaluator::SetterData*,mdMethodDef)> InternalWalkMembersCallback;
+
 static HRESULT InternalWalkMembers(EvalHelpers *pEvalHelpers, ICorDebugValue *pInputValue, ICorDebugThread *pThread, FrameLevel frameLevel,
-                                   ICorDebugType *pTypeCast, bool provideSetterData, Evaluator::WalkMembersCallback cb)
+                                   ICorDebugType *pTypeCast, bool provideSetterData, InternalWalkMembersCallback cb)
 {
     HRESULT Status = S_OK;
 
@@ -690,7 +693,7 @@ static HRESULT InternalWalkMembers(EvalHelpers *pEvalHelpers, ICorDebugValue *pI
             return S_OK;
         };
 
-        return cb(nullptr, false, "", getValue, nullptr);
+        return cb(nullptr, false, "", getValue, nullptr, mdMethodDefNil);
     }
 
     ToRelease<ICorDebugArrayValue> pArrayValue;
@@ -720,7 +723,7 @@ static HRESULT InternalWalkMembers(EvalHelpers *pEvalHelpers, ICorDebugValue *pI
                 return S_OK;
             };
 
-            IfFailRet(cb(nullptr, false, "[" + IndiciesToStr(ind, base) + "]", getValue, nullptr));
+            IfFailRet(cb(nullptr, false, "[" + IndiciesToStr(ind, base) + "]", getValue, nullptr, mdMethodDefNil));
             IncIndicies(ind, dims);
         }
 
@@ -819,7 +822,7 @@ static HRESULT InternalWalkMembers(EvalHelpers *pEvalHelpers, ICorDebugValue *pI
                 return S_OK;
             };
 
-            IfFailRet(cb(pType, is_static, name, getValue, nullptr));
+            IfFailRet(cb(pType, is_static, name, getValue, nullptr, mdMethodDefNil));
         }
         return S_OK;
     }));
@@ -913,11 +916,11 @@ static HRESULT InternalWalkMembers(EvalHelpers *pEvalHelpers, ICorDebugValue *pI
                     iCorFuncSetter.Free();
                 }
                 Evaluator::SetterData setterData(is_static ? nullptr : pInputValue, pType, iCorFuncSetter);
-                IfFailRet(cb(pType, is_static, name, getValue, &setterData));
+                IfFailRet(cb(pType, is_static, name, getValue, &setterData, mdGetter));
             }
             else
             {
-                IfFailRet(cb(pType, is_static, name, getValue, nullptr));
+                IfFailRet(cb(pType, is_static, name, getValue, nullptr, mdGetter));
             }
         }
         return S_OK;
@@ -951,7 +954,34 @@ HRESULT Evaluator::WalkMembers(
     bool provideSetterData,
     WalkMembersCallback cb)
 {
-    return InternalWalkMembers(m_sharedEvalHelpers.get(), pValue, pThread, frameLevel, nullptr, provideSetterData, cb);
+    return InternalWalkMembers(m_sharedEvalHelpers.get(), pValue, pThread, frameLevel, nullptr, provideSetterData, [&](
+        ICorDebugType *pType,
+        bool is_static,
+        const std::string &name,
+        GetValueCallback getValue,
+        SetterData *setterData,
+        mdMethodDef)
+    {
+        return cb(pType, is_static, name, getValue, setterData);
+    });
+}
+
+HRESULT Evaluator::WalkMembersWithGetters(
+    ICorDebugValue *pValue,
+    ICorDebugThread *pThread,
+    FrameLevel frameLevel,
+    WalkMembersGettersCallback cb)
+{
+    return InternalWalkMembers(m_sharedEvalHelpers.get(), pValue, pThread, frameLevel, nullptr, false, [&](
+        ICorDebugType *pType,
+        bool is_static,
+        const std::string &name,
+        GetValueCallback getValue,
+        SetterData *,
+        mdMethodDef getterToken)
+    {
+        return cb(pType, is_static, name, getValue, getterToken);
+    });
 }
 
 enum class GeneratedCodeKind
@@ -1230,21 +1260,8 @@ static HRESULT WalkGeneratedClassFields(IMetaDataImport *pMD, ICorDebugValue *pI
     mdTypeDef currentTypeDef;
     IfFailRet(GetClassAndTypeDefByValue(pValue, &pClass, currentTypeDef));
 
-    struct hoisted_local_scope_t
-    {
-        uint32_t startOffset;
-        uint32_t length;
-    };
-    struct hoisted_local_scope_t_deleter
-    {
-        void operator()(hoisted_local_scope_t *p) const
-        {
-            Interop::CoTaskMemFree(p);
-        }
-    };
-
-    int32_t hoistedLocalScopesCount = -1;
-    std::unique_ptr<hoisted_local_scope_t, hoisted_local_scope_t_deleter> hoistedLocalScopes;
+    bool hoistedLocalScopesLoaded = false;
+    std::vector<Interop::HoistedLocalScope> hoistedLocalScopes;
 
     IfFailRet(ForEachFields(pMD, currentTypeDef, [&](mdFieldDef fieldDef) -> HRESULT
     {
@@ -1278,23 +1295,21 @@ static HRESULT WalkGeneratedClassFields(IMetaDataImport *pMD, ICorDebugValue *pI
         }
         else if (generatedNameKind == GeneratedNameKind::HoistedLocalField)
         {
-            if (hoistedLocalScopesCount == -1)
+            if (!hoistedLocalScopesLoaded)
             {
-                PVOID data = nullptr;
-                if (SUCCEEDED(pModules->GetHoistedLocalScopes(pModule, methodDef, methodVersion, &data, hoistedLocalScopesCount)) && data)
-                    hoistedLocalScopes.reset((hoisted_local_scope_t*)data);
-                else
-                    hoistedLocalScopesCount = 0;
+                if (FAILED(pModules->GetHoistedLocalScopes(pModule, methodDef, methodVersion, hoistedLocalScopes)))
+                    hoistedLocalScopes.clear();
+                hoistedLocalScopesLoaded = true;
             }
 
             // Check, that hoisted local is in scope.
             // Note, in case we have any issue - ignore this check and show variable, since this is not fatal error.
             int32_t index;
-            if (hoistedLocalScopesCount > 0 &&
+            if (!hoistedLocalScopes.empty() &&
                 SUCCEEDED(TryParseSlotIndex(mdName, index)) &&
-                hoistedLocalScopesCount > index &&
-                (currentIlOffset < hoistedLocalScopes.get()[index].startOffset ||
-                 currentIlOffset >= hoistedLocalScopes.get()[index].startOffset + hoistedLocalScopes.get()[index].length))
+                index >= 0 && (int32_t)hoistedLocalScopes.size() > index &&
+                (currentIlOffset < hoistedLocalScopes[index].startOffset ||
+                 currentIlOffset >= hoistedLocalScopes[index].startOffset + hoistedLocalScopes[index].length))
                 return S_OK; // Return with success to continue walk.
 
             WSTRING wLocalName;
@@ -1527,7 +1542,8 @@ static HRESULT FollowFields(EvalHelpers *pEvalHelpers, ICorDebugThread *pThread,
             bool is_static,
             const std::string &memberName,
             Evaluator::GetValueCallback getValue,
-            Evaluator::SetterData *setterData)
+            Evaluator::SetterData *setterData,
+            mdMethodDef)
         {
             if (is_static && valueKind == Evaluator::ValueIsVariable)
                 return S_OK;
@@ -83,6 +83,7 @@ public:
 
     typedef std::function<HRESULT(ICorDebugValue**,int)> GetValueCallback;
     typedef std::function<HRESULT(ICorDebugType*,bool,const std::string&,GetValueCallback,SetterData*)> WalkMembersCallback;
+    typedef std::function<HRESULT(ICorDebugType*,bool,const std::string&,GetValueCallback,mdMethodDef)> WalkMembersGettersCallback;
     typedef std::function<HRESULT(const std::string&,GetValueCallback)> WalkStackVarsCallback;
     typedef std::function<HRESULT(ICorDebugFunction**)> GetFunctionCallback;
     typedef std::function<HRESULT(bool,const std::string&,ReturnElementType&,std::vector<ArgElementType>&,GetFunctionCallback)> WalkMethodsCallback;
@@ -120,6 +121,14 @@ public:
         bool provideSetterData,
         WalkMembersCallback cb);
 
+    // Same as WalkMembers(), but provide property getter token (mdMethodDefNil for fields and array elements) instead of
+    // setter data, so, properties could be evaluated by debuggee side helper (see EvalHelpers::GetPropertiesValues()).
+    HRESULT WalkMembersWithGetters(
+        ICorDebugValue *pValue,
+        ICorDebugThread *pThread,
+        FrameLevel frameLevel,
+        WalkMembersGettersCallback cb);
+
     HRESULT WalkStackVars(
         ICorDebugThread *pThread,
         FrameLevel frameLevel,
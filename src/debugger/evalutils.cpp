@@ -77,40 +77,29 @@ namespace EvalUtils
         return result;
     }
 
-    static mdTypeDef GetTypeTokenForName(IMetaDataImport *pMD, mdTypeDef tkEnclosingClass, const std::string &name)
+    // Search for shortest identifiers sequence, that is top level type name, and resolve nested classes for rest identifiers.
+    // In case pModule is null, search in all modules (see Modules::FindTypeByName()).
+    static HRESULT FindTypeByIdentifiers(Modules *pModules, ICorDebugModule *pModule, const std::vector<std::string> &identifiers,
+                                         int &nextIdentifier, ICorDebugModule **ppTypeModule, mdTypeDef &typeToken)
     {
-        mdTypeDef typeToken = mdTypeDefNil;
-        pMD->FindTypeDefByName(reinterpret_cast<LPCWSTR>(to_utf16(name).c_str()), tkEnclosingClass, &typeToken);
-        return typeToken;
-    }
-
-    static HRESULT FindTypeInModule(ICorDebugModule *pModule, const std::vector<std::string> &identifiers, int &nextIdentifier, mdTypeDef &typeToken)
-    {
-        HRESULT Status;
-
-        ToRelease<IUnknown> pMDUnknown;
-        ToRelease<IMetaDataImport> pMD;
-        IfFailRet(pModule->GetMetaDataInterface(IID_IMetaDataImport, &pMDUnknown));
-        IfFailRet(pMDUnknown->QueryInterface(IID_IMetaDataImport, (LPVOID*) &pMD));
-
+        ToRelease<ICorDebugModule> pTypeModule;
         std::string currentTypeName;
+        typeToken = mdTypeDefNil;
 
-        // Search for type in module
         for (int i = nextIdentifier; i < (int)identifiers.size(); i++)
         {
             std::string name;
             ParseGenericParams(identifiers[i], name);
             currentTypeName += (currentTypeName.empty() ? "" : ".") + name;
 
-            typeToken = GetTypeTokenForName(pMD, mdTypeDefNil, currentTypeName);
-            if (typeToken != mdTypeDefNil)
+            if (SUCCEEDED(pModules->FindTypeByName(currentTypeName, pModule, mdTypeDefNil, &pTypeModule, typeToken)))
             {
                 nextIdentifier = i + 1;
                 break;
             }
         }
 
-        if (typeToken == mdTypeDefNil) // type not found, continue search in next module
+        if (typeToken == mdTypeDefNil)
             return E_FAIL;
 
         // Resolve nested class
@@ -118,13 +107,15 @@ namespace EvalUtils
         {
             std::string name;
             ParseGenericParams(identifiers[j], name);
-            mdTypeDef classToken = GetTypeTokenForName(pMD, typeToken, name);
-            if (classToken == mdTypeDefNil)
+            mdTypeDef classToken = mdTypeDefNil;
+            if (FAILED(pModules->FindTypeByName(currentTypeName + "." + name, pTypeModule, typeToken, nullptr, classToken)))
                 break;
+            currentTypeName += "." + name;
             typeToken = classToken;
             nextIdentifier = j + 1;
         }
 
+        *ppTypeModule = pTypeModule.Detach();
         return S_OK;
     }
 
@@ -236,33 +227,9 @@ namespace EvalUtils
     {
         HRESULT Status;
 
-        if (pModule)
-            pModule->AddRef();
-        ToRelease<ICorDebugModule> pTypeModule(pModule);
-
+        ToRelease<ICorDebugModule> pTypeModule;
         mdTypeDef typeToken = mdTypeDefNil;
-
-        if (!pTypeModule)
-        {
-            pModules->ForEachModule([&](ICorDebugModule *pModule)->HRESULT {
-                if (typeToken != mdTypeDefNil) // already found
-                    return S_OK;
-
-                if (SUCCEEDED(FindTypeInModule(pModule, identifiers, nextIdentifier, typeToken)))
-                {
-                    pModule->AddRef();
-                    pTypeModule = pModule;
-                }
-                return S_OK;
-            });
-        }
-        else
-        {
-            FindTypeInModule(pTypeModule, identifiers, nextIdentifier, typeToken);
-        }
-
-        if (typeToken == mdTypeDefNil)
-            return E_FAIL;
+        IfFailRet(FindTypeByIdentifiers(pModules, pModule, identifiers, nextIdentifier, &pTypeModule, typeToken));
 
         if (ppType)
         {
@@ -10,6 +10,7 @@
 #include "debugger/evaluator.h"
 #include "debugger/evalhelpers.h"
 #include "metadata/modules.h"
+#include "utils/iosystem.h"
 #include "utils/torelease.h"
 
 namespace netcoredbg
@@ -126,6 +127,23 @@ HRESULT UpdateApplication(ICorDebugThread *pThread, Modules *pModules, Evaluator
     return S_OK;
 }
 
+// Startup hook thread wait for connection on local socket (path provided by debugger in environment variable at launch)
+// instead of 200 ms polling, any connection wake it up and `ncdbfunc()` with hot reload breakpoint will be called at once.
+HRESULT SignalStartupHook(const std::string &signalPath)
+{
+    if (signalPath.empty())
+        return E_INVALIDARG;
+
+    IOSystem::FileHandle signal = IOSystem::connect_socket(signalPath);
+    if (!signal)
+        return E_FAIL;
+
+    IOSystem::IOResult result = IOSystem::write(signal, "", 1);
+    IOSystem::close(signal);
+
+    return result.status == IOSystem::IOResult::Success ? S_OK : E_FAIL;
+}
+
 } // namespace HotReloadHelpers
 
 } // namespace netcoredbg
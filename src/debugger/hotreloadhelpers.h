@@ -23,6 +23,9 @@ namespace HotReloadHelpers
     HRESULT UpdateApplication(ICorDebugThread *pThread, Modules *pModules, Evaluator *pEvaluator, EvalHelpers *pEvalHelpers,
                               const std::string &updatedDLL, const std::unordered_set<mdTypeDef> &updatedTypeTokens);
 
+    // Wake up startup hook thread (waiting for signal on local socket), so, it will call `ncdbfunc()` without poll delay.
+    HRESULT SignalStartupHook(const std::string &signalPath);
+
 } // namespace HotReloadHelpers
 
 } // namespace netcoredbg
@@ -51,6 +51,21 @@ bool ManagedCallback::CallbacksWorkerBreakpoint(ICorDebugAppDomain *pAppDomain,
     if (S_FALSE != m_debugger.m_uniqueBreakpoints->ManagedCallbackBreakpoint(pThread, pBreakpoint, event.breakpoint, atEntry))
         return false;
 
+    // Breakpoint commands output emitted as one block, before stop event or instead of it (`continue` command).
+    if (!atEntry && !event.breakpoint.commands.empty())
+    {
+        bool autoContinue = false;
+        std::string output;
+        if (FAILED(m_debugger.RunBreakpointCommands(pThread, event.breakpoint, output, autoContinue)))
+            LOGE("Breakpoint %u commands execution failed", (unsigned)event.breakpoint.id);
+
+        if (!output.empty())
+            m_debugger.m_sharedProtocol->EmitOutputEvent(OutputConsole, output);
+
+        if (autoContinue)
+            return false;
+    }
+
     // Disable all steppers if we stop at breakpoint during step.
     m_debugger.m_uniqueSteppers->DisableAllSteppers(pAppDomain);
 
@@ -400,6 +415,7 @@ HRESULT ManagedCallback::Pause(ICorDebugProcess *pProcess, ThreadId lastStoppedT
 
     // Fatal error during stop, just fail Pause request and don't stop process.
     m_stopEventInProcess = false;
+    m_debugger.InvalidateStackTraceCache();
     IfFailRet(pProcess->Continue(0));
     return E_FAIL;
 }
@@ -645,7 +661,10 @@ HRESULT STDMETHODCALLTYPE ManagedCallback::LoadModule(ICorDebugAppDomain *pAppDo
 
     Module module;
     std::string outputText;
-    m_debugger.m_sharedModules->TryLoadModuleSymbols(pModule, module, m_debugger.IsJustMyCode(), m_debugger.IsHotReload(), outputText);
+    {
+        std::lock_guard<std::mutex> lock(m_debugger.m_justMyCodeMutex);
+        m_debugger.m_sharedModules->TryLoadModuleSymbols(pModule, module, m_debugger.IsJustMyCode(), m_debugger.IsHotReload(), outputText);
+    }
     if (!outputText.empty())
         m_debugger.m_sharedProtocol->EmitOutputEvent(OutputStdErr, outputText);
     m_debugger.m_sharedProtocol->EmitModuleEvent(ModuleEvent(ModuleNew, module));
@@ -672,6 +691,7 @@ HRESULT STDMETHODCALLTYPE ManagedCallback::LoadModule(ICorDebugAppDomain *pAppDo
 HRESULT STDMETHODCALLTYPE ManagedCallback::UnloadModule(ICorDebugAppDomain *pAppDomain, ICorDebugModule *pModule)
 {
     LogFuncEntry();
+    m_debugger.m_sharedModules->RemoveModuleTypes(pModule);
     return ContinueAppDomainWithCallbacksQueue(pAppDomain);
 }
 
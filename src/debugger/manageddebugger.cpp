@@ -14,6 +14,7 @@
 #include <vector>
 #include <map>
 #include <fstream>
+#include <cstdio>
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -25,6 +26,8 @@
 #include "debugger/evaluator.h"
 #include "debugger/evalwaiter.h"
 #include "debugger/variables.h"
+#include "debugger/snapshots.h"
+#include "debugger/dumpdatatarget.h"
 #include "debugger/breakpoint_break.h"
 #include "debugger/breakpoint_entry.h"
 #include "debugger/breakpoints_exception.h"
@@ -46,6 +49,7 @@
 #include "utils/logger.h"
 #include "debugger/waitpid.h"
 #include "utils/iosystem.h"
+#include "utils/filesystem.h"
 
 #include "palclr.h"
 
@@ -66,6 +70,10 @@ namespace
     const auto startupWaitTimeout = std::chrono::milliseconds(5000);
 
     const std::string envDOTNET_STARTUP_HOOKS = "DOTNET_STARTUP_HOOKS";
+    // Local socket path for startup hook signal (see HotReloadHelpers::SignalStartupHook()).
+    const std::string envNCDB_HOOK_SIGNAL = "NCDB_HOOK_SIGNAL";
+    // Enable Hot Reload related part of startup hook.
+    const std::string envNCDB_HOOK_HOT_RELOAD = "NCDB_HOOK_HOT_RELOAD";
 #ifdef FEATURE_PAL
     const char delimiterDOTNET_STARTUP_HOOKS = ':';
 #else  // FEATURE_PAL
@@ -155,6 +163,12 @@ void ManagedDebugger::SetLastStoppedThreadId(ThreadId threadId)
     m_uniqueBreakpoints->SetLastStoppedIlOffset(m_iCorProcess, m_lastStoppedThreadId);
 }
 
+void ManagedDebugger::InvalidateStackTraceCache()
+{
+    std::lock_guard<std::mutex> lock(m_stackTraceCacheMutex);
+    m_stackTraceCache.clear();
+}
+
 void ManagedDebugger::InvalidateLastStoppedThreadId()
 {
     SetLastStoppedThreadId(ThreadId::AllThreads);
@@ -180,12 +194,14 @@ ManagedDebugger::ManagedDebugger() :
     m_sharedEvalStackMachine(new EvalStackMachine),
     m_sharedEvaluator(new Evaluator(m_sharedModules, m_sharedEvalHelpers, m_sharedEvalStackMachine)),
     m_sharedVariables(new Variables(m_sharedEvalHelpers, m_sharedEvaluator, m_sharedEvalStackMachine)),
+    m_sharedSnapshots(new Snapshots(m_sharedModules, m_sharedEvaluator)),
     m_uniqueSteppers(new Steppers(m_sharedModules, m_sharedEvalHelpers)),
-    m_uniqueBreakpoints(new Breakpoints(m_sharedModules, m_sharedEvaluator, m_sharedEvalHelpers, m_sharedVariables)),
+    m_uniqueBreakpoints(new Breakpoints(m_sharedModules, m_sharedEvaluator, m_sharedEvalHelpers, m_sharedVariables, m_sharedSnapshots)),
     m_managedCallback(nullptr),
     m_justMyCode(true),
     m_stepFiltering(true),
     m_hotReload(false),
+    m_propertiesHelper(false),
     m_unregisterToken(nullptr),
     m_processId(0),
     m_ioredirect(
@@ -214,6 +230,7 @@ HRESULT ManagedDebugger::Initialize()
 HRESULT ManagedDebugger::RunIfReady()
 {
     FrameId::invalidate();
+    InvalidateStackTraceCache();
 
     if (m_startMethod == StartNone || !m_isConfigurationDone)
         return S_OK;
@@ -224,6 +241,8 @@ HRESULT ManagedDebugger::RunIfReady()
             return RunProcess(m_execPath, m_execArgs);
         case StartAttach:
             return AttachToProcess(m_processId);
+        case StartDump:
+            return OpenDumpFile(m_dumpPath);
         default:
             return E_FAIL;
     }
@@ -241,6 +260,15 @@ HRESULT ManagedDebugger::Attach(int pid)
     return RunIfReady();
 }
 
+HRESULT ManagedDebugger::OpenDump(const std::string &dumpPath)
+{
+    LogFuncEntry();
+
+    m_startMethod = StartDump;
+    m_dumpPath = dumpPath;
+    return RunIfReady();
+}
+
 HRESULT ManagedDebugger::Launch(const std::string &fileExec, const std::vector<std::string> &execArgs,
                                 const std::map<std::string, std::string> &env, const std::string &cwd, bool stopAtEntry)
 {
@@ -278,6 +306,7 @@ HRESULT ManagedDebugger::Disconnect(DisconnectAction action)
                     terminate = true;
                     break;
                 case StartAttach:
+                case StartDump:
                     terminate = false;
                     break;
                 default:
@@ -288,7 +317,7 @@ HRESULT ManagedDebugger::Disconnect(DisconnectAction action)
             terminate = true;
             break;
         case DisconnectDetach:
-            if (m_startMethod != StartAttach)
+            if (m_startMethod != StartAttach && m_startMethod != StartDump)
             {
                 LOGE("Can't detach debugger form child process.\n");
                 return E_INVALIDARG;
@@ -320,6 +349,12 @@ HRESULT ManagedDebugger::StepCommand(ThreadId threadId, StepType stepType)
     HRESULT Status;
     IfFailRet(CheckDebugProcess(m_iCorProcess, m_processAttachedMutex, m_processAttachedState));
 
+    if (m_dumpDataTarget)
+    {
+        LOGE("Can't 'Step' in post-mortem debugging mode.");
+        return E_NOTIMPL;
+    }
+
     if (m_sharedEvalWaiter->IsEvalRunning())
     {
         // Important! Abort all evals before 'Step' in protocol, during eval we have inconsistent thread state.
@@ -339,6 +374,7 @@ HRESULT ManagedDebugger::StepCommand(ThreadId threadId, StepType stepType)
 
     m_sharedVariables->Clear(); // Important, must be sync with MIProtocol m_vars.clear()
     FrameId::invalidate(); // Clear all created during break frames.
+    InvalidateStackTraceCache();
     m_sharedProtocol->EmitContinuedEvent(threadId); // VSCode protocol need thread ID.
 
     // Note, process continue must be after event emitted, since we could get new stop event from queue here.
@@ -356,6 +392,12 @@ HRESULT ManagedDebugger::Continue(ThreadId threadId)
     HRESULT Status;
     IfFailRet(CheckDebugProcess(m_iCorProcess, m_processAttachedMutex, m_processAttachedState));
 
+    if (m_dumpDataTarget)
+    {
+        LOGE("Can't 'Continue' in post-mortem debugging mode.");
+        return E_NOTIMPL;
+    }
+
     if (m_sharedEvalWaiter->IsEvalRunning())
     {
         // Important! Abort all evals before 'Continue' in protocol, during eval we have inconsistent thread state.
@@ -371,6 +413,7 @@ HRESULT ManagedDebugger::Continue(ThreadId threadId)
 
     m_sharedVariables->Clear(); // Important, must be sync with MIProtocol m_vars.clear()
     FrameId::invalidate(); // Clear all created during break frames.
+    InvalidateStackTraceCache();
     m_sharedProtocol->EmitContinuedEvent(threadId); // VSCode protocol need thread ID.
 
     // Note, process continue must be after event emitted, since we could get new stop event from queue here.
@@ -388,6 +431,9 @@ HRESULT ManagedDebugger::Pause(ThreadId lastStoppedThread)
     HRESULT Status;
     IfFailRet(CheckDebugProcess(m_iCorProcess, m_processAttachedMutex, m_processAttachedState));
 
+    if (m_dumpDataTarget)
+        return S_OK; // Dump's process is always "stopped".
+
     return m_managedCallback->Pause(m_iCorProcess, lastStoppedThread);
 }
 
@@ -581,7 +627,8 @@ static bool IsDirExists(const char* const path)
     return true;
 }
 
-static void PrepareSystemEnvironmentArg(const std::map<std::string, std::string> &env, std::vector<char> &outEnv, bool hotReload)
+static void PrepareSystemEnvironmentArg(const std::map<std::string, std::string> &env, std::vector<char> &outEnv, bool hotReload,
+                                        const std::string &hookSignalPath, bool propertiesHelper)
 {
     // We need to append the environ values with keeping the current process environment block.
     // It works equal for any platrorms in coreclr CreateProcessW(), but not critical for Linux.
@@ -599,7 +646,9 @@ static void PrepareSystemEnvironmentArg(const std::map<std::string, std::string>
             envMap[pair.first] = pair.second;
         }
 #ifdef NCDB_DOTNET_STARTUP_HOOK
-        if (hotReload)
+        // Startup hook also provide debuggee side helpers (see EvalHelpers::GetPropertiesValues()), so, it is injected
+        // in case Hot Reload or properties helper enabled, but Hot Reload related part is enabled by environment variable only.
+        if (hotReload || propertiesHelper)
         {
             auto find = envMap.find(envDOTNET_STARTUP_HOOKS);
             if (find != envMap.end())
@@ -607,8 +656,17 @@ static void PrepareSystemEnvironmentArg(const std::map<std::string, std::string>
             else
                 envMap[envDOTNET_STARTUP_HOOKS] = NCDB_DOTNET_STARTUP_HOOK;
         }
+
+        if (hotReload)
+        {
+            envMap[envNCDB_HOOK_HOT_RELOAD] = "1";
+            if (!hookSignalPath.empty())
+                envMap[envNCDB_HOOK_SIGNAL] = hookSignalPath;
+        }
 #else
         (void)hotReload; // suppress warning about unused param
+        (void)hookSignalPath;
+        (void)propertiesHelper;
 #endif // NCDB_DOTNET_STARTUP_HOOK
         for (const auto &pair : envMap)
         {
@@ -650,8 +708,17 @@ HRESULT ManagedDebugger::RunProcess(const std::string& fileExec, const std::vect
 
     HANDLE resumeHandle = 0; // Fake thread handle for the process resume
 
+#if defined(NCDB_DOTNET_STARTUP_HOOK) && defined(FEATURE_PAL)
+    if (m_hotReload)
+    {
+        static unsigned launchCount = 0;
+        m_hotReloadSignalPath = std::string(GetTempDir()) + "/netcoredbg-hook-" + std::to_string(GetCurrentProcessId()) +
+                                "-" + std::to_string(launchCount++) + ".sock";
+    }
+#endif // NCDB_DOTNET_STARTUP_HOOK && FEATURE_PAL
+
     std::vector<char> outEnv;
-    PrepareSystemEnvironmentArg(m_env, outEnv, m_hotReload);
+    PrepareSystemEnvironmentArg(m_env, outEnv, m_hotReload, m_hotReloadSignalPath, m_propertiesHelper);
 
     // cwd in launch.json set working directory for debugger https://code.visualstudio.com/docs/python/debugging#_cwd
     if (!m_cwd.empty())
@@ -718,6 +785,13 @@ HRESULT ManagedDebugger::DetachFromProcess()
         if (!m_iCorProcess)
             return E_FAIL;
 
+        if (m_dumpDataTarget)
+        {
+            // Post-mortem debugging, nothing to detach from, dump related objects will be released by Cleanup().
+            m_processAttachedState = ProcessAttachedState::Unattached;
+            break;
+        }
+
         BOOL procRunning = FALSE;
         if (SUCCEEDED(m_iCorProcess->IsRunning(&procRunning)) && procRunning == TRUE)
             m_iCorProcess->Stop(0);
@@ -746,6 +820,13 @@ HRESULT ManagedDebugger::TerminateProcess()
         if (!m_iCorProcess)
             return E_FAIL;
 
+        if (m_dumpDataTarget)
+        {
+            // Post-mortem debugging, nothing to terminate, dump related objects will be released by Cleanup().
+            m_processAttachedState = ProcessAttachedState::Unattached;
+            break;
+        }
+
         BOOL procRunning = FALSE;
         if (SUCCEEDED(m_iCorProcess->IsRunning(&procRunning)) && procRunning == TRUE)
             m_iCorProcess->Stop(0);
@@ -769,14 +850,23 @@ HRESULT ManagedDebugger::TerminateProcess()
 
 void ManagedDebugger::Cleanup()
 {
+    if (!m_hotReloadSignalPath.empty())
+    {
+        // Socket file created by startup hook, but debuggee can't remove it at exit in all cases.
+        std::remove(m_hotReloadSignalPath.c_str());
+        m_hotReloadSignalPath.clear();
+    }
+
     m_sharedModules->CleanupAllModules();
     m_sharedEvalHelpers->Cleanup();
     m_sharedVariables->Clear(); // Important, must be sync with MIProtocol m_vars.clear()
+    InvalidateStackTraceCache();
     m_sharedProtocol->Cleanup();
 
     std::lock_guard<Utility::RWLock::Writer> guardProcessRWLock(m_debugProcessRWLock.writer);
 
     assert((m_iCorProcess && m_iCorDebug && m_managedCallback) ||
+           (m_iCorProcess && m_dumpDataTarget && !m_iCorDebug && !m_managedCallback) ||
            (!m_iCorProcess && !m_iCorDebug && !m_managedCallback));
 
     if (!m_iCorProcess)
@@ -784,6 +874,16 @@ void ManagedDebugger::Cleanup()
 
     m_iCorProcess.Free();
 
+    if (m_dumpDataTarget)
+    {
+        if (m_dumpDataTarget->GetRefCount() > 0)
+        {
+            LOGW("DumpDataTarget was not properly released by ICorDebug");
+        }
+        m_dumpDataTarget.reset(nullptr);
+        return;
+    }
+
     m_iCorDebug->Terminate();
     m_iCorDebug.Free();
 
@@ -827,6 +927,157 @@ HRESULT ManagedDebugger::AttachToProcess(DWORD pid)
     return S_OK;
 }
 
+// Based on CLR_DEBUGGING_VERSION and OpenVirtualProcessImpl2() from coreclr/src/debug/di/process.cpp
+struct DbiDebuggingVersion
+{
+    WORD wStructVersion;
+    WORD wMajor;
+    WORD wMinor;
+    WORD wBuild;
+    WORD wRevision;
+};
+
+typedef HRESULT (*OpenVirtualProcessImpl2Ptr)(ULONG64 clrInstanceId, IUnknown *pDataTarget, LPCWSTR pDacModulePath,
+                                               DbiDebuggingVersion *pMaxDebuggerSupportedVersion, REFIID riid,
+                                               IUnknown **ppInstance, DWORD *pFlagsOut);
+
+HRESULT ManagedDebugger::OpenDumpFile(const std::string &dumpPath)
+{
+    HRESULT Status;
+
+    IfFailRet(CheckNoProcess());
+
+    std::unique_ptr<DumpDataTarget> dumpDataTarget(new DumpDataTarget);
+    IfFailRet(dumpDataTarget->Open(dumpPath));
+
+    // Runtime with same version as in dumped process must be installed at same path, since we need DBI and DAC libraries
+    // that match dumped runtime (as alternative, runtime could be copied from dumped system).
+    CORDB_ADDRESS clrBaseAddress = 0;
+    if (FAILED(dumpDataTarget->FindModule("libcoreclr.so", clrBaseAddress, m_clrPath)))
+    {
+        LOGE("Unable to find libcoreclr.so in dump %s", dumpPath.c_str());
+        return E_INVALIDARG;
+    }
+    std::string clrDir = m_clrPath.substr(0, m_clrPath.rfind(DIRECTORY_SEPARATOR_STR_A) + 1);
+
+    // Note, DBI library is not unloaded (pinned), since it could be used again for next dump.
+    DLHandle dbiModule = DLOpen(clrDir + "libmscordbi.so");
+    if (!dbiModule)
+    {
+        LOGE("Unable to load %slibmscordbi.so", clrDir.c_str());
+        return E_FAIL;
+    }
+    OpenVirtualProcessImpl2Ptr openVirtualProcess = (OpenVirtualProcessImpl2Ptr)DLSym(dbiModule, "OpenVirtualProcessImpl2");
+    if (!openVirtualProcess)
+        return E_FAIL;
+
+    try
+    {
+        Interop::Init(m_clrPath);
+    }
+    catch (const std::exception &e)
+    {
+        LOGE("%s", e.what());
+        return E_FAIL;
+    }
+
+    DbiDebuggingVersion maxDebuggerSupportedVersion = {0, 4, 0, 0, 0}; // CorDebugVersion_4_0
+    DWORD flags = 0;
+    ToRelease<IUnknown> pProcessUnknown;
+    IfFailRet(openVirtualProcess(clrBaseAddress, dumpDataTarget.get(), reinterpret_cast<LPCWSTR>(to_utf16(clrDir + "libmscordaccore.so").c_str()),
+                                 &maxDebuggerSupportedVersion, IID_ICorDebugProcess, &pProcessUnknown, &flags));
+    ToRelease<ICorDebugProcess> iCorProcess;
+    IfFailRet(pProcessUnknown->QueryInterface(IID_ICorDebugProcess, (void **)&iCorProcess));
+
+    // No managed callbacks for dump, all modules and threads should be enumerated directly.
+    ToRelease<ICorDebugAppDomainEnum> pAppDomainEnum;
+    IfFailRet(iCorProcess->EnumerateAppDomains(&pAppDomainEnum));
+    ICorDebugAppDomain *pAppDomainRaw;
+    ULONG fetched = 0;
+    while (SUCCEEDED(pAppDomainEnum->Next(1, &pAppDomainRaw, &fetched)) && fetched == 1)
+    {
+        ToRelease<ICorDebugAppDomain> pAppDomain(pAppDomainRaw);
+        ToRelease<ICorDebugAssemblyEnum> pAssemblyEnum;
+        if (FAILED(pAppDomain->EnumerateAssemblies(&pAssemblyEnum)))
+            continue;
+
+        ICorDebugAssembly *pAssemblyRaw;
+        while (SUCCEEDED(pAssemblyEnum->Next(1, &pAssemblyRaw, &fetched)) && fetched == 1)
+        {
+            ToRelease<ICorDebugAssembly> pAssembly(pAssemblyRaw);
+            ToRelease<ICorDebugModuleEnum> pModuleEnum;
+            if (FAILED(pAssembly->EnumerateModules(&pModuleEnum)))
+                continue;
+
+            ICorDebugModule *pModuleRaw;
+            while (SUCCEEDED(pModuleEnum->Next(1, &pModuleRaw, &fetched)) && fetched == 1)
+            {
+                ToRelease<ICorDebugModule> pModule(pModuleRaw);
+
+                Module module;
+                std::string outputText;
+                m_sharedModules->TryLoadModuleSymbols(pModule, module, IsJustMyCode(), false, outputText);
+                if (!outputText.empty())
+                    m_sharedProtocol->EmitOutputEvent(OutputStdErr, outputText);
+                m_sharedProtocol->EmitModuleEvent(ModuleEvent(ModuleNew, module));
+
+                if (module.name == "System.Private.CoreLib.dll")
+                    m_sharedEvalStackMachine->FindPredefinedTypes(pModule);
+            }
+        }
+    }
+
+    ToRelease<ICorDebugThreadEnum> pThreadEnum;
+    IfFailRet(iCorProcess->EnumerateThreads(&pThreadEnum));
+    ICorDebugThread *pThreadRaw;
+    while (SUCCEEDED(pThreadEnum->Next(1, &pThreadRaw, &fetched)) && fetched == 1)
+    {
+        ToRelease<ICorDebugThread> pThread(pThreadRaw);
+        m_sharedThreads->Add(getThreadId(pThread));
+    }
+
+    std::unique_lock<Utility::RWLock::Writer> lockProcessRWLock(m_debugProcessRWLock.writer);
+
+    m_iCorProcess = iCorProcess.Detach();
+    m_dumpDataTarget = std::move(dumpDataTarget);
+
+    lockProcessRWLock.unlock();
+
+    NotifyProcessCreated();
+
+    // Dumped process is "stopped" from the beginning, provide stop event for first managed thread with user code,
+    // as we do for `Pause()`, protocol should know thread and frame for further stack and variables requests.
+    std::vector<ThreadId> threadIds;
+    m_sharedThreads->GetThreadIds(threadIds);
+    for (const auto &threadId : threadIds)
+    {
+        ToRelease<ICorDebugThread> pThread;
+        ToRelease<ICorDebugFrame> pFrame;
+        StackFrame stackFrame;
+        if (FAILED(m_iCorProcess->GetThread(int(threadId), &pThread)) ||
+            FAILED(pThread->GetActiveFrame(&pFrame)) || pFrame == nullptr ||
+            FAILED(GetFrameLocation(pFrame, threadId, FrameLevel(0), stackFrame)) ||
+            stackFrame.source.IsNull())
+        {
+            continue;
+        }
+
+        SetLastStoppedThreadId(threadId);
+        StoppedEvent event(StopPause, threadId);
+        event.frame = stackFrame;
+        m_sharedProtocol->EmitStoppedEvent(event);
+        return S_OK;
+    }
+
+    if (!threadIds.empty())
+    {
+        SetLastStoppedThreadId(threadIds.front());
+        m_sharedProtocol->EmitStoppedEvent(StoppedEvent(StopPause, threadIds.front()));
+    }
+
+    return S_OK;
+}
+
 HRESULT ManagedDebugger::GetExceptionInfo(ThreadId threadId, ExceptionInfo &exceptionInfo)
 {
     LogFuncEntry();
@@ -974,8 +1225,12 @@ HRESULT ManagedDebugger::GetFrameLocation(ICorDebugFrame *pFrame, ThreadId threa
     return InternalGetFrameLocation(pFrame, m_sharedModules.get(), m_hotReload, threadId, level, stackFrame, false);
 }
 
-static HRESULT InternalGetStackTrace(Modules *pModules, bool hotReload, ICorDebugThread *pThread, FrameLevel startFrame,
-                                     unsigned maxFrames, std::vector<StackFrame> &stackFrames, int &totalFrames, bool hotReloadAwareCaller)
+typedef std::function<HRESULT(StackFrame &stackFrame)> WalkStackTraceCallback;
+
+// Frames in [startFrame, startFrame + maxFrames) range are converted and passed to callback during unwind,
+// all other frames are counted only. Callback could stop unwind by E_ABORT (totalFrames is not valid in this case).
+static HRESULT InternalWalkStackTrace(Modules *pModules, bool hotReload, ICorDebugThread *pThread, FrameLevel startFrame,
+                                      unsigned maxFrames, int &totalFrames, bool hotReloadAwareCaller, WalkStackTraceCallback cb)
 {
     LogFuncEntry();
 
@@ -987,12 +1242,14 @@ static HRESULT InternalGetStackTrace(Modules *pModules, bool hotReload, ICorDebu
 
     int currentFrame = -1;
 
-    auto AddFrameStatementFlag = [&] ()
+    auto ReturnFrame = [&] (StackFrame &stackFrame)
     {
         if (currentFrame == 0)
-            stackFrames.back().activeStatementFlags |= StackFrame::ActiveStatementFlags::LeafFrame;
+            stackFrame.activeStatementFlags |= StackFrame::ActiveStatementFlags::LeafFrame;
         else
-            stackFrames.back().activeStatementFlags |= StackFrame::ActiveStatementFlags::NonLeafFrame;
+            stackFrame.activeStatementFlags |= StackFrame::ActiveStatementFlags::NonLeafFrame;
+
+        return cb(stackFrame);
     };
 
     IfFailRet(WalkFrames(pThread, [&](
@@ -1011,22 +1268,25 @@ static HRESULT InternalGetStackTrace(Modules *pModules, bool hotReload, ICorDebu
         switch(frameType)
         {
             case FrameUnknown:
-                stackFrames.emplace_back(threadId, FrameLevel{currentFrame}, "?");
-                stackFrames.back().addr = GetFrameAddr(pFrame);
-                AddFrameStatementFlag();
-                break;
+                {
+                    StackFrame stackFrame(threadId, FrameLevel{currentFrame}, "?");
+                    stackFrame.addr = GetFrameAddr(pFrame);
+                    return ReturnFrame(stackFrame);
+                }
             case FrameNative:
-                stackFrames.emplace_back(threadId, FrameLevel{currentFrame}, pNative->symbol);
-                stackFrames.back().addr = pNative->addr;
-                stackFrames.back().source = Source(pNative->file);
-                stackFrames.back().line = pNative->linenum;
-                AddFrameStatementFlag();
-                break;
+                {
+                    StackFrame stackFrame(threadId, FrameLevel{currentFrame}, pNative->symbol);
+                    stackFrame.addr = pNative->addr;
+                    stackFrame.source = Source(pNative->file);
+                    stackFrame.line = pNative->linenum;
+                    return ReturnFrame(stackFrame);
+                }
             case FrameCLRNative:
-                stackFrames.emplace_back(threadId, FrameLevel{currentFrame}, "[Native Frame]");
-                stackFrames.back().addr = GetFrameAddr(pFrame);
-                AddFrameStatementFlag();
-                break;
+                {
+                    StackFrame stackFrame(threadId, FrameLevel{currentFrame}, "[Native Frame]");
+                    stackFrame.addr = GetFrameAddr(pFrame);
+                    return ReturnFrame(stackFrame);
+                }
             case FrameCLRInternal:
                 {
                     ToRelease<ICorDebugInternalFrame> pInternalFrame;
@@ -1036,19 +1296,16 @@ static HRESULT InternalGetStackTrace(Modules *pModules, bool hotReload, ICorDebu
                     std::string name = "[";
                     name += GetInternalTypeName(corFrameType);
                     name += "]";
-                    stackFrames.emplace_back(threadId, FrameLevel{currentFrame}, name);
-                    stackFrames.back().addr = GetFrameAddr(pFrame);
-                    AddFrameStatementFlag();
+                    StackFrame stackFrame(threadId, FrameLevel{currentFrame}, name);
+                    stackFrame.addr = GetFrameAddr(pFrame);
+                    return ReturnFrame(stackFrame);
                 }
-                break;
             case FrameCLRManaged:
                 {
                     StackFrame stackFrame;
                     InternalGetFrameLocation(pFrame, pModules, hotReload, threadId, FrameLevel{currentFrame}, stackFrame, hotReloadAwareCaller);
-                    stackFrames.push_back(stackFrame);
-                    AddFrameStatementFlag();
+                    return ReturnFrame(stackFrame);
                 }
-                break;
         }
 
         return S_OK;
@@ -1059,6 +1316,17 @@ static HRESULT InternalGetStackTrace(Modules *pModules, bool hotReload, ICorDebu
     return S_OK;
 }
 
+static HRESULT InternalGetStackTrace(Modules *pModules, bool hotReload, ICorDebugThread *pThread, FrameLevel startFrame,
+                                     unsigned maxFrames, std::vector<StackFrame> &stackFrames, int &totalFrames, bool hotReloadAwareCaller)
+{
+    return InternalWalkStackTrace(pModules, hotReload, pThread, startFrame, maxFrames, totalFrames, hotReloadAwareCaller,
+                                  [&](StackFrame &stackFrame)
+    {
+        stackFrames.emplace_back(std::move(stackFrame));
+        return S_OK;
+    });
+}
+
 HRESULT ManagedDebugger::GetStackTrace(ThreadId  threadId, FrameLevel startFrame, unsigned maxFrames, std::vector<StackFrame> &stackFrames, int &totalFrames, bool hotReloadAwareCaller)
 {
     LogFuncEntry();
@@ -1067,15 +1335,208 @@ HRESULT ManagedDebugger::GetStackTrace(ThreadId  threadId, FrameLevel startFrame
     HRESULT Status;
     IfFailRet(CheckDebugProcess(m_iCorProcess, m_processAttachedMutex, m_processAttachedState));
 
+    const std::pair<int, bool> key(int(threadId), hotReloadAwareCaller);
+    std::unique_lock<std::mutex> lock(m_stackTraceCacheMutex);
+    auto find = m_stackTraceCache.find(key);
+    if (find == m_stackTraceCache.end())
+    {
+        lock.unlock();
+        ToRelease<ICorDebugThread> pThread;
+        IfFailRet(m_iCorProcess->GetThread(int(threadId), &pThread));
+        std::vector<StackFrame> fullStackFrames;
+        int fullTotalFrames = 0;
+        IfFailRet(InternalGetStackTrace(m_sharedModules.get(), m_hotReload, pThread, FrameLevel{0}, 0, fullStackFrames, fullTotalFrames, hotReloadAwareCaller));
+        lock.lock();
+        find = m_stackTraceCache.emplace(key, std::move(fullStackFrames)).first;
+    }
+
+    const std::vector<StackFrame> &fullStackFrames = find->second;
+    totalFrames = int(fullStackFrames.size());
+    if (int(startFrame) >= totalFrames)
+        return S_OK;
+
+    auto first = fullStackFrames.begin() + int(startFrame);
+    auto last = (maxFrames == 0 || unsigned(totalFrames - int(startFrame)) <= maxFrames) ? fullStackFrames.end() : first + maxFrames;
+    stackFrames.insert(stackFrames.end(), first, last);
+
+    return S_OK;
+}
+
+HRESULT ManagedDebugger::WalkStackTrace(ThreadId threadId, FrameLevel startFrame, std::function<bool(const StackFrame&)> cb, bool hotReloadAwareCaller)
+{
+    LogFuncEntry();
+
+    std::lock_guard<Utility::RWLock::Reader> guardProcessRWLock(m_debugProcessRWLock.reader);
+    HRESULT Status;
+    IfFailRet(CheckDebugProcess(m_iCorProcess, m_processAttachedMutex, m_processAttachedState));
+
+    const std::pair<int, bool> key(int(threadId), hotReloadAwareCaller);
+    {
+        std::unique_lock<std::mutex> lock(m_stackTraceCacheMutex);
+        if (m_stackTraceCache.find(key) != m_stackTraceCache.end())
+        {
+            // Stack already unwound, but cache mutex must not be held during callback (it could wait for user's input).
+            for (size_t i = size_t(int(startFrame)); ; i++)
+            {
+                auto find = m_stackTraceCache.find(key);
+                if (find == m_stackTraceCache.end() || i >= find->second.size())
+                    return S_OK;
+
+                StackFrame stackFrame = find->second[i];
+                lock.unlock();
+                if (!cb(stackFrame))
+                    return S_OK;
+                lock.lock();
+            }
+        }
+    }
+
+    ToRelease<ICorDebugThread> pThread;
+    IfFailRet(m_iCorProcess->GetThread(int(threadId), &pThread));
+
+    // Unwind stack frame by frame, so caller could stop unwind in any time. In case whole stack was unwound
+    // from top frame, cache it (same as GetStackTrace() do).
+    bool aborted = false;
+    std::vector<StackFrame> fullStackFrames;
+    int totalFrames = 0;
+    Status = InternalWalkStackTrace(m_sharedModules.get(), m_hotReload, pThread, startFrame, 0, totalFrames, hotReloadAwareCaller,
+                                    [&](StackFrame &stackFrame)
+    {
+        if (!cb(stackFrame))
+        {
+            aborted = true;
+            return E_ABORT;
+        }
+        if (int(startFrame) == 0)
+            fullStackFrames.push_back(stackFrame);
+        return S_OK;
+    });
+
+    if (aborted)
+        return S_OK;
+    IfFailRet(Status);
+
+    if (int(startFrame) == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_stackTraceCacheMutex);
+        m_stackTraceCache.emplace(key, std::move(fullStackFrames));
+    }
+
+    return S_OK;
+}
+
+HRESULT ManagedDebugger::GetStackDepth(ThreadId threadId, int maxDepth, int &depth)
+{
+    LogFuncEntry();
+
+    std::lock_guard<Utility::RWLock::Reader> guardProcessRWLock(m_debugProcessRWLock.reader);
+    HRESULT Status;
+    IfFailRet(CheckDebugProcess(m_iCorProcess, m_processAttachedMutex, m_processAttachedState));
+
+    {
+        std::lock_guard<std::mutex> lock(m_stackTraceCacheMutex);
+        // Any cached stack trace of this thread have all frames, no matter for what caller it was unwound.
+        for (const auto &entry : m_stackTraceCache)
+        {
+            if (entry.first.first != int(threadId))
+                continue;
+
+            depth = int(entry.second.size());
+            if (maxDepth > 0 && depth > maxDepth)
+                depth = maxDepth;
+            return S_OK;
+        }
+    }
+
     ToRelease<ICorDebugThread> pThread;
     IfFailRet(m_iCorProcess->GetThread(int(threadId), &pThread));
-    return InternalGetStackTrace(m_sharedModules.get(), m_hotReload, pThread, startFrame, maxFrames, stackFrames, totalFrames, hotReloadAwareCaller);
+
+    // Don't resolve frames locations, only count frames, and stop stack walk as soon as maxDepth reached.
+    depth = 0;
+    Status = WalkFrames(pThread, [&](FrameType, ICorDebugFrame*, NativeFrame*, ICorDebugFunction*)
+    {
+        depth++;
+        return (maxDepth > 0 && depth >= maxDepth) ? E_ABORT : S_OK;
+    });
+
+    if (Status == E_ABORT && maxDepth > 0 && depth >= maxDepth)
+        return S_OK;
+
+    return Status;
+}
+
+// Execute breakpoint's commands at breakpoint hit, output of all commands collected in one block.
+// Supported commands: `print <expression>` (`p`), `backtrace` (`bt`) and `continue` (`c`), that resume debuggee
+// instead of stop at breakpoint (commands after `continue` are ignored).
+HRESULT ManagedDebugger::RunBreakpointCommands(ICorDebugThread *pThread, const Breakpoint &breakpoint, std::string &output, bool &autoContinue)
+{
+    HRESULT Status;
+    autoContinue = false;
+    ThreadId threadId(getThreadId(pThread));
+    ToRelease<ICorDebugProcess> iCorProcess;
+    IfFailRet(pThread->GetProcess(&iCorProcess));
+
+    std::ostringstream ss;
+    for (const auto &command : breakpoint.commands)
+    {
+        size_t nameEnd = command.find(' ');
+        std::string name = command.substr(0, nameEnd);
+        std::string args;
+        if (nameEnd != std::string::npos)
+        {
+            size_t argsStart = command.find_first_not_of(' ', nameEnd);
+            if (argsStart != std::string::npos)
+                args = command.substr(argsStart);
+        }
+
+        if (name == "print" || name == "p")
+        {
+            Variable variable;
+            std::string evalOutput;
+            // Note, debuggee could be continued without variables references clear, so, don't create reference here.
+            if (SUCCEEDED(Status = m_sharedVariables->EvaluateValue(iCorProcess, FrameId(threadId, FrameLevel{0}), args, variable, evalOutput)))
+                ss << args << " = " << variable.value << "\n";
+            else
+                ss << args << ": " << (evalOutput.empty() ? errormessage(Status) : evalOutput) << "\n";
+        }
+        else if (name == "backtrace" || name == "bt")
+        {
+            std::vector<StackFrame> stackFrames;
+            int totalFrames = 0;
+            if (FAILED(Status = InternalGetStackTrace(m_sharedModules.get(), m_hotReload, pThread, FrameLevel{0}, 0, stackFrames, totalFrames, false)))
+            {
+                ss << "backtrace: " << errormessage(Status) << "\n";
+                continue;
+            }
+
+            for (const StackFrame &stackFrame : stackFrames)
+            {
+                ss << "#" << int(stackFrame.GetLevel()) << " " << stackFrame.name;
+                if (!stackFrame.source.IsNull())
+                    ss << " at " << stackFrame.source.path << ":" << stackFrame.line;
+                ss << "\n";
+            }
+        }
+        else if (name == "continue" || name == "c")
+        {
+            autoContinue = true;
+            break;
+        }
+        else
+            ss << "Undefined breakpoint command: \"" << command << "\"\n";
+    }
+
+    output = ss.str();
+    return S_OK;
 }
 
 int ManagedDebugger::GetNamedVariables(uint32_t variablesReference)
 {
     LogFuncEntry();
 
+    if (Snapshots::IsSnapshotReference(variablesReference))
+        return m_sharedSnapshots->GetNamedVariables(variablesReference);
+
     return m_sharedVariables->GetNamedVariables(variablesReference);
 }
 
@@ -1084,15 +1545,35 @@ HRESULT ManagedDebugger::GetVariables(
     VariablesFilter filter,
     int start,
     int count,
-    std::vector<Variable> &variables)
+    std::vector<Variable> &variables,
+    VariablesValues values)
 {
     LogFuncEntry();
 
+    // Snapshot's data don't depend on debuggee state, could be provided even for running or exited process.
+    if (Snapshots::IsSnapshotReference(variablesReference))
+        return m_sharedSnapshots->GetVariables(variablesReference, filter, start, count, variables);
+
     std::lock_guard<Utility::RWLock::Reader> guardProcessRWLock(m_debugProcessRWLock.reader);
     HRESULT Status;
     IfFailRet(CheckDebugProcess(m_iCorProcess, m_processAttachedMutex, m_processAttachedState));
 
-    return m_sharedVariables->GetVariables(m_iCorProcess, variablesReference, filter, start, count, variables);
+    return m_sharedVariables->GetVariables(m_iCorProcess, variablesReference, filter, start, count, variables, values);
+}
+
+HRESULT ManagedDebugger::GetSnapshots(std::vector<Snapshot> &snapshots)
+{
+    LogFuncEntry();
+
+    m_sharedSnapshots->GetSnapshots(snapshots);
+    return S_OK;
+}
+
+void ManagedDebugger::DeleteSnapshots()
+{
+    LogFuncEntry();
+
+    m_sharedSnapshots->DeleteAll();
 }
 
 HRESULT ManagedDebugger::GetScopes(FrameId frameId, std::vector<Scope> &scopes)
@@ -1269,9 +1750,31 @@ IDebugger::AsyncResult ManagedDebugger::ProcessStdin(InStream& stream)
 
 void ManagedDebugger::SetJustMyCode(bool enable)
 {
+    std::lock_guard<Utility::RWLock::Reader> guardProcessRWLock(m_debugProcessRWLock.reader);
+    std::lock_guard<std::mutex> lock(m_justMyCodeMutex);
+
     m_justMyCode = enable;
     m_uniqueSteppers->SetJustMyCode(enable);
     m_uniqueBreakpoints->SetJustMyCode(enable);
+
+    if (enable)
+        return;
+
+    // Symbols for non-user code modules are not loaded with enabled JMC, load them now.
+    m_sharedModules->LoadSkippedModulesSymbols([&](ICorDebugModule *pModule, const Module &module, const std::string &outputText)
+    {
+        if (!outputText.empty())
+            m_sharedProtocol->EmitOutputEvent(OutputStdErr, outputText);
+        m_sharedProtocol->EmitModuleEvent(ModuleEvent(ModuleChanged, module));
+
+        if (module.symbolStatus != SymbolsLoaded)
+            return;
+
+        std::vector<BreakpointEvent> events;
+        m_uniqueBreakpoints->ManagedCallbackLoadModule(pModule, events);
+        for (const BreakpointEvent &event : events)
+            m_sharedProtocol->EmitBreakpointEvent(event);
+    });
 }
 
 void ManagedDebugger::SetStepFiltering(bool enable)
@@ -1280,6 +1783,11 @@ void ManagedDebugger::SetStepFiltering(bool enable)
     m_uniqueSteppers->SetStepFiltering(enable);
 }
 
+void ManagedDebugger::SetSymbolOptions(const SymbolOptions &options)
+{
+    m_sharedModules->SetSymbolOptions(options);
+}
+
 HRESULT ManagedDebugger::SetHotReload(bool enable)
 {
     std::lock_guard<Utility::RWLock::Reader> guardProcessRWLock(m_debugProcessRWLock.reader);
@@ -1292,6 +1800,18 @@ HRESULT ManagedDebugger::SetHotReload(bool enable)
     return S_OK;
 }
 
+HRESULT ManagedDebugger::SetPropertiesHelper(bool enable)
+{
+    std::lock_guard<Utility::RWLock::Reader> guardProcessRWLock(m_debugProcessRWLock.reader);
+
+    if (m_iCorProcess && m_startMethod == StartAttach)
+        return CORDBG_E_CANNOT_BE_ON_ATTACH;
+
+    m_propertiesHelper = enable;
+
+    return S_OK;
+}
+
 static HRESULT ApplyMetadataAndILDeltas(Modules *pModules, const std::string &dllFileName, const std::string &deltaMD, const std::string &deltaIL)
 {
     HRESULT Status;
@@ -1389,9 +1909,9 @@ HRESULT ManagedDebugger::HotReloadApplyDeltas(const std::string &dllFileName, co
 {
     LogFuncEntry();
 
-    std::lock_guard<Utility::RWLock::Reader> guardProcessRWLock(m_debugProcessRWLock.reader);
+    std::unique_lock<Utility::RWLock::Reader> guardProcessRWLock(m_debugProcessRWLock.reader);
 
-    if (!m_iCorProcess)
+    if (!m_iCorProcess || m_dumpDataTarget)
         return E_FAIL;
 
     // Deltas can be applied only on stopped debuggee process. For Hot Reload scenario we temporary stop it and continue after deltas applied.
@@ -1403,16 +1923,27 @@ HRESULT ManagedDebugger::HotReloadApplyDeltas(const std::string &dllFileName, co
     std::string updatedDLL;
     std::unordered_set<mdTypeDef> updatedTypeTokens;
     IfFailRet(ApplyPdbDeltaAndLineUpdates(dllFileName, deltaPDB, lineUpdates, updatedDLL, updatedTypeTokens));
+    InvalidateStackTraceCache(); // Frames active statement flags could be changed.
 
+    std::string signalPath;
     ToRelease<ICorDebugThread> pThread;
     if (SUCCEEDED(FindEvalCapableThread(pThread)))
         IfFailRet(HotReloadHelpers::UpdateApplication(pThread, m_sharedModules.get(), m_sharedEvaluator.get(), m_sharedEvalHelpers.get(), updatedDLL, updatedTypeTokens));
     else
+    {
         IfFailRet(m_uniqueBreakpoints->SetHotReloadBreakpoint(updatedDLL, updatedTypeTokens));
+        signalPath = m_hotReloadSignalPath;
+    }
 
     if (continueProcess)
         IfFailRet(m_managedCallback->Continue(m_iCorProcess));
 
+    // Startup hook accept connection only in running process, so, signal it after continue and without process lock.
+    // In case of signal failure, startup hook will call `ncdbfunc()` by timeout.
+    guardProcessRWLock.unlock();
+    if (!signalPath.empty() && FAILED(HotReloadHelpers::SignalStartupHook(signalPath)))
+        LOGW("Can't signal startup hook, update handlers will be called with delay.");
+
     return S_OK;
 }
 
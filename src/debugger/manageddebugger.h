@@ -9,6 +9,7 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <atomic>
 #include "interfaces/idebugger.h"
 #include "debugger/dbgshim.h"
 #include "utils/string_view.h"
@@ -30,6 +31,8 @@ class EvalWaiter;
 class EvalHelpers;
 class EvalStackMachine;
 class Variables;
+class Snapshots;
+class DumpDataTarget;
 class ManagedCallback;
 class Breakpoints;
 class Modules;
@@ -59,14 +62,23 @@ private:
     void SetLastStoppedThread(ICorDebugThread *pThread);
     void SetLastStoppedThreadId(ThreadId threadId);
 
+    // Full stack traces unwound during current stop (key - thread id and hot reload aware caller flag), so paged
+    // frames requests don't unwind whole stack for each page. Must be invalidated before any process continue.
+    std::mutex m_stackTraceCacheMutex;
+    std::map<std::pair<int, bool>, std::vector<StackFrame>> m_stackTraceCache;
+
+    void InvalidateStackTraceCache();
+
     enum StartMethod
     {
         StartNone,
         StartLaunch,
-        StartAttach
+        StartAttach,
+        StartDump
         //StartAttachForSuspendedLaunch
     } m_startMethod;
     std::string m_execPath;
+    std::string m_dumpPath;
     std::vector<std::string> m_execArgs;
     std::string m_cwd;
     std::map<std::string, std::string> m_env;
@@ -79,6 +91,7 @@ private:
     std::shared_ptr<EvalStackMachine> m_sharedEvalStackMachine;
     std::shared_ptr<Evaluator> m_sharedEvaluator;
     std::shared_ptr<Variables> m_sharedVariables;
+    std::shared_ptr<Snapshots> m_sharedSnapshots;
     std::unique_ptr<Steppers> m_uniqueSteppers;
     std::unique_ptr<Breakpoints> m_uniqueBreakpoints;
     std::unique_ptr<ManagedCallback> m_managedCallback;
@@ -86,10 +99,17 @@ private:
     Utility::RWLock m_debugProcessRWLock;
     ToRelease<ICorDebug> m_iCorDebug;
     ToRelease<ICorDebugProcess> m_iCorProcess;
+    std::unique_ptr<DumpDataTarget> m_dumpDataTarget; // post-mortem debugging only, m_iCorDebug and m_managedCallback not used
 
-    bool m_justMyCode;
+    // Note, set by protocol thread and read in managed callback thread.
+    std::atomic<bool> m_justMyCode;
+    // Serialize JMC change with modules load, since symbols of non-user code modules loaded at JMC disable
+    // (module, that was loaded with enabled JMC in the same time, must be skipped before, or loaded with symbols).
+    std::mutex m_justMyCodeMutex;
     bool m_stepFiltering;
     bool m_hotReload;
+    std::string m_hotReloadSignalPath;
+    bool m_propertiesHelper;
 
     PVOID m_unregisterToken;
     DWORD m_processId;
@@ -108,9 +128,11 @@ private:
     void DisableAllBreakpointsAndSteppers();
 
     HRESULT GetFrameLocation(ICorDebugFrame *pFrame, ThreadId threadId, FrameLevel level, StackFrame &stackFrame);
+    HRESULT RunBreakpointCommands(ICorDebugThread *pThread, const Breakpoint &breakpoint, std::string &output, bool &autoContinue);
 
     HRESULT RunProcess(const std::string& fileExec, const std::vector<std::string>& execArgs);
     HRESULT AttachToProcess(DWORD pid);
+    HRESULT OpenDumpFile(const std::string &dumpPath);
     HRESULT DetachFromProcess();
     HRESULT TerminateProcess();
 
@@ -128,11 +150,15 @@ public:
     void SetJustMyCode(bool enable) override;
     bool IsStepFiltering() const override { return m_stepFiltering; }
     void SetStepFiltering(bool enable) override;
+    void SetSymbolOptions(const SymbolOptions &options) override;
     bool IsHotReload() const override { return m_hotReload; }
     HRESULT SetHotReload(bool enable) override;
+    bool IsPropertiesHelper() const override { return m_propertiesHelper; }
+    HRESULT SetPropertiesHelper(bool enable) override;
 
     HRESULT Initialize() override;
     HRESULT Attach(int pid) override;
+    HRESULT OpenDump(const std::string &dumpPath) override;
     HRESULT Launch(const std::string &fileExec, const std::vector<std::string> &execArgs, const std::map<std::string, std::string> &env,
                    const std::string &cwd, bool stopAtEntry = false) override;
     HRESULT ConfigurationDone() override;
@@ -152,10 +178,15 @@ public:
     void EnumerateBreakpoints(std::function<bool (const IDebugger::BreakpointInfo&)>&& callback) override;
     HRESULT AllBreakpointsActivate(bool act) override;
     HRESULT GetStackTrace(ThreadId threadId, FrameLevel startFrame, unsigned maxFrames, std::vector<StackFrame> &stackFrames, int &totalFrames, bool hotReloadAwareCaller = false) override;
+    HRESULT WalkStackTrace(ThreadId threadId, FrameLevel startFrame, std::function<bool(const StackFrame&)> cb, bool hotReloadAwareCaller = false) override;
+    HRESULT GetStackDepth(ThreadId threadId, int maxDepth, int &depth) override;
     HRESULT StepCommand(ThreadId threadId, StepType stepType) override;
     HRESULT GetScopes(FrameId frameId, std::vector<Scope> &scopes) override;
-    HRESULT GetVariables(uint32_t variablesReference, VariablesFilter filter, int start, int count, std::vector<Variable> &variables) override;
+    HRESULT GetVariables(uint32_t variablesReference, VariablesFilter filter, int start, int count, std::vector<Variable> &variables,
+                         VariablesValues values = VariablesAllValues) override;
     int GetNamedVariables(uint32_t variablesReference) override;
+    HRESULT GetSnapshots(std::vector<Snapshot> &snapshots) override;
+    void DeleteSnapshots() override;
     HRESULT Evaluate(FrameId frameId, const std::string &expression, Variable &variable, std::string &output) override;
     void CancelEvalRunning() override;
     HRESULT SetVariable(const std::string &name, const std::string &value, uint32_t ref, std::string &output) override;
@@ -0,0 +1,297 @@
+// Copyright (c) 2022 Samsung Electronics Co., LTD
+// Distributed under the MIT License.
+// See the LICENSE file in the project root for more information.
+
+#include "debugger/snapshots.h"
+
+#include <algorithm>
+#include "debugger/evaluator.h"
+#include "debugger/frames.h"
+#include "debugger/valueprint.h"
+#include "metadata/modules.h"
+#include "metadata/typeprinter.h"
+#include "utils/logger.h"
+
+namespace netcoredbg
+{
+
+uint32_t Snapshots::SnapshotData::AddString(const std::string &str)
+{
+    uint32_t offset = (uint32_t)strings.size();
+    if (str.size() > MaxValueLength)
+    {
+        strings.append(str, 0, MaxValueLength);
+        strings.append("...");
+    }
+    else
+        strings.append(str);
+
+    strings.push_back('\0');
+    return offset;
+}
+
+HRESULT Snapshots::AddChildren(SnapshotData &data, uint32_t parentIndex, std::vector<SnapshotMember> &members, int depth)
+{
+    if (members.empty())
+        return S_OK;
+
+    size_t firstChild = data.records.size();
+    size_t childCount = std::min(members.size(), MaxRecordsPerSnapshot - firstChild);
+    if (childCount == 0)
+        return S_OK;
+
+    data.records[parentIndex].firstChild = (uint32_t)firstChild;
+    data.records[parentIndex].childCount = (uint32_t)childCount;
+
+    for (size_t i = 0; i < childCount; i++)
+    {
+        std::string type;
+        std::string value;
+        if (members[i].iCorValue == nullptr)
+            value = "<error>";
+        else
+        {
+            PrintValue(members[i].iCorValue, value, true);
+            TypePrinter::GetTypeOfValue(members[i].iCorValue, type);
+        }
+
+        ValueRecord record;
+        record.name = data.AddString(members[i].name);
+        record.type = data.AddString(type);
+        record.value = data.AddString(value);
+        record.firstChild = 0;
+        record.childCount = 0;
+        data.records.emplace_back(record);
+    }
+
+    if (depth <= 0)
+        return S_OK;
+
+    HRESULT Status;
+    for (size_t i = 0; i < childCount; i++)
+    {
+        if (members[i].iCorValue == nullptr)
+            continue;
+
+        // Note, no thread provided for WalkMembers(), so, properties getters and static members (that need frame) can't be
+        // evaluated, all we get here is object's instance fields (or array's elements).
+        std::vector<SnapshotMember> childMembers;
+        if (FAILED(Status = m_sharedEvaluator->WalkMembers(members[i].iCorValue, nullptr, FrameLevel{0}, false, [&](
+            ICorDebugType *,
+            bool is_static,
+            const std::string &name,
+            Evaluator::GetValueCallback getValue,
+            Evaluator::SetterData*) -> HRESULT
+        {
+            if (is_static)
+                return S_OK;
+
+            if (childMembers.size() >= MaxChildrenPerValue)
+                return E_ABORT; // Fast exit from cycle.
+
+            ToRelease<ICorDebugValue> iCorValue;
+            if (FAILED(getValue(&iCorValue, defaultEvalFlags)) || iCorValue == nullptr)
+                return S_OK; // property, skip it
+
+            childMembers.emplace_back(name, iCorValue.Detach());
+            return S_OK;
+        })) && Status != E_ABORT)
+        {
+            continue;
+        }
+
+        IfFailRet(AddChildren(data, (uint32_t)(firstChild + i), childMembers, depth - 1));
+    }
+
+    return S_OK;
+}
+
+HRESULT Snapshots::CaptureSnapshot(ICorDebugThread *pThread, const Breakpoint &breakpoint)
+{
+    LogFuncEntry();
+
+    HRESULT Status;
+    DWORD threadId = 0;
+    IfFailRet(pThread->GetID(&threadId));
+
+    SnapshotData data;
+    data.snapshot.breakpointId = breakpoint.id;
+    data.snapshot.threadId = ThreadId{threadId};
+
+    const int maxFrames = std::min(breakpoint.snapshot.frames, int(MaxFrames));
+    const int depth = std::min(breakpoint.snapshot.depth, int(MaxDepth));
+
+    // Find top managed frames first, since WalkStackVars() use frame level (that count all frames, not only managed).
+    std::vector<FrameLevel> frameLevels;
+    int currentFrame = -1;
+    if (FAILED(Status = WalkFrames(pThread, [&](
+        FrameType frameType,
+        ICorDebugFrame *pFrame,
+        NativeFrame *,
+        ICorDebugFunction *) -> HRESULT
+    {
+        currentFrame++;
+
+        if (frameType != FrameCLRManaged)
+            return S_OK;
+
+        data.snapshot.frames.emplace_back();
+        SnapshotFrame &frame = data.snapshot.frames.back();
+        TypePrinter::GetMethodName(pFrame, frame.name);
+
+        ULONG32 ilOffset;
+        Modules::SequencePoint sp;
+        if (SUCCEEDED(m_sharedModules->GetFrameILAndSequencePoint(pFrame, ilOffset, sp)))
+        {
+            frame.source = Source(sp.document);
+            frame.line = sp.startLine;
+            frame.column = sp.startColumn;
+        }
+
+        frameLevels.emplace_back(currentFrame);
+        if ((int)frameLevels.size() >= maxFrames)
+            return E_ABORT; // Fast exit from cycle.
+
+        return S_OK;
+    })) && Status != E_ABORT)
+    {
+        return Status;
+    }
+
+    // Frame records go first, so, frame's record index is equal to frame index.
+    data.records.resize(frameLevels.size(), ValueRecord{0, 0, 0, 0, 0});
+    for (size_t i = 0; i < frameLevels.size(); i++)
+    {
+        data.records[i].name = data.AddString(data.snapshot.frames[i].name);
+        data.records[i].type = data.AddString("");
+        data.records[i].value = data.records[i].type;
+    }
+
+    for (size_t i = 0; i < frameLevels.size(); i++)
+    {
+        std::vector<SnapshotMember> locals;
+        if (FAILED(m_sharedEvaluator->WalkStackVars(pThread, frameLevels[i],
+            [&](const std::string &name, Evaluator::GetValueCallback getValue) -> HRESULT
+        {
+            ToRelease<ICorDebugValue> iCorValue;
+            getValue(&iCorValue, defaultEvalFlags); // Note, in case of error, member will be stored with "<error>" value.
+            locals.emplace_back(name, iCorValue.Detach());
+            return S_OK;
+        })))
+        {
+            LOGW("Snapshot: can't walk frame %d variables", int(frameLevels[i]));
+        }
+
+        IfFailRet(AddChildren(data, (uint32_t)i, locals, depth));
+    }
+
+    std::lock_guard<std::mutex> lock(m_snapshotsMutex);
+
+    data.snapshot.id = m_nextSnapshotId++;
+    for (size_t i = 0; i < data.snapshot.frames.size(); i++)
+    {
+        data.snapshot.frames[i].scope = Scope(MakeReference(data, (uint32_t)i), "Locals", (int)data.records[i].childCount);
+    }
+
+    if (m_snapshots.size() >= MaxSnapshots)
+        m_snapshots.pop_front();
+
+    m_snapshots.emplace_back(std::move(data));
+
+    return S_OK;
+}
+
+void Snapshots::GetSnapshots(std::vector<Snapshot> &snapshots)
+{
+    std::lock_guard<std::mutex> lock(m_snapshotsMutex);
+
+    snapshots.reserve(snapshots.size() + m_snapshots.size());
+    for (const auto &data : m_snapshots)
+    {
+        snapshots.emplace_back(data.snapshot);
+    }
+}
+
+void Snapshots::DeleteAll()
+{
+    std::lock_guard<std::mutex> lock(m_snapshotsMutex);
+    m_snapshots.clear();
+}
+
+// Caller must care about m_snapshotsMutex.
+HRESULT Snapshots::FindRecord(uint32_t variablesReference, SnapshotData **ppData, ValueRecord **ppRecord)
+{
+    if (!IsSnapshotReference(variablesReference))
+        return E_INVALIDARG;
+
+    uint32_t id = (variablesReference >> SnapshotIdShift) & SnapshotIdMask;
+    uint32_t index = variablesReference & RecordIndexMask;
+
+    for (auto &data : m_snapshots)
+    {
+        if ((data.snapshot.id & SnapshotIdMask) != id)
+            continue;
+
+        if (index >= data.records.size())
+            return E_FAIL;
+
+        *ppData = &data;
+        *ppRecord = &data.records[index];
+        return S_OK;
+    }
+
+    return E_FAIL;
+}
+
+int Snapshots::GetNamedVariables(uint32_t variablesReference)
+{
+    std::lock_guard<std::mutex> lock(m_snapshotsMutex);
+
+    SnapshotData *data;
+    ValueRecord *record;
+    if (FAILED(FindRecord(variablesReference, &data, &record)))
+        return 0;
+
+    return (int)record->childCount;
+}
+
+HRESULT Snapshots::GetVariables(uint32_t variablesReference, VariablesFilter filter, int start, int count, std::vector<Variable> &variables)
+{
+    std::lock_guard<std::mutex> lock(m_snapshotsMutex);
+
+    HRESULT Status;
+    SnapshotData *data;
+    ValueRecord *record;
+    IfFailRet(FindRecord(variablesReference, &data, &record));
+
+    // Snapshot don't have indexed variables, array's elements are stored as named variables.
+    if (filter == VariablesIndexed)
+        return S_OK;
+
+    int childCount = (int)record->childCount;
+    if (start < 0 || start >= childCount)
+        return S_OK;
+    if (count == 0 || start + count > childCount)
+        count = childCount - start;
+
+    variables.reserve(variables.size() + count);
+    for (uint32_t i = record->firstChild + start; i < record->firstChild + start + count; i++)
+    {
+        const ValueRecord &child = data->records[i];
+
+        Variable var;
+        var.name = data->GetString(child.name);
+        var.type = data->GetString(child.type);
+        var.value = data->GetString(child.value);
+        if (child.childCount > 0)
+        {
+            var.variablesReference = MakeReference(*data, i);
+            var.namedVariables = (int)child.childCount;
+        }
+        variables.emplace_back(std::move(var));
+    }
+
+    return S_OK;
+}
+
+} // namespace netcoredbg
@@ -0,0 +1,107 @@
+// Copyright (c) 2022 Samsung Electronics Co., LTD
+// Distributed under the MIT License.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "cor.h"
+#include "cordebug.h"
+
+#include <mutex>
+#include <memory>
+#include <deque>
+#include <string>
+#include <vector>
+#include "interfaces/types.h"
+#include "utils/torelease.h"
+
+namespace netcoredbg
+{
+
+class Modules;
+class Evaluator;
+
+class Snapshots
+{
+public:
+
+    Snapshots(std::shared_ptr<Modules> &sharedModules, std::shared_ptr<Evaluator> &sharedEvaluator) :
+        m_sharedModules(sharedModules),
+        m_sharedEvaluator(sharedEvaluator),
+        m_nextSnapshotId(1)
+    {}
+
+    // Capture snapshot at breakpoint hit. Note, only values reads are used here (arguments, locals and fields),
+    // no evaluation is performed, so, debuggee state is not changed and process could be continued right after.
+    HRESULT CaptureSnapshot(ICorDebugThread *pThread, const Breakpoint &breakpoint);
+    void GetSnapshots(std::vector<Snapshot> &snapshots);
+    void DeleteAll();
+
+    // Snapshot's variables references have high bit set and never intersect with Variables class references.
+    static bool IsSnapshotReference(uint32_t variablesReference) { return (variablesReference & SnapshotReferenceFlag) != 0; }
+    int GetNamedVariables(uint32_t variablesReference);
+    HRESULT GetVariables(uint32_t variablesReference, VariablesFilter filter, int start, int count, std::vector<Variable> &variables);
+
+private:
+
+    // variablesReference layout: [31] flag | [30..20] snapshot id (low bits) | [19..0] value record index
+    static const uint32_t SnapshotReferenceFlag = 0x80000000;
+    static const uint32_t SnapshotIdShift = 20;
+    static const uint32_t SnapshotIdMask = 0x7FF;
+    static const uint32_t RecordIndexMask = 0xFFFFF;
+
+    static const size_t MaxSnapshots = 100;
+    static const size_t MaxRecordsPerSnapshot = 16384;
+    static const size_t MaxChildrenPerValue = 100;
+    static const size_t MaxValueLength = 512;
+    static const int MaxFrames = 32;
+    static const int MaxDepth = 8;
+
+    // Compact value record, all strings are stored in snapshot's strings table.
+    // Children of value are stored continuously in records array.
+    struct ValueRecord
+    {
+        uint32_t name;  // offset in strings table
+        uint32_t type;  // offset in strings table
+        uint32_t value; // offset in strings table
+        uint32_t firstChild;
+        uint32_t childCount;
+    };
+
+    struct SnapshotData
+    {
+        Snapshot snapshot;
+        std::vector<ValueRecord> records;
+        std::string strings;
+
+        uint32_t AddString(const std::string &str);
+        const char *GetString(uint32_t offset) const { return strings.c_str() + offset; }
+    };
+
+    struct SnapshotMember
+    {
+        std::string name;
+        ToRelease<ICorDebugValue> iCorValue;
+
+        SnapshotMember(const std::string &name, ICorDebugValue *pValue) : name(name), iCorValue(pValue) {}
+        SnapshotMember(SnapshotMember &&that) = default;
+        SnapshotMember(const SnapshotMember &that) = delete;
+    };
+
+    std::shared_ptr<Modules> m_sharedModules;
+    std::shared_ptr<Evaluator> m_sharedEvaluator;
+
+    std::mutex m_snapshotsMutex;
+    std::deque<SnapshotData> m_snapshots;
+    uint32_t m_nextSnapshotId;
+
+    HRESULT AddChildren(SnapshotData &data, uint32_t parentIndex, std::vector<SnapshotMember> &members, int depth);
+    HRESULT FindRecord(uint32_t variablesReference, SnapshotData **ppData, ValueRecord **ppRecord);
+
+    static uint32_t MakeReference(const SnapshotData &data, uint32_t recordIndex)
+    {
+        return SnapshotReferenceFlag | ((data.snapshot.id & SnapshotIdMask) << SnapshotIdShift) | recordIndex;
+    }
+};
+
+} // namespace netcoredbg
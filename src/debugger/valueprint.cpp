@@ -81,6 +81,36 @@ static bool IsEnum(ICorDebugValue *pInputValue)
     return baseTypeName == "System.Enum";
 }
 
+// Value could be printed without arrays/structs/classes formatting: primitive types, enums, decimal, strings and null.
+bool IsSimpleValue(ICorDebugValue *pInputValue)
+{
+    BOOL isNull = TRUE;
+    ToRelease<ICorDebugValue> pValue;
+    if (FAILED(DereferenceAndUnboxValue(pInputValue, &pValue, &isNull))) return false;
+    if (isNull) return true;
+
+    CorElementType corElemType;
+    if (FAILED(pValue->GetType(&corElemType))) return false;
+
+    switch (corElemType)
+    {
+    case ELEMENT_TYPE_SZARRAY:
+    case ELEMENT_TYPE_ARRAY:
+    case ELEMENT_TYPE_CLASS:
+    case ELEMENT_TYPE_OBJECT:
+        return false;
+    case ELEMENT_TYPE_VALUETYPE:
+        {
+            if (IsEnum(pValue))
+                return true;
+            std::string typeName;
+            return SUCCEEDED(TypePrinter::GetTypeOfValue(pValue, typeName)) && typeName == "decimal";
+        }
+    default:
+        return true;
+    }
+}
+
 static HRESULT PrintEnumValue(ICorDebugValue* pInputValue, BYTE* enumValue, std::string &output)
 {
     HRESULT Status = S_OK;
@@ -14,5 +14,6 @@ namespace netcoredbg
 HRESULT PrintValue(ICorDebugValue *pInputValue, std::string &output, bool escape = true);
 HRESULT PrintStringValue(ICorDebugValue * pValue, std::string &output);
 HRESULT DereferenceAndUnboxValue(ICorDebugValue * pValue, ICorDebugValue** ppOutputValue, BOOL * pIsNull = nullptr);
+bool IsSimpleValue(ICorDebugValue *pInputValue);
 
 } // namespace netcoredbg
@@ -10,6 +10,7 @@
 #include <sstream>
 
 #include "metadata/typeprinter.h"
+#include "metadata/modules.h"
 #include "valueprint.h"
 #include "debugger/variables.h"
 #include "debugger/evalhelpers.h"
@@ -87,9 +88,12 @@ static void FillValueAndType(VariableMember &member, Variable &var)
     TypePrinter::GetTypeOfValue(member.value, var.type);
 }
 
-static HRESULT FetchFieldsAndProperties(Evaluator *pEvaluator, ICorDebugValue *pInputValue, ICorDebugThread *pThread,
-                                        FrameLevel frameLevel, std::vector<VariableMember> &members, bool fetchOnlyStatic,
-                                        bool &hasStaticMembers, int childStart, int childEnd, int evalFlags)
+// Instance properties could be evaluated in one func-eval by debuggee side helper (see EvalHelpers::GetPropertiesValues()),
+// in this case members walk done twice - first collect properties and fields values, second evaluate by getter call only
+// properties, that was not evaluated by helper.
+static HRESULT FetchFieldsAndProperties(Evaluator *pEvaluator, EvalHelpers *pEvalHelpers, ICorDebugValue *pInputValue,
+                                        ICorDebugThread *pThread, FrameLevel frameLevel, std::vector<VariableMember> &members,
+                                        bool fetchOnlyStatic, bool &hasStaticMembers, int childStart, int childEnd, int evalFlags)
 {
     hasStaticMembers = false;
     HRESULT Status;
@@ -97,18 +101,30 @@ static HRESULT FetchFieldsAndProperties(Evaluator *pEvaluator, ICorDebugValue *p
     DWORD threadId = 0;
     IfFailRet(pThread->GetID(&threadId));
 
+    struct DeferredProperty
+    {
+        int index;
+        size_t member;
+    };
+    std::vector<DeferredProperty> deferredProperties;
+    std::vector<std::string> batchProperties;
+    const bool batchEval = !fetchOnlyStatic && !(evalFlags & EVAL_NOFUNCEVAL);
+
     int currentIndex = -1;
 
-    IfFailRet(pEvaluator->WalkMembers(pInputValue, pThread, frameLevel, false, [&](
+    IfFailRet(pEvaluator->WalkMembersWithGetters(pInputValue, pThread, frameLevel, [&](
         ICorDebugType *pType,
         bool is_static,
         const std::string &name,
         Evaluator::GetValueCallback getValue,
-        Evaluator::SetterData*)
+        mdMethodDef getterToken)
     {
         if (is_static)
             hasStaticMembers = true;
 
+        // Note, getter token provided for properties only.
+        bool batchProperty = batchEval && getterToken != mdMethodDefNil && !is_static;
+
         bool addMember = fetchOnlyStatic ? is_static : !is_static;
         if (!addMember)
             return S_OK;
@@ -119,20 +135,85 @@ static HRESULT FetchFieldsAndProperties(Evaluator *pEvaluator, ICorDebugValue *p
         if (currentIndex >= childEnd)
             return S_OK;
 
+        std::string className;
+        if (pType)
+            IfFailRet(TypePrinter::GetTypeOfValue(pType, className));
+
+        // Property is identified by declaring type module MVID, type and getter tokens, since getter could be declared
+        // in base type from another module (tokens are unique only inside one module).
+        ToRelease<ICorDebugClass> iCorClass;
+        ToRelease<ICorDebugModule> iCorModule;
+        mdTypeDef classToken = mdTypeDefNil;
+        std::string moduleId;
+        if (batchProperty && pType && SUCCEEDED(pType->GetClass(&iCorClass)) && SUCCEEDED(iCorClass->GetToken(&classToken)) &&
+            SUCCEEDED(iCorClass->GetModule(&iCorModule)) && SUCCEEDED(GetModuleId(iCorModule, moduleId)))
+        {
+            deferredProperties.emplace_back(DeferredProperty{currentIndex, members.size()});
+            batchProperties.emplace_back(moduleId + ":" + std::to_string(classToken) + ":" + std::to_string(getterToken));
+            members.emplace_back(name, className, nullptr);
+            return S_OK;
+        }
+
         // Note, in this case error is not fatal, but if protocol side need cancel command execution, stop walk and return error to caller.
         ToRelease<ICorDebugValue> iCorResultValue;
         if (getValue(&iCorResultValue, evalFlags) == COR_E_OPERATIONCANCELED)
             return COR_E_OPERATIONCANCELED;
 
-        std::string className;
-        if (pType)
-            IfFailRet(TypePrinter::GetTypeOfValue(pType, className));
-
         members.emplace_back(name, className, iCorResultValue.Detach());
         return S_OK;
     }));
 
-    return S_OK;
+    if (deferredProperties.empty())
+        return S_OK;
+
+    // Note, helper call cost two func-evals (arguments string creation and call itself).
+    static const size_t minBatchProperties = 3;
+    std::vector<ToRelease<ICorDebugValue>> batchResults;
+    Status = deferredProperties.size() < minBatchProperties ? E_FAIL :
+             pEvalHelpers->GetPropertiesValues(pThread, pInputValue, batchProperties, batchResults, evalFlags);
+    if (Status == COR_E_OPERATIONCANCELED)
+        return Status;
+    else if (SUCCEEDED(Status))
+    {
+        // Properties with null value also must be evaluated by getter call, since we need value with property type.
+        size_t count = 0;
+        for (size_t i = 0; i < deferredProperties.size(); i++)
+        {
+            if (batchResults[i] == nullptr)
+                deferredProperties[count++] = deferredProperties[i];
+            else
+                members[deferredProperties[i].member].value = batchResults[i].Detach();
+        }
+        deferredProperties.resize(count);
+
+        if (deferredProperties.empty())
+            return S_OK;
+    }
+
+    auto deferredProperty = deferredProperties.begin();
+    currentIndex = -1;
+
+    return pEvaluator->WalkMembersWithGetters(pInputValue, pThread, frameLevel, [&](
+        ICorDebugType *,
+        bool is_static,
+        const std::string &,
+        Evaluator::GetValueCallback getValue,
+        mdMethodDef)
+    {
+        if (is_static || deferredProperty == deferredProperties.end())
+            return S_OK;
+
+        if (++currentIndex != deferredProperty->index)
+            return S_OK;
+
+        ToRelease<ICorDebugValue> iCorResultValue;
+        if (getValue(&iCorResultValue, evalFlags) == COR_E_OPERATIONCANCELED)
+            return COR_E_OPERATIONCANCELED;
+
+        members[deferredProperty->member].value = iCorResultValue.Detach();
+        ++deferredProperty;
+        return S_OK;
+    });
 }
 
 int Variables::GetNamedVariables(uint32_t variablesReference)
@@ -152,7 +233,8 @@ HRESULT Variables::GetVariables(
     VariablesFilter filter,
     int start,
     int count,
-    std::vector<Variable> &variables)
+    std::vector<Variable> &variables,
+    VariablesValues values)
 {
     std::lock_guard<std::recursive_mutex> lock(m_referencesMutex);
 
@@ -175,7 +257,7 @@ HRESULT Variables::GetVariables(
 
     if (ref.IsScope())
     {
-        IfFailRet(GetStackVariables(ref.frameId, pThread, start, count, variables));
+        IfFailRet(GetStackVariables(ref.frameId, pThread, start, count, variables, values));
     }
     else
     {
@@ -205,7 +287,24 @@ HRESULT Variables::AddVariableReference(Variable &variable, FrameId frameId, ICo
     return S_OK;
 }
 
-HRESULT Variables::GetExceptionVariable(FrameId frameId, ICorDebugThread *pThread, Variable &var)
+HRESULT Variables::FillVariable(Variable &variable, FrameId frameId, ICorDebugValue *pValue, VariablesValues values)
+{
+    if (values == VariablesNoValues)
+        return S_OK;
+
+    HRESULT Status;
+    IfFailRet(TypePrinter::GetTypeOfValue(pValue, variable.type));
+    if (values == VariablesSimpleValues)
+    {
+        // Complex values are not printed and children are not counted, type is enough here.
+        return IsSimpleValue(pValue) ? PrintValue(pValue, variable.value) : S_OK;
+    }
+
+    IfFailRet(PrintValue(pValue, variable.value));
+    return AddVariableReference(variable, frameId, pValue, ValueIsVariable);
+}
+
+HRESULT Variables::GetExceptionVariable(FrameId frameId, ICorDebugThread *pThread, Variable &var, VariablesValues values)
 {
     ToRelease<ICorDebugValue> pExceptionValue;
     if (SUCCEEDED(pThread->GetCurrentException(&pExceptionValue)) && pExceptionValue != nullptr)
@@ -213,11 +312,7 @@ HRESULT Variables::GetExceptionVariable(FrameId frameId, ICorDebugThread *pThrea
         var.name = "$exception";
         var.evaluateName = var.name;
 
-        HRESULT Status;
-        IfFailRet(PrintValue(pExceptionValue, var.value));
-        IfFailRet(TypePrinter::GetTypeOfValue(pExceptionValue, var.type));
-
-        return AddVariableReference(var, frameId, pExceptionValue, ValueIsVariable);
+        return FillVariable(var, frameId, pExceptionValue, values);
     }
 
     return E_FAIL;
@@ -228,12 +323,13 @@ HRESULT Variables::GetStackVariables(
     ICorDebugThread *pThread,
     int start,
     int count,
-    std::vector<Variable> &variables)
+    std::vector<Variable> &variables,
+    VariablesValues values)
 {
     HRESULT Status;
     int currentIndex = -1;
     Variable var;
-    if (SUCCEEDED(GetExceptionVariable(frameId, pThread, var)))
+    if (SUCCEEDED(GetExceptionVariable(frameId, pThread, var, values)))
     {
         variables.push_back(var);
         ++currentIndex;
@@ -252,11 +348,12 @@ HRESULT Variables::GetStackVariables(
         Variable var;
         var.name = name;
         var.evaluateName = var.name;
-        ToRelease<ICorDebugValue> iCorValue;
-        IfFailRet(getValue(&iCorValue, var.evalFlags));
-        IfFailRet(PrintValue(iCorValue, var.value));
-        IfFailRet(TypePrinter::GetTypeOfValue(iCorValue, var.type));
-        IfFailRet(AddVariableReference(var, frameId, iCorValue, ValueIsVariable));
+        if (values != VariablesNoValues)
+        {
+            ToRelease<ICorDebugValue> iCorValue;
+            IfFailRet(getValue(&iCorValue, var.evalFlags));
+            IfFailRet(FillVariable(var, frameId, iCorValue, values));
+        }
         variables.push_back(var);
         return S_OK;
     })) && Status != E_ABORT)
@@ -337,9 +434,9 @@ HRESULT Variables::GetChildren(
     std::vector<VariableMember> members;
     bool hasStaticMembers = false;
 
-    IfFailRet(FetchFieldsAndProperties(m_sharedEvaluator.get(), ref.iCorValue, pThread, ref.frameId.getLevel(),
-                                       members, ref.valueKind == ValueIsClass, hasStaticMembers, start,
-                                       count == 0 ? INT_MAX : start + count, ref.evalFlags));
+    IfFailRet(FetchFieldsAndProperties(m_sharedEvaluator.get(), m_sharedEvalHelpers.get(), ref.iCorValue, pThread,
+                                       ref.frameId.getLevel(), members, ref.valueKind == ValueIsClass, hasStaticMembers,
+                                       start, count == 0 ? INT_MAX : start + count, ref.evalFlags));
 
     FixupInheritedFieldNames(members);
 
@@ -379,12 +476,8 @@ HRESULT Variables::GetChildren(
     return S_OK;
 }
 
-HRESULT Variables::Evaluate(
-    ICorDebugProcess *pProcess,
-    FrameId frameId,
-    const std::string &expression,
-    Variable &variable,
-    std::string &output)
+HRESULT Variables::EvaluateExpression(ICorDebugProcess *pProcess, FrameId frameId, const std::string &expression, Variable &variable,
+                                      std::string &output, ICorDebugValue **ppResultValue)
 {
     ThreadId threadId = frameId.getThread();
     if (!threadId)
@@ -401,9 +494,34 @@ HRESULT Variables::Evaluate(
     variable.evaluateName = expression;
     IfFailRet(PrintValue(pResultValue, variable.value));
     IfFailRet(TypePrinter::GetTypeOfValue(pResultValue, variable.type));
+    *ppResultValue = pResultValue.Detach();
+    return S_OK;
+}
+
+HRESULT Variables::Evaluate(
+    ICorDebugProcess *pProcess,
+    FrameId frameId,
+    const std::string &expression,
+    Variable &variable,
+    std::string &output)
+{
+    HRESULT Status;
+    ToRelease<ICorDebugValue> pResultValue;
+    IfFailRet(EvaluateExpression(pProcess, frameId, expression, variable, output, &pResultValue));
     return AddVariableReference(variable, frameId, pResultValue, ValueIsVariable);
 }
 
+HRESULT Variables::EvaluateValue(
+    ICorDebugProcess *pProcess,
+    FrameId frameId,
+    const std::string &expression,
+    Variable &variable,
+    std::string &output)
+{
+    ToRelease<ICorDebugValue> pResultValue;
+    return EvaluateExpression(pProcess, frameId, expression, variable, output, &pResultValue);
+}
+
 HRESULT Variables::SetVariable(
     ICorDebugProcess *pProcess,
     const std::string &name,
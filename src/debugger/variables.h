@@ -39,7 +39,8 @@ public:
         VariablesFilter filter,
         int start,
         int count,
-        std::vector<Variable> &variables);
+        std::vector<Variable> &variables,
+        VariablesValues values = VariablesAllValues);
 
     HRESULT SetVariable(
         ICorDebugProcess *pProcess,
@@ -68,10 +69,20 @@ public:
         Variable &variable,
         std::string &output);
 
+    // Same as Evaluate(), but variable reference is not created (result can't be expanded), so, could be used
+    // in case debuggee process continued right after evaluation and references will not be cleared.
+    HRESULT EvaluateValue(
+        ICorDebugProcess *pProcess,
+        FrameId frameId,
+        const std::string &expression,
+        Variable &variable,
+        std::string &output);
+
     HRESULT GetExceptionVariable(
         FrameId frameId,
         ICorDebugThread *pThread,
-        Variable &variable);
+        Variable &variable,
+        VariablesValues values = VariablesAllValues);
 
     void Clear()
     {
@@ -137,13 +148,17 @@ private:
     std::unordered_map<uint32_t, VariableReference> m_references;
 
     HRESULT AddVariableReference(Variable &variable, FrameId frameId, ICorDebugValue *pValue, ValueKind valueKind);
+    HRESULT EvaluateExpression(ICorDebugProcess *pProcess, FrameId frameId, const std::string &expression, Variable &variable,
+                               std::string &output, ICorDebugValue **ppResultValue);
+    HRESULT FillVariable(Variable &variable, FrameId frameId, ICorDebugValue *pValue, VariablesValues values);
 
     HRESULT GetStackVariables(
         FrameId frameId,
         ICorDebugThread *pThread,
         int start,
         int count,
-        std::vector<Variable> &variables);
+        std::vector<Variable> &variables,
+        VariablesValues values);
 
     HRESULT GetChildren(
         VariableReference &ref,
@@ -73,10 +73,14 @@ public:
     virtual void SetJustMyCode(bool enable) = 0;
     virtual bool IsStepFiltering() const = 0;
     virtual void SetStepFiltering(bool enable) = 0;
+    virtual void SetSymbolOptions(const SymbolOptions &options) = 0;
     virtual bool IsHotReload() const = 0;
     virtual HRESULT SetHotReload(bool enable) = 0;
+    virtual bool IsPropertiesHelper() const = 0;
+    virtual HRESULT SetPropertiesHelper(bool enable) = 0;
     virtual HRESULT Initialize() = 0;
     virtual HRESULT Attach(int pid) = 0;
+    virtual HRESULT OpenDump(const std::string &dumpPath) = 0;
     virtual HRESULT Launch(const std::string &fileExec, const std::vector<std::string> &execArgs, const std::map<std::string, std::string> &env,
         const std::string &cwd, bool stopAtEntry = false) = 0;
     virtual HRESULT ConfigurationDone() = 0;
@@ -93,10 +97,16 @@ public:
     virtual void EnumerateBreakpoints(std::function<bool (const BreakpointInfo&)>&& callback) = 0;
     virtual HRESULT AllBreakpointsActivate(bool act) = 0;
     virtual HRESULT GetStackTrace(ThreadId threadId, FrameLevel startFrame, unsigned maxFrames, std::vector<StackFrame> &stackFrames, int &totalFrames, bool hotReloadAwareCaller = false) = 0;
+    // Unwind stack and pass frames to callback one by one, unwind stopped as soon as callback return false.
+    virtual HRESULT WalkStackTrace(ThreadId threadId, FrameLevel startFrame, std::function<bool(const StackFrame&)> cb, bool hotReloadAwareCaller = false) = 0;
+    virtual HRESULT GetStackDepth(ThreadId threadId, int maxDepth, int &depth) = 0;
     virtual HRESULT StepCommand(ThreadId threadId, StepType stepType) = 0;
     virtual HRESULT GetScopes(FrameId frameId, std::vector<Scope> &scopes) = 0;
-    virtual HRESULT GetVariables(uint32_t variablesReference, VariablesFilter filter, int start, int count, std::vector<Variable> &variables) = 0;
+    virtual HRESULT GetVariables(uint32_t variablesReference, VariablesFilter filter, int start, int count, std::vector<Variable> &variables,
+                                 VariablesValues values = VariablesAllValues) = 0;
     virtual int GetNamedVariables(uint32_t variablesReference) = 0;
+    virtual HRESULT GetSnapshots(std::vector<Snapshot> &snapshots) = 0;
+    virtual void DeleteSnapshots() = 0;
     virtual HRESULT Evaluate(FrameId frameId, const std::string &expression, Variable &variable, std::string &output) = 0;
     virtual void CancelEvalRunning() = 0;
     virtual HRESULT SetVariable(const std::string &name, const std::string &value, uint32_t ref, std::string &output) = 0;
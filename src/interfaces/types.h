@@ -225,6 +225,27 @@ public:
     }
 };
 
+// Snapshot breakpoint settings. Breakpoint with enabled snapshot don't stop debuggee, but capture arguments and
+// local variables of `frames` top frames (with members expanded up to `depth` level) and continue execution.
+struct SnapshotSettings
+{
+    int frames;
+    int depth;
+
+    SnapshotSettings(int frames = 0, int depth = 0) : frames(frames), depth(depth) {}
+    bool IsEnabled() const { return frames > 0; }
+};
+
+// Breakpoint thread filter, checked on breakpoint hit before condition evaluation (no func-eval needed).
+// Breakpoint hit on thread that don't match filter is ignored and debuggee continue execution.
+struct ThreadFilter
+{
+    ThreadId threadId;          // OS thread id, same as used by protocols
+    std::string namePattern;    // thread name pattern, `*` and `?` wildcards allowed
+
+    bool IsEnabled() const { return threadId || !namePattern.empty(); }
+};
+
 struct Breakpoint
 {
     uint32_t id;
@@ -239,6 +260,8 @@ struct Breakpoint
     std::string module;
     std::string funcname;
     std::string params;
+    SnapshotSettings snapshot;
+    std::vector<std::string> commands;
 
     Breakpoint() : id(0), verified(false), line(0), endLine(0), hitCount(0) {}
 };
@@ -264,6 +287,13 @@ struct Module
     Module() : symbolStatus(SymbolsSkipped), baseAddress(0), size(0) {}
 };
 
+struct SymbolOptions
+{
+    std::vector<std::string> excludedModules; // modules names, `*` and `?` wildcards allowed
+    std::vector<std::string> searchPaths; // directories with PDB files, flat or symbol server (SSQP) layout
+    std::string cachePath; // symbols cache directory with index file of already found PDB files
+};
+
 enum BreakpointReason
 {
     BreakpointChanged,
@@ -413,18 +443,35 @@ enum VariablesFilter
     VariablesBoth
 };
 
+// Variables values print mode (see MI `--all-values`, `--no-values` and `--simple-values`).
+// In simple values mode only values of primitive types, enums, strings and null references are printed, for arrays,
+// structs and classes only type provided. Variables references are provided in all values mode only.
+enum VariablesValues
+{
+    VariablesAllValues,
+    VariablesNoValues,
+    VariablesSimpleValues
+};
+
 struct LineBreakpoint
 {
     std::string module;
     int line;
     std::string condition;
+    SnapshotSettings snapshot;
+    ThreadFilter thread;
+    // Dependent breakpoint, disabled until breakpoint with `triggerId` id hit (0 - not dependent breakpoint).
+    uint32_t triggerId;
+    // Commands executed by debugger at breakpoint hit (see ManagedDebugger::RunBreakpointCommands()).
+    std::vector<std::string> commands;
 
     LineBreakpoint(const std::string &module,
                    int linenum,
                    const std::string &cond = std::string()) :
         module(module),
         line(linenum),
-        condition(cond)
+        condition(cond),
+        triggerId(0)
     {}
 };
 
@@ -434,6 +481,12 @@ struct FuncBreakpoint
     std::string func;
     std::string params;
     std::string condition;
+    SnapshotSettings snapshot;
+    ThreadFilter thread;
+    // Dependent breakpoint, disabled until breakpoint with `triggerId` id hit (0 - not dependent breakpoint).
+    uint32_t triggerId;
+    // Commands executed by debugger at breakpoint hit (see ManagedDebugger::RunBreakpointCommands()).
+    std::vector<std::string> commands;
 
     FuncBreakpoint(const std::string &module,
                    const std::string &func,
@@ -442,10 +495,33 @@ struct FuncBreakpoint
         module(module),
         func(func),
         params(params),
-        condition(cond)
+        condition(cond),
+        triggerId(0)
     {}
 };
 
+struct SnapshotFrame
+{
+    std::string name;
+    Source source;
+    int line;
+    int column;
+    Scope scope; // scope's variablesReference valid until snapshot deleted (not affected by continue/step)
+
+    SnapshotFrame() : line(0), column(0) {}
+};
+
+// Data captured by snapshot breakpoint hit.
+struct Snapshot
+{
+    uint32_t id;
+    uint32_t breakpointId;
+    ThreadId threadId;
+    std::vector<SnapshotFrame> frames;
+
+    Snapshot() : id(0), breakpointId(0) {}
+};
+
 // Based on CorDebugExceptionCallbackType, but include info about JMC status in catch handler.
 // https://docs.microsoft.com/en-us/dotnet/framework/unmanaged-api/debugging/cordebugexceptioncallbacktype-enumeration
 enum class ExceptionCallbackType
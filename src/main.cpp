@@ -51,6 +51,7 @@ static void print_help()
         "Options:\n"
         "--buildinfo                           Print build info.\n"
         "--attach <process-id>                 Attach the debugger to the specified process id.\n"
+        "--core <dump-file>                    Open the core dump (created by createdump) for post-mortem debugging.\n"
         "--interpreter=cli                     Runs the debugger with Command Line Interface. \n"
         "--interpreter=mi                      Puts the debugger into MI mode.\n"
         "--interpreter=vscode                  Puts the debugger into VS Code Debugger mode.\n"
@@ -58,6 +59,7 @@ static void print_help()
         "-ex \"<command>\"                       Execute command at the start\n"
 #ifdef NCDB_DOTNET_STARTUP_HOOK
         "--hot-reload                          Enable Hot Reload feature.\n"
+        "--properties-helper                   Evaluate object properties by debuggee side helper.\n"
 #endif
         "--run                                 Run program without waiting commands\n"
         "--engineLogging[=<path to log file>]  Enable logging to VsDbg-UI or file for the engine.\n"
@@ -208,6 +210,14 @@ static HRESULT AttachToExistingProcess(IDebugger *pDebugger, DWORD pidDebuggee)
     return pDebugger->ConfigurationDone();
 }
 
+static HRESULT OpenDumpFile(IDebugger *pDebugger, const std::string &dumpPath)
+{
+    HRESULT Status;
+    IfFailRet(pDebugger->Initialize());
+    IfFailRet(pDebugger->OpenDump(dumpPath));
+    return pDebugger->ConfigurationDone();
+}
+
 static HRESULT LaunchNewProcess(IDebugger *pDebugger, std::string &execFile, std::vector<std::string> &execArgs)
 {
     HRESULT Status;
@@ -234,6 +244,7 @@ int
 {
 
     DWORD pidDebuggee = 0;
+    std::string dumpPath;
     // prevent std::cout flush triggered by read operation on std::cin
     std::cin.tie(nullptr);
 
@@ -256,6 +267,7 @@ int
     std::vector<std::string> execArgs;
 
     bool needHotReload = false;
+    bool needPropertiesHelper = false;
     bool run = false;
 
     std::unordered_map<std::string, std::function<void(int& i)>> entireArguments
@@ -276,6 +288,17 @@ int
                 exit(EXIT_FAILURE);
             }
 
+        } },
+        {"--core", [&](int& i){
+
+            i++;
+            if (i >= argc)
+            {
+                fprintf(stderr, "Error: Missing dump file\n");
+                exit(EXIT_FAILURE);
+            }
+            dumpPath = argv[i];
+
         } },
         { "--interpreter=mi", [&](int& i){
 
@@ -296,6 +319,11 @@ int
 
             needHotReload = true;
 
+        } },
+        { "--properties-helper", [&](int& i){
+
+            needPropertiesHelper = true;
+
         } },
         { "--run", [&](int& i){
 
@@ -468,6 +496,13 @@ int
         else
             fprintf(stderr, "Warning: Hot Reload can't be be enabled for attached process.\n");
     }
+    if (needPropertiesHelper)
+    {
+        if (pidDebuggee == 0)
+            debugger->SetPropertiesHelper(needPropertiesHelper);
+        else
+            fprintf(stderr, "Warning: Properties helper can't be be enabled for attached process.\n");
+    }
 
     if (!execFile.empty())
         protocol->SetLaunchCommand(execFile, execArgs);
@@ -480,6 +515,12 @@ int
         Interop::Shutdown();
         return EXIT_FAILURE;
     }
+    else if (!dumpPath.empty() && FAILED(Status = OpenDumpFile(debugger.get(), dumpPath)))
+    {
+        fprintf(stderr, "Error: 0x%x Failed to open dump %s\n", Status, dumpPath.c_str());
+        Interop::Shutdown();
+        return EXIT_FAILURE;
+    }
     else if (run && FAILED(Status = LaunchNewProcess(debugger.get(), execFile, execArgs)))
     {
         fprintf(stderr, "Error: %#x %s\n", Status, errormessage(Status));
@@ -3,6 +3,7 @@
 // See the LICENSE file in the project root for more information.
 
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Diagnostics;
 using System.IO;
@@ -12,6 +13,7 @@ using System.Reflection.Metadata.Ecma335;
 using System.Reflection.PortableExecutable;
 using System.Runtime.InteropServices;
 using System.Text;
+using System.Threading.Tasks;
 
 namespace NetCoreDbg
 {
@@ -54,6 +56,37 @@ namespace NetCoreDbg
             public IntPtr document;
         }
 
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct method_sequence_point_t
+        {
+            public int startLine;
+            public int startColumn;
+            public int endLine;
+            public int endColumn;
+            public int offset;
+            public int documentIndex; // document row number, see GetDocumentName()
+        }
+
+        /// <summary>
+        /// Write results into native code provided buffer. In case buffer capacity is not enough, nothing is written and
+        /// native code should repeat call with buffer for list.Count elements.
+        /// </summary>
+        /// <param name="list">results</param>
+        /// <param name="buffer">native buffer</param>
+        /// <param name="capacity">native buffer capacity in elements</param>
+        private static void WriteToBuffer<T>(List<T> list, IntPtr buffer, int capacity) where T : struct
+        {
+            if (list.Count > capacity)
+                return;
+
+            int structSize = Marshal.SizeOf<T>();
+            foreach (var p in list)
+            {
+                Marshal.StructureToPtr(p, buffer, false);
+                buffer = buffer + structSize;
+            }
+        }
+
         /// <summary>
         /// Read memory callback
         /// </summary>
@@ -209,6 +242,112 @@ namespace NetCoreDbg
             return IntPtr.Zero;
         }
 
+        // Additional PDB files locations, directories could have flat or SSQP (symbol server) layout.
+        private static string[] symbolSearchPaths = new string[0];
+        // Symbols index (SSQP key -> PDB file path) with already resolved PDB files locations, persisted in cache directory.
+        private static ConcurrentDictionary<string, string> symbolIndex = new ConcurrentDictionary<string, string>();
+        private static string symbolIndexFile = null;
+        private static readonly object symbolIndexFileLock = new object();
+        private const string SymbolIndexFileName = "netcoredbg-symbols.index";
+
+        /// <summary>
+        /// Set directories for PDB files search in case PDB not found next to the assembly.
+        /// Index file in cache directory is loaded here, before first module symbols probe, so, indexed PDB files are not searched again.
+        /// </summary>
+        /// <param name="searchPaths">directories separated by ';', with flat or SSQP layout</param>
+        /// <param name="cachePath">cache directory (also searched as SSQP store) or empty string</param>
+        /// <returns>Result code</returns>
+        internal static RetCode SetSymbolSearchPaths([MarshalAs(UnmanagedType.LPWStr)] string searchPaths, [MarshalAs(UnmanagedType.LPWStr)] string cachePath)
+        {
+            try
+            {
+                var paths = new List<string>(searchPaths.Split(new char[] { ';' }, StringSplitOptions.RemoveEmptyEntries));
+                symbolIndex = new ConcurrentDictionary<string, string>();
+                symbolIndexFile = null;
+                if (!string.IsNullOrEmpty(cachePath))
+                {
+                    paths.Add(cachePath);
+                    symbolIndexFile = Path.Combine(cachePath, SymbolIndexFileName);
+                    LoadSymbolIndex(symbolIndex, symbolIndexFile);
+                }
+                symbolSearchPaths = paths.ToArray();
+            }
+            catch
+            {
+                return RetCode.Exception;
+            }
+
+            return RetCode.OK;
+        }
+
+        private static void LoadSymbolIndex(ConcurrentDictionary<string, string> index, string indexFile)
+        {
+            try
+            {
+                if (!File.Exists(indexFile))
+                {
+                    return;
+                }
+                // Each line is `<SSQP key>\t<PDB file path>`, later lines override earlier.
+                string[] lines = File.ReadAllLines(indexFile);
+                foreach (string line in lines)
+                {
+                    int delimiter = line.IndexOf('\t');
+                    if (delimiter <= 0)
+                    {
+                        continue;
+                    }
+                    index[line.Substring(0, delimiter)] = line.Substring(delimiter + 1);
+                }
+                // Compact index file in case some entries were overridden.
+                if (index.Count != lines.Length)
+                {
+                    var sb = new StringBuilder();
+                    foreach (var entry in index)
+                    {
+                        sb.Append(entry.Key).Append('\t').Append(entry.Value).Append('\n');
+                    }
+                    lock (symbolIndexFileLock)
+                    {
+                        File.WriteAllText(indexFile, sb.ToString());
+                    }
+                }
+            }
+            catch
+            {
+            }
+        }
+
+        private static void AddSymbolIndexEntry(string key, string pdbPath)
+        {
+            string indexedPath;
+            if (symbolIndex.TryGetValue(key, out indexedPath) && indexedPath == pdbPath)
+            {
+                return;
+            }
+            symbolIndex[key] = pdbPath;
+            string indexFile = symbolIndexFile;
+            if (indexFile == null)
+            {
+                return;
+            }
+            // Don't block symbols load by cache write.
+            Task.Run(() =>
+            {
+                try
+                {
+                    lock (symbolIndexFileLock)
+                    {
+                        Directory.CreateDirectory(Path.GetDirectoryName(indexFile));
+                        File.AppendAllText(indexFile, key + "\t" + pdbPath + "\n");
+                    }
+                }
+                catch
+                {
+                }
+            });
+        }
+
         /// <summary>
         /// Maps global method token to a handle local to the current delta PDB. 
         /// Debug tables referring to methods currently use local handles, not global handles. 
@@ -396,15 +535,15 @@ namespace NetCoreDbg
         /// </summary>
         /// <param name="symbolReaderHandle">symbol reader handle returned by LoadSymbolsForModule</param>
         /// <param name="methodToken">method token</param>
-        /// <param name="points">result - array of sequence points</param>
-        /// <param name="pointsCount">result - count of elements in array of sequence points</param>
+        /// <param name="points">buffer for result - array of sequence points</param>
+        /// <param name="capacity">buffer capacity in elements</param>
+        /// <param name="pointsCount">result - count of sequence points (could be bigger than capacity, see WriteToBuffer())</param>
         /// <returns>"Ok" if information is available</returns>
-        private static RetCode GetSequencePoints(IntPtr symbolReaderHandle, int methodToken, out IntPtr points, out int pointsCount)
+        private static RetCode GetSequencePoints(IntPtr symbolReaderHandle, int methodToken, IntPtr points, int capacity, out int pointsCount)
         {
             Debug.Assert(symbolReaderHandle != IntPtr.Zero);
-            var list = new List<DbgSequencePoint>();
+            var list = new List<method_sequence_point_t>();
             pointsCount = 0;
-            points = IntPtr.Zero;
 
             try
             {
@@ -418,40 +557,83 @@ namespace NetCoreDbg
                     if (p.StartLine == 0 || p.StartLine == SequencePoint.HiddenLine)
                         continue;
 
-                    string fileName = reader.GetString(reader.GetDocument(p.Document).Name);
-                    list.Add(new DbgSequencePoint()
+                    list.Add(new method_sequence_point_t()
                     {
-                        document =  Marshal.StringToBSTR(fileName),
                         startLine = p.StartLine,
                         endLine = p.EndLine,
                         startColumn = p.StartColumn,
                         endColumn = p.EndColumn,
-                        offset = p.Offset
+                        offset = p.Offset,
+                        documentIndex = MetadataTokens.GetRowNumber(p.Document)
                     });
                 }
 
                 if (list.Count == 0)
                     return RetCode.Fail;
 
-                var structSize = Marshal.SizeOf<DbgSequencePoint>();
-                IntPtr allPoints = Marshal.AllocCoTaskMem(list.Count * structSize);
-                var currentPtr = allPoints;
+                WriteToBuffer(list, points, capacity);
+                pointsCount = list.Count;
+            }
+            catch
+            {
+                return RetCode.Exception;
+            }
 
-                foreach (var p in list)
-                {
-                    Marshal.StructureToPtr(p, currentPtr, false);
-                    currentPtr = currentPtr + structSize;
-                }
+            return RetCode.OK;
+        }
 
-                points = allPoints;
-                pointsCount = list.Count;
+        /// <summary>
+        /// Get document name by index, that was provided by GetSequencePoints() or GetModuleMethodsRanges().
+        /// </summary>
+        /// <param name="symbolReaderHandle">symbol reader handle returned by LoadSymbolsForModule</param>
+        /// <param name="documentIndex">document row number</param>
+        /// <param name="documentName">result - document name (BSTR)</param>
+        /// <returns>"Ok" if information is available</returns>
+        internal static RetCode GetDocumentName(IntPtr symbolReaderHandle, int documentIndex, out IntPtr documentName)
+        {
+            Debug.Assert(symbolReaderHandle != IntPtr.Zero);
+            documentName = IntPtr.Zero;
+
+            try
+            {
+                GCHandle gch = GCHandle.FromIntPtr(symbolReaderHandle);
+                MetadataReader reader = ((OpenedReader)gch.Target).Reader;
+
+                documentName = Marshal.StringToBSTR(reader.GetString(reader.GetDocument(MetadataTokens.DocumentHandle(documentIndex)).Name));
             }
             catch
             {
-                foreach (var p in list)
+                return RetCode.Exception;
+            }
+
+            return RetCode.OK;
+        }
+
+        /// <summary>
+        /// Get names of all documents in PDB, could be used for module sources check without sources indexing.
+        /// </summary>
+        /// <param name="symbolReaderHandle">symbol reader handle returned by LoadSymbolsForModule</param>
+        /// <param name="documentNames">result - documents names with '\n' after each name (BSTR)</param>
+        /// <returns>"Ok" if information is available</returns>
+        internal static RetCode GetDocumentNames(IntPtr symbolReaderHandle, out IntPtr documentNames)
+        {
+            Debug.Assert(symbolReaderHandle != IntPtr.Zero);
+            documentNames = IntPtr.Zero;
+
+            try
+            {
+                GCHandle gch = GCHandle.FromIntPtr(symbolReaderHandle);
+                MetadataReader reader = ((OpenedReader)gch.Target).Reader;
+
+                var names = new StringBuilder();
+                foreach (DocumentHandle handle in reader.Documents)
                 {
-                    Marshal.FreeBSTR(p.document);
+                    names.Append(reader.GetString(reader.GetDocument(handle).Name)).Append('\n');
                 }
+                documentNames = Marshal.StringToBSTR(names.ToString());
+            }
+            catch
+            {
                 return RetCode.Exception;
             }
 
@@ -552,16 +734,8 @@ namespace NetCoreDbg
         [StructLayout(LayoutKind.Sequential)]
         internal struct file_methods_data_t
         {
-            public IntPtr document;
-            public int methodNum;
-            public IntPtr methodsData; // method_data_t*
-        }
-
-        [StructLayout(LayoutKind.Sequential)]
-        internal struct module_methods_data_t
-        {
-            public int fileNum;
-            public IntPtr moduleMethodsData; // file_methods_data_t*
+            public int documentIndex; // document row number, see GetDocumentName()
+            public int methodNum; // file methods in methods data buffer, in files order
         }
 
         /// <summary>
@@ -572,14 +746,21 @@ namespace NetCoreDbg
         /// <param name="constrTokens">array of constructors tokens</param>
         /// <param name="normalNum">number of normal methods tokens in array</param>
         /// <param name="normalTokens">array of normal methods tokens</param>
-        /// <param name="data">pointer to memory with result</param>
+        /// <param name="filesData">buffer for result - array of file_methods_data_t</param>
+        /// <param name="filesCapacity">files buffer capacity in elements</param>
+        /// <param name="filesCount">result - count of files</param>
+        /// <param name="methodsData">buffer for result - array of method_data_t for all files</param>
+        /// <param name="methodsCapacity">methods buffer capacity in elements</param>
+        /// <param name="methodsCount">result - count of methods data for all files</param>
         /// <returns>"Ok" if information is available</returns>
-        internal static RetCode GetModuleMethodsRanges(IntPtr symbolReaderHandle, uint constrNum, IntPtr constrTokens, uint normalNum, IntPtr normalTokens, out IntPtr data)
+        /// <remarks>Buffers are written only in case both have enough capacity, see WriteToBuffer().</remarks>
+        internal static RetCode GetModuleMethodsRanges(IntPtr symbolReaderHandle, uint constrNum, IntPtr constrTokens, uint normalNum, IntPtr normalTokens,
+                                                       IntPtr filesData, int filesCapacity, out int filesCount,
+                                                       IntPtr methodsData, int methodsCapacity, out int methodsCount)
         {
             Debug.Assert(symbolReaderHandle != IntPtr.Zero);
-            data = IntPtr.Zero;
-            var unmanagedPTRList = new List<IntPtr>();
-            var unmanagedBSTRList = new List<IntPtr>();
+            filesCount = 0;
+            methodsCount = 0;
 
             try
             {
@@ -639,51 +820,27 @@ namespace NetCoreDbg
                     }
                 }
 
-                if (ModuleData.Count == 0)
-                    return RetCode.OK;
-
-                int structModuleMethodsDataSize = Marshal.SizeOf<file_methods_data_t>();
-                module_methods_data_t managedData;
-                managedData.fileNum = ModuleData.Count;
-                managedData.moduleMethodsData = Marshal.AllocCoTaskMem(ModuleData.Count * structModuleMethodsDataSize);
-                unmanagedPTRList.Add(managedData.moduleMethodsData);
-                IntPtr currentModuleMethodsDataPtr = managedData.moduleMethodsData;
-
+                var filesList = new List<file_methods_data_t>(ModuleData.Count);
+                var methodsList = new List<method_data_t>();
                 foreach (KeyValuePair<DocumentHandle, List<method_data_t>> fileData in ModuleData)
                 {
-                    int structMethodDataSize = Marshal.SizeOf<method_data_t>();
                     file_methods_data_t fileMethodData;
-                    fileMethodData.document = Marshal.StringToBSTR(reader.GetString(reader.GetDocument(fileData.Key).Name));
-                    unmanagedBSTRList.Add(fileMethodData.document);
+                    fileMethodData.documentIndex = MetadataTokens.GetRowNumber(fileData.Key);
                     fileMethodData.methodNum = fileData.Value.Count;
-                    fileMethodData.methodsData = Marshal.AllocCoTaskMem(fileData.Value.Count * structMethodDataSize);
-                    unmanagedPTRList.Add(fileMethodData.methodsData);
-                    IntPtr currentMethodDataPtr = fileMethodData.methodsData;
-
-                    foreach (var p in fileData.Value)
-                    {
-                        Marshal.StructureToPtr(p, currentMethodDataPtr, false);
-                        currentMethodDataPtr = currentMethodDataPtr + structMethodDataSize;
-                    }
+                    filesList.Add(fileMethodData);
+                    methodsList.AddRange(fileData.Value);
+                }
 
-                    Marshal.StructureToPtr(fileMethodData, currentModuleMethodsDataPtr, false);
-                    currentModuleMethodsDataPtr = currentModuleMethodsDataPtr + structModuleMethodsDataSize;
+                if (filesList.Count <= filesCapacity && methodsList.Count <= methodsCapacity)
+                {
+                    WriteToBuffer(filesList, filesData, filesCapacity);
+                    WriteToBuffer(methodsList, methodsData, methodsCapacity);
                 }
-            
-                data = Marshal.AllocCoTaskMem(Marshal.SizeOf<module_methods_data_t>());
-                unmanagedPTRList.Add(data);
-                Marshal.StructureToPtr(managedData, data, false);
+                filesCount = filesList.Count;
+                methodsCount = methodsList.Count;
             }
             catch
             {
-                foreach (var p in unmanagedPTRList)
-                {
-                    Marshal.FreeCoTaskMem(p);
-                }
-                foreach (var p in unmanagedBSTRList)
-                {
-                    Marshal.FreeBSTR(p);
-                }
                 return RetCode.Exception;
             }
 
@@ -719,15 +876,16 @@ namespace NetCoreDbg
         /// <param name="Tokens">array of method tokens, that have sequence point with sourceLine</param>
         /// <param name="sourceLine">initial source line for resolve</param>
         /// <param name="nestedToken">close nested token for sourceLine</param>
-        /// <param name="Count">entry's count in data</param>
-        /// <param name="data">pointer to memory with result</param>
+        /// <param name="sourcePath">source full path</param>
+        /// <param name="data">buffer for result - array of resolved_bp_t</param>
+        /// <param name="capacity">buffer capacity in elements</param>
+        /// <param name="Count">result - entry's count (could be bigger than capacity, see WriteToBuffer())</param>
         /// <returns>"Ok" if information is available</returns>
         internal static RetCode ResolveBreakPoints(IntPtr symbolReaderHandles, int tokenNum, IntPtr Tokens, int sourceLine, int nestedToken,
-                                                   out int Count, [MarshalAs(UnmanagedType.LPWStr)] string sourcePath, out IntPtr data)
+                                                   [MarshalAs(UnmanagedType.LPWStr)] string sourcePath, IntPtr data, int capacity, out int Count)
         {
             Debug.Assert(symbolReaderHandles != IntPtr.Zero);
             Count = 0;
-            data = IntPtr.Zero;
             var list = new List<resolved_bp_t>();
 
             try
@@ -832,27 +990,11 @@ namespace NetCoreDbg
                     list.Add(new resolved_bp_t(current_p.StartLine, current_p.EndLine, current_p.Offset, methodToken));
                 }
 
-                if (list.Count == 0)
-                    return RetCode.OK;
-
-                int structSize = Marshal.SizeOf<resolved_bp_t>();
-                data = Marshal.AllocCoTaskMem(list.Count * structSize);
-                IntPtr dataPtr = data;
-
-                foreach (var p in list)
-                {
-                    Marshal.StructureToPtr(p, dataPtr, false);
-                    dataPtr = dataPtr + structSize;
-                }
-
+                WriteToBuffer(list, data, capacity);
                 Count = list.Count;
             }
             catch
             {
-                if (data != IntPtr.Zero)
-                    Marshal.FreeCoTaskMem(data);
-
-                data = IntPtr.Zero;
                 return RetCode.Exception;
             }
 
@@ -990,12 +1132,12 @@ namespace NetCoreDbg
         /// </summary>
         /// <param name="symbolReaderHandle">symbol reader handle returned by LoadSymbolsForModule</param>
         /// <param name="methodToken">method token</param>
-        /// <param name="data">pointer to memory with histed local scopes</param>
-        /// <param name="hoistedLocalScopesCount">histed local scopes count</param>
+        /// <param name="data">buffer for result - histed local scopes (StartOffset and Length pairs)</param>
+        /// <param name="capacity">buffer capacity in scopes</param>
+        /// <param name="hoistedLocalScopesCount">histed local scopes count (could be bigger than capacity, see WriteToBuffer())</param>
         /// <returns>"Ok" if information is available</returns>
-        internal static RetCode GetHoistedLocalScopes(IntPtr symbolReaderHandle, int methodToken, out IntPtr data, out int hoistedLocalScopesCount)
+        internal static RetCode GetHoistedLocalScopes(IntPtr symbolReaderHandle, int methodToken, IntPtr data, int capacity, out int hoistedLocalScopesCount)
         {
-            data = IntPtr.Zero;
             hoistedLocalScopesCount = 0;
 
             try
@@ -1037,20 +1179,12 @@ namespace NetCoreDbg
                 if (HoistedLocalScopes.Count == 0)
                     return RetCode.Fail;
 
-                data = Marshal.AllocCoTaskMem(HoistedLocalScopes.Count * 4);
-                IntPtr dataPtr = data;
-                foreach (var p in HoistedLocalScopes)
-                {
-                    Marshal.StructureToPtr(p, dataPtr, false);
-                    dataPtr = dataPtr + 4;
-                }
+                // Each scope is StartOffset + Length pair.
+                WriteToBuffer(HoistedLocalScopes, data, capacity * 2);
                 hoistedLocalScopesCount = HoistedLocalScopes.Count / 2;
             }
             catch
             {
-                if (data != IntPtr.Zero)
-                    Marshal.FreeCoTaskMem(data);
-
                 return RetCode.Exception;
             }
 
@@ -1282,17 +1416,12 @@ namespace NetCoreDbg
                 }
 
                 var pdbStream = TryOpenFile(pdbPath);
-                if (pdbStream == null && assemblyPath != null)
+                int tmpLastIndex = assemblyPath != null ? assemblyPath.LastIndexOf(".native_image") : -1;
+                if (pdbStream == null && tmpLastIndex != -1)
                 {
                     // workaround, since NI file could be generated in `.native_image` subdirectory
-                    // NOTE this is temporary solution until we add option for specifying pdb path
                     try
                     {
-                        int tmpLastIndex = assemblyPath.LastIndexOf(".native_image");
-                        if (tmpLastIndex == -1)
-                        {
-                            return null;
-                        }
                         string tmpPath = assemblyPath.Substring(0, tmpLastIndex);
                         pdbPath = Path.Combine(Path.GetDirectoryName(tmpPath), GetFileName(pdbPath));
                     }
@@ -1304,9 +1433,14 @@ namespace NetCoreDbg
 
                     pdbStream = TryOpenFile(pdbPath);
                 }
+                string symbolKey = null;
                 if (pdbStream == null)
                 {
-                    return null;
+                    pdbStream = TryOpenFromSearchPaths(GetFileName(data.Path), data.Guid, out symbolKey, ref pdbPath);
+                    if (pdbStream == null)
+                    {
+                        return null;
+                    }
                 }
 
                 provider = MetadataReaderProvider.FromPortablePdbStream(pdbStream);
@@ -1316,6 +1450,10 @@ namespace NetCoreDbg
                 if (data.Age == 1 && new BlobContentId(reader.DebugMetadataHeader.Id) == new BlobContentId(data.Guid, codeViewEntry.Stamp))
                 {
                     result = new OpenedReader(provider, reader);
+                    if (symbolKey != null)
+                    {
+                        AddSymbolIndexEntry(symbolKey, pdbPath);
+                    }
                 }
             }
             catch (Exception e) when (e is BadImageFormatException || e is IOException)
@@ -1360,6 +1498,60 @@ namespace NetCoreDbg
             return result;
         }
 
+        /// <summary>
+        /// Find PDB file in symbols index or search paths.
+        /// </summary>
+        /// <param name="pdbName">PDB file name from CodeView entry</param>
+        /// <param name="pdbGuid">PDB id from CodeView entry</param>
+        /// <param name="symbolKey">SSQP key for index update in case PDB file was found by search paths probing, or null</param>
+        /// <param name="pdbPath">found PDB file path</param>
+        /// <returns>PDB file stream or null</returns>
+        private static Stream TryOpenFromSearchPaths(string pdbName, Guid pdbGuid, out string symbolKey, ref string pdbPath)
+        {
+            symbolKey = null;
+            string[] searchPaths = symbolSearchPaths;
+            if (searchPaths.Length == 0 || string.IsNullOrEmpty(pdbName))
+            {
+                return null;
+            }
+
+            // SSQP key for portable PDB: `<file name>/<guid>FFFFFFFF/<file name>`, all lowercase.
+            string lowerName = pdbName.ToLowerInvariant();
+            string key = lowerName + "/" + pdbGuid.ToString("N") + "FFFFFFFF/" + lowerName;
+
+            string indexedPath;
+            Stream stream;
+            if (symbolIndex.TryGetValue(key, out indexedPath) && (stream = TryOpenFile(indexedPath)) != null)
+            {
+                pdbPath = indexedPath;
+                return stream;
+            }
+
+            foreach (string searchPath in searchPaths)
+            {
+                try
+                {
+                    foreach (string path in new string[] { Path.Combine(searchPath, key.Replace('/', Path.DirectorySeparatorChar)),
+                                                           Path.Combine(searchPath, pdbName) })
+                    {
+                        stream = TryOpenFile(path);
+                        if (stream != null)
+                        {
+                            symbolKey = key;
+                            pdbPath = path;
+                            return stream;
+                        }
+                    }
+                }
+                catch
+                {
+                    // invalid characters in search path
+                }
+            }
+
+            return null;
+        }
+
         private static Stream TryOpenFile(string path)
         {
             if (!File.Exists(path))
@@ -9,6 +9,7 @@
 #include <coreclrhost.h>
 #include <thread>
 #include <string>
+#include <algorithm>
 
 #include "palclr.h"
 #include "utils/platform.h"
@@ -59,16 +60,19 @@ typedef  int (*ReadMemoryDelegate)(uint64_t, char*, int32_t);
 typedef  PVOID (*LoadSymbolsForModuleDelegate)(const WCHAR*, BOOL, uint64_t, int32_t, uint64_t, int32_t, ReadMemoryDelegate);
 typedef  void (*DisposeDelegate)(PVOID);
 typedef  RetCode (*GetLocalVariableNameAndScope)(PVOID, int32_t, int32_t, BSTR*, uint32_t*, uint32_t*);
-typedef  RetCode (*GetHoistedLocalScopes)(PVOID, int32_t, PVOID*, int32_t*);
+typedef  RetCode (*GetHoistedLocalScopes)(PVOID, int32_t, PVOID, int32_t, int32_t*);
 typedef  RetCode (*GetSequencePointByILOffsetDelegate)(PVOID, mdMethodDef, uint32_t, PVOID);
-typedef  RetCode (*GetSequencePointsDelegate)(PVOID, mdMethodDef, PVOID*, int32_t*);
+typedef  RetCode (*GetSequencePointsDelegate)(PVOID, mdMethodDef, PVOID, int32_t, int32_t*);
+typedef  RetCode (*GetDocumentNameDelegate)(PVOID, int32_t, BSTR*);
+typedef  RetCode (*GetDocumentNamesDelegate)(PVOID, BSTR*);
 typedef  RetCode (*GetNextUserCodeILOffsetDelegate)(PVOID, mdMethodDef, uint32_t, uint32_t*, int32_t*);
 typedef  RetCode (*GetStepRangesFromIPDelegate)(PVOID, int32_t, mdMethodDef, uint32_t*, uint32_t*);
-typedef  RetCode (*GetModuleMethodsRangesDelegate)(PVOID, uint32_t, PVOID, uint32_t, PVOID, PVOID*);
-typedef  RetCode (*ResolveBreakPointsDelegate)(PVOID[], int32_t, PVOID, int32_t, int32_t, int32_t*, const WCHAR*, PVOID*);
+typedef  RetCode (*GetModuleMethodsRangesDelegate)(PVOID, uint32_t, PVOID, uint32_t, PVOID, PVOID, int32_t, int32_t*, PVOID, int32_t, int32_t*);
+typedef  RetCode (*ResolveBreakPointsDelegate)(PVOID[], int32_t, PVOID, int32_t, int32_t, const WCHAR*, PVOID, int32_t, int32_t*);
 typedef  RetCode (*GetAsyncMethodSteppingInfoDelegate)(PVOID, mdMethodDef, PVOID*, int32_t*, uint32_t*);
 typedef  RetCode (*GetSourceDelegate)(PVOID, const WCHAR*, int32_t*, PVOID*);
 typedef  PVOID (*LoadDeltaPdbDelegate)(const WCHAR*, PVOID*, int32_t*);
+typedef  RetCode (*SetSymbolSearchPathsDelegate)(const WCHAR*, const WCHAR*);
 typedef  RetCode (*CalculationDelegate)(PVOID, int32_t, PVOID, int32_t, int32_t, int32_t*, PVOID*, BSTR*);
 typedef  int (*GenerateStackMachineProgramDelegate)(const WCHAR*, PVOID*, BSTR*);
 typedef  void (*ReleaseStackMachineProgramDelegate)(PVOID);
@@ -85,6 +89,8 @@ GetLocalVariableNameAndScope getLocalVariableNameAndScopeDelegate = nullptr;
 GetHoistedLocalScopes getHoistedLocalScopesDelegate = nullptr;
 GetSequencePointByILOffsetDelegate getSequencePointByILOffsetDelegate = nullptr;
 GetSequencePointsDelegate getSequencePointsDelegate = nullptr;
+GetDocumentNameDelegate getDocumentNameDelegate = nullptr;
+GetDocumentNamesDelegate getDocumentNamesDelegate = nullptr;
 GetNextUserCodeILOffsetDelegate getNextUserCodeILOffsetDelegate = nullptr;
 GetStepRangesFromIPDelegate getStepRangesFromIPDelegate = nullptr;
 GetModuleMethodsRangesDelegate getModuleMethodsRangesDelegate = nullptr;
@@ -92,6 +98,7 @@ ResolveBreakPointsDelegate resolveBreakPointsDelegate = nullptr;
 GetAsyncMethodSteppingInfoDelegate getAsyncMethodSteppingInfoDelegate = nullptr;
 GetSourceDelegate getSourceDelegate = nullptr;
 LoadDeltaPdbDelegate loadDeltaPdbDelegate = nullptr;
+SetSymbolSearchPathsDelegate setSymbolSearchPathsDelegate = nullptr;
 GenerateStackMachineProgramDelegate generateStackMachineProgramDelegate = nullptr;
 ReleaseStackMachineProgramDelegate releaseStackMachineProgramDelegate = nullptr;
 NextStackCommandDelegate nextStackCommandDelegate = nullptr;
@@ -142,6 +149,24 @@ HRESULT LoadSymbolsForPortablePDB(const std::string &modulePath, BOOL isInMemory
     return S_OK;
 }
 
+HRESULT SetSymbolSearchPaths(const std::vector<std::string> &searchPaths, const std::string &cachePath)
+{
+    std::string paths;
+    for (const auto &path : searchPaths)
+    {
+        if (!paths.empty())
+            paths += ';';
+        paths += path;
+    }
+
+    std::unique_lock<Utility::RWLock::Reader> read_lock(CLRrwlock.reader);
+    if (!setSymbolSearchPathsDelegate)
+        return E_FAIL;
+
+    RetCode retCode = setSymbolSearchPathsDelegate(to_utf16(paths).c_str(), to_utf16(cachePath).c_str());
+    return retCode == RetCode::OK ? S_OK : E_FAIL;
+}
+
 SequencePoint::~SequencePoint() noexcept
 {
     Interop::SysFreeString(document);
@@ -230,6 +255,8 @@ void Init(const std::string &coreClrPath)
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "GetHoistedLocalScopes", (void **)&getHoistedLocalScopesDelegate)) &&
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "GetSequencePointByILOffset", (void **)&getSequencePointByILOffsetDelegate)) &&
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "GetSequencePoints", (void **)&getSequencePointsDelegate)) &&
+        SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "GetDocumentName", (void **)&getDocumentNameDelegate)) &&
+        SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "GetDocumentNames", (void **)&getDocumentNamesDelegate)) &&
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "GetNextUserCodeILOffset", (void **)&getNextUserCodeILOffsetDelegate)) &&
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "GetStepRangesFromIP", (void **)&getStepRangesFromIPDelegate)) &&
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "GetModuleMethodsRanges", (void **)&getModuleMethodsRangesDelegate)) &&
@@ -237,6 +264,7 @@ void Init(const std::string &coreClrPath)
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "GetAsyncMethodSteppingInfo", (void **)&getAsyncMethodSteppingInfoDelegate)) &&
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "GetSource", (void **)&getSourceDelegate)) &&
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "LoadDeltaPdb", (void **)&loadDeltaPdbDelegate)) &&
+        SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, SymbolReaderClassName, "SetSymbolSearchPaths", (void **)&setSymbolSearchPathsDelegate)) &&
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, EvaluationClassName, "CalculationDelegate", (void **)&calculationDelegate)) &&
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, EvaluationClassName, "GenerateStackMachineProgram", (void **)&generateStackMachineProgramDelegate)) &&
         SUCCEEDED(Status = createDelegate(hostHandle, domainId, ManagedPartDllName, EvaluationClassName, "ReleaseStackMachineProgram", (void **)&releaseStackMachineProgramDelegate)) &&
@@ -256,6 +284,8 @@ void Init(const std::string &coreClrPath)
                               getHoistedLocalScopesDelegate &&
                               getSequencePointByILOffsetDelegate &&
                               getSequencePointsDelegate &&
+                              getDocumentNameDelegate &&
+                              getDocumentNamesDelegate &&
                               getNextUserCodeILOffsetDelegate &&
                               getStepRangesFromIPDelegate &&
                               getModuleMethodsRangesDelegate &&
@@ -263,6 +293,7 @@ void Init(const std::string &coreClrPath)
                               getAsyncMethodSteppingInfoDelegate &&
                               getSourceDelegate &&
                               loadDeltaPdbDelegate &&
+                              setSymbolSearchPathsDelegate &&
                               generateStackMachineProgramDelegate &&
                               releaseStackMachineProgramDelegate &&
                               nextStackCommandDelegate &&
@@ -296,6 +327,8 @@ void Shutdown()
     getHoistedLocalScopesDelegate = nullptr;
     getSequencePointByILOffsetDelegate = nullptr;
     getSequencePointsDelegate = nullptr;
+    getDocumentNameDelegate = nullptr;
+    getDocumentNamesDelegate = nullptr;
     getNextUserCodeILOffsetDelegate = nullptr;
     getStepRangesFromIPDelegate = nullptr;
     getModuleMethodsRangesDelegate = nullptr;
@@ -303,6 +336,7 @@ void Shutdown()
     getAsyncMethodSteppingInfoDelegate = nullptr;
     getSourceDelegate = nullptr;
     loadDeltaPdbDelegate = nullptr;
+    setSymbolSearchPathsDelegate = nullptr;
     stringToUpperDelegate = nullptr;
     coTaskMemAllocDelegate = nullptr;
     coTaskMemFreeDelegate = nullptr;
@@ -323,17 +357,82 @@ HRESULT GetSequencePointByILOffset(PVOID pSymbolReaderHandle, mdMethodDef method
     return retCode == RetCode::OK ? S_OK : E_FAIL;
 }
 
-HRESULT GetSequencePoints(PVOID pSymbolReaderHandle, mdMethodDef methodToken, SequencePoint **sequencePoints, int32_t &Count)
+// Call managed part with vector's memory as result buffer. Managed part write result only in case buffer have enough
+// capacity and always return required elements count, so, in the worst case we need second call with resized buffer.
+template <typename T, typename Func>
+static RetCode CallWithBuffer(std::vector<T> &buffer, Func func)
+{
+    int32_t count = 0;
+    buffer.resize(buffer.capacity());
+    RetCode retCode = func(buffer.data(), (int32_t)buffer.size(), &count);
+    if (retCode == RetCode::OK && count > (int32_t)buffer.size())
+    {
+        buffer.resize(count);
+        retCode = func(buffer.data(), (int32_t)buffer.size(), &count);
+    }
+
+    buffer.resize(retCode == RetCode::OK ? std::min((size_t)count, buffer.size()) : 0);
+    return retCode;
+}
+
+HRESULT GetSequencePoints(PVOID pSymbolReaderHandle, mdMethodDef methodToken, std::vector<MethodSequencePoint> &sequencePoints)
 {
     std::unique_lock<Utility::RWLock::Reader> read_lock(CLRrwlock.reader);
     if (!getSequencePointsDelegate || !pSymbolReaderHandle)
         return E_FAIL;
 
-    RetCode retCode = getSequencePointsDelegate(pSymbolReaderHandle, methodToken, (PVOID*)sequencePoints, &Count);
+    RetCode retCode = CallWithBuffer(sequencePoints, [&](MethodSequencePoint *data, int32_t capacity, int32_t *count)
+    {
+        return getSequencePointsDelegate(pSymbolReaderHandle, methodToken, data, capacity, count);
+    });
 
     return retCode == RetCode::OK ? S_OK : E_FAIL;
 }
 
+HRESULT GetDocumentName(PVOID pSymbolReaderHandle, int32_t documentIndex, std::string &documentName)
+{
+    std::unique_lock<Utility::RWLock::Reader> read_lock(CLRrwlock.reader);
+    if (!getDocumentNameDelegate || !pSymbolReaderHandle)
+        return E_FAIL;
+
+    BSTR bstrDocumentName = nullptr;
+    RetCode retCode = getDocumentNameDelegate(pSymbolReaderHandle, documentIndex, &bstrDocumentName);
+    read_lock.unlock();
+
+    if (retCode != RetCode::OK)
+        return E_FAIL;
+
+    documentName = to_utf8(bstrDocumentName);
+    Interop::SysFreeString(bstrDocumentName);
+    return S_OK;
+}
+
+HRESULT GetDocumentNames(PVOID pSymbolReaderHandle, std::vector<std::string> &documentNames)
+{
+    std::unique_lock<Utility::RWLock::Reader> read_lock(CLRrwlock.reader);
+    if (!getDocumentNamesDelegate || !pSymbolReaderHandle)
+        return E_FAIL;
+
+    BSTR bstrDocumentNames = nullptr;
+    RetCode retCode = getDocumentNamesDelegate(pSymbolReaderHandle, &bstrDocumentNames);
+    read_lock.unlock();
+
+    if (retCode != RetCode::OK)
+        return E_FAIL;
+
+    // All names are provided by one string with '\n' after each name, in order to avoid managed call for each document.
+    std::string names = to_utf8(bstrDocumentNames);
+    Interop::SysFreeString(bstrDocumentNames);
+
+    documentNames.clear();
+    size_t start = 0;
+    for (size_t end = names.find('\n'); end != std::string::npos; start = end + 1, end = names.find('\n', start))
+    {
+        documentNames.emplace_back(names, start, end - start);
+    }
+    return S_OK;
+}
+
 HRESULT GetNextUserCodeILOffset(PVOID pSymbolReaderHandle, mdMethodDef methodToken, ULONG32 ilOffset, ULONG32 &ilNextOffset, bool *noUserCodeFound)
 {
     std::unique_lock<Utility::RWLock::Reader> read_lock(CLRrwlock.reader);
@@ -387,13 +486,16 @@ HRESULT GetNamedLocalVariableAndScope(PVOID pSymbolReaderHandle, mdMethodDef met
     return S_OK;
 }
 
-HRESULT GetHoistedLocalScopes(PVOID pSymbolReaderHandle, mdMethodDef methodToken, PVOID *data, int32_t &hoistedLocalScopesCount)
+HRESULT GetHoistedLocalScopes(PVOID pSymbolReaderHandle, mdMethodDef methodToken, std::vector<HoistedLocalScope> &hoistedLocalScopes)
 {
     std::unique_lock<Utility::RWLock::Reader> read_lock(CLRrwlock.reader);
     if (!getHoistedLocalScopesDelegate || !pSymbolReaderHandle)
         return E_FAIL;
 
-    RetCode retCode = getHoistedLocalScopesDelegate(pSymbolReaderHandle, methodToken, data, &hoistedLocalScopesCount);
+    RetCode retCode = CallWithBuffer(hoistedLocalScopes, [&](HoistedLocalScope *data, int32_t capacity, int32_t *count)
+    {
+        return getHoistedLocalScopesDelegate(pSymbolReaderHandle, methodToken, data, capacity, count);
+    });
     return retCode == RetCode::OK ? S_OK : E_FAIL;
 }
 
@@ -417,23 +519,50 @@ HRESULT CalculationDelegate(PVOID firstOp, int32_t firstType, PVOID secondOp, in
     return S_OK;
 }
 
-HRESULT GetModuleMethodsRanges(PVOID pSymbolReaderHandle, uint32_t constrTokensNum, PVOID constrTokens, uint32_t normalTokensNum, PVOID normalTokens, PVOID *data)
+HRESULT GetModuleMethodsRanges(PVOID pSymbolReaderHandle, uint32_t constrTokensNum, PVOID constrTokens, uint32_t normalTokensNum, PVOID normalTokens,
+                               std::vector<FileMethodsData> &filesData, std::vector<method_data_t> &methodsData)
 {
     std::unique_lock<Utility::RWLock::Reader> read_lock(CLRrwlock.reader);
-    if (!getModuleMethodsRangesDelegate || !pSymbolReaderHandle || (constrTokensNum && !constrTokens) || (normalTokensNum && !normalTokens) || !data)
+    if (!getModuleMethodsRangesDelegate || !pSymbolReaderHandle || (constrTokensNum && !constrTokens) || (normalTokensNum && !normalTokens))
         return E_FAIL;
 
-    RetCode retCode = getModuleMethodsRangesDelegate(pSymbolReaderHandle, constrTokensNum, constrTokens, normalTokensNum, normalTokens, data);
+    // Managed part write both buffers only in case both have enough capacity, see CallWithBuffer() for single buffer logic.
+    int32_t filesCount = 0;
+    int32_t methodsCount = 0;
+    auto getRanges = [&]()
+    {
+        return getModuleMethodsRangesDelegate(pSymbolReaderHandle, constrTokensNum, constrTokens, normalTokensNum, normalTokens,
+                                              filesData.data(), (int32_t)filesData.size(), &filesCount,
+                                              methodsData.data(), (int32_t)methodsData.size(), &methodsCount);
+    };
+
+    filesData.resize(filesData.capacity());
+    methodsData.resize(methodsData.capacity());
+    RetCode retCode = getRanges();
+    if (retCode == RetCode::OK && (filesCount > (int32_t)filesData.size() || methodsCount > (int32_t)methodsData.size()))
+    {
+        filesData.resize(std::max((size_t)filesCount, filesData.size()));
+        methodsData.resize(std::max((size_t)methodsCount, methodsData.size()));
+        retCode = getRanges();
+    }
+
+    filesData.resize(retCode == RetCode::OK ? filesCount : 0);
+    methodsData.resize(retCode == RetCode::OK ? methodsCount : 0);
     return retCode == RetCode::OK ? S_OK : E_FAIL;
 }
 
-HRESULT ResolveBreakPoints(PVOID pSymbolReaderHandles[], int32_t tokenNum, PVOID Tokens, int32_t sourceLine, int32_t nestedToken, int32_t &Count, const std::string &sourcePath, PVOID *data)
+HRESULT ResolveBreakPoints(PVOID pSymbolReaderHandles[], int32_t tokenNum, PVOID Tokens, int32_t sourceLine, int32_t nestedToken,
+                           const std::string &sourcePath, std::vector<ResolvedBreakpoint> &resolvedBreakpoints)
 {
     std::unique_lock<Utility::RWLock::Reader> read_lock(CLRrwlock.reader);
-    if (!resolveBreakPointsDelegate || !pSymbolReaderHandles || !Tokens || !data)
+    if (!resolveBreakPointsDelegate || !pSymbolReaderHandles || !Tokens)
         return E_FAIL;
 
-    RetCode retCode = resolveBreakPointsDelegate(pSymbolReaderHandles, tokenNum, Tokens, sourceLine, nestedToken, &Count, to_utf16(sourcePath).c_str(), data);
+    const WSTRING wSourcePath = to_utf16(sourcePath);
+    RetCode retCode = CallWithBuffer(resolvedBreakpoints, [&](ResolvedBreakpoint *data, int32_t capacity, int32_t *count)
+    {
+        return resolveBreakPointsDelegate(pSymbolReaderHandles, tokenNum, Tokens, sourceLine, nestedToken, wSourcePath.c_str(), data, capacity, count);
+    });
     return retCode == RetCode::OK ? S_OK : E_FAIL;
 }
 
@@ -18,6 +18,8 @@
 namespace netcoredbg
 {
 
+struct method_data_t;
+
 namespace Interop
 {
     // 0xfeefee is a magic number for "#line hidden" directive.
@@ -67,6 +69,37 @@ namespace Interop
         }
     };
 
+    // Sequence point without document name, document could be get by index with GetDocumentName().
+    struct MethodSequencePoint
+    {
+        int32_t startLine;
+        int32_t startColumn;
+        int32_t endLine;
+        int32_t endColumn;
+        int32_t offset;
+        int32_t documentIndex;
+    };
+
+    struct FileMethodsData
+    {
+        int32_t documentIndex;
+        int32_t methodNum; // file's methods count in methods data, files methods are stored in files order
+    };
+
+    struct ResolvedBreakpoint
+    {
+        int32_t startLine;
+        int32_t endLine;
+        uint32_t ilOffset;
+        uint32_t methodToken;
+    };
+
+    struct HoistedLocalScope
+    {
+        uint32_t startOffset;
+        uint32_t length;
+    };
+
     struct AsyncAwaitInfoBlock
     {
         uint32_t yield_offset;
@@ -84,18 +117,26 @@ namespace Interop
     // WARNING! Due to CoreCLR limitations, Shutdown() can't be called out of the Main() scope, for example, from global object destructor.
     void Shutdown();
 
+    // Search paths and cache directory are used for PDB files probing in case PDB not found next to the assembly.
+    HRESULT SetSymbolSearchPaths(const std::vector<std::string> &searchPaths, const std::string &cachePath);
     HRESULT LoadSymbolsForPortablePDB(const std::string &modulePath, BOOL isInMemory, BOOL isFileLayout, ULONG64 peAddress, ULONG64 peSize,
                                       ULONG64 inMemoryPdbAddress, ULONG64 inMemoryPdbSize, VOID **ppSymbolReaderHandle);
     void DisposeSymbols(PVOID pSymbolReaderHandle);
     HRESULT GetSequencePointByILOffset(PVOID pSymbolReaderHandle, mdMethodDef MethodToken, ULONG32 IlOffset, SequencePoint *sequencePoint);
-    HRESULT GetSequencePoints(PVOID pSymbolReaderHandle, mdMethodDef MethodToken, SequencePoint **sequencePoints, int32_t &Count);
+    // Note, functions below with vector argument use it as buffer for result and don't reduce vector capacity,
+    // so, same vector could be reused for sequence of calls in order to avoid memory allocation for each call.
+    HRESULT GetSequencePoints(PVOID pSymbolReaderHandle, mdMethodDef MethodToken, std::vector<MethodSequencePoint> &sequencePoints);
+    HRESULT GetDocumentName(PVOID pSymbolReaderHandle, int32_t documentIndex, std::string &documentName);
+    HRESULT GetDocumentNames(PVOID pSymbolReaderHandle, std::vector<std::string> &documentNames);
     HRESULT GetNextUserCodeILOffset(PVOID pSymbolReaderHandle, mdMethodDef MethodToken, ULONG32 IlOffset, ULONG32 &ilNextOffset, bool *noUserCodeFound);
     HRESULT GetNamedLocalVariableAndScope(PVOID pSymbolReaderHandle, mdMethodDef methodToken, ULONG localIndex,
                                           WCHAR *localName, ULONG localNameLen, ULONG32 *pIlStart, ULONG32 *pIlEnd);
-    HRESULT GetHoistedLocalScopes(PVOID pSymbolReaderHandle, mdMethodDef methodToken, PVOID *data, int32_t &hoistedLocalScopesCount);
+    HRESULT GetHoistedLocalScopes(PVOID pSymbolReaderHandle, mdMethodDef methodToken, std::vector<HoistedLocalScope> &hoistedLocalScopes);
     HRESULT GetStepRangesFromIP(PVOID pSymbolReaderHandle, ULONG32 ip, mdMethodDef MethodToken, ULONG32 *ilStartOffset, ULONG32 *ilEndOffset);
-    HRESULT GetModuleMethodsRanges(PVOID pSymbolReaderHandle, uint32_t constrTokensNum, PVOID constrTokens, uint32_t normalTokensNum, PVOID normalTokens, PVOID *data);
-    HRESULT ResolveBreakPoints(PVOID pSymbolReaderHandles[], int32_t tokenNum, PVOID Tokens, int32_t sourceLine, int32_t nestedToken, int32_t &Count, const std::string &sourcePath, PVOID *data);
+    HRESULT GetModuleMethodsRanges(PVOID pSymbolReaderHandle, uint32_t constrTokensNum, PVOID constrTokens, uint32_t normalTokensNum, PVOID normalTokens,
+                                   std::vector<FileMethodsData> &filesData, std::vector<method_data_t> &methodsData);
+    HRESULT ResolveBreakPoints(PVOID pSymbolReaderHandles[], int32_t tokenNum, PVOID Tokens, int32_t sourceLine, int32_t nestedToken,
+                               const std::string &sourcePath, std::vector<ResolvedBreakpoint> &resolvedBreakpoints);
     HRESULT GetAsyncMethodSteppingInfo(PVOID pSymbolReaderHandle, mdMethodDef methodToken, std::vector<AsyncAwaitInfoBlock> &AsyncAwaitInfo, ULONG32 *ilOffset);
     HRESULT GetSource(PVOID symbolReaderHandle, const std::string fileName, PVOID *data, int32_t *length);
     HRESULT LoadDeltaPdb(const std::string &pdbPath, VOID **ppSymbolReaderHandle, std::unordered_set<mdMethodDef> &methodTokens);
@@ -7,49 +7,50 @@
 #include <sstream>
 #include <vector>
 #include <iomanip>
+#include <atomic>
+#include <thread>
+#include <algorithm>
 
 #include "managed/interop.h"
 #include "utils/platform.h"
 #include "metadata/typeprinter.h"
 #include "metadata/jmc.h"
 #include "utils/filesystem.h"
+#include "utils/utility.h"
 
 namespace netcoredbg
 {
 
-ModuleInfo::~ModuleInfo() noexcept
+ModuleInfo::ModuleInfo(PVOID Handle, ICorDebugModule *Module) :
+    m_iCorModule(Module)
 {
-    for (auto symbolReaderHandle : m_symbolReaderHandles)
-    {
-        if (symbolReaderHandle != nullptr)
-            Interop::DisposeSymbols(symbolReaderHandle);
-    }
+    if (Handle == nullptr)
+        return;
+
+    m_symbolReaderHandles.reserve(1);
+    m_symbolReaderHolders.reserve(1);
+    AddSymbolReaderHandle(Handle);
 }
 
-static bool IsTargetFunction(const std::vector<std::string> &fullName, const std::vector<std::string> &targetName)
+ModuleInfo::ModuleInfo(const ModuleInfo &other) :
+    m_symbolReaderHandles(other.m_symbolReaderHandles),
+    m_iCorModule(other.m_iCorModule.GetPtr()),
+    m_methodBlockUpdates(other.m_methodBlockUpdates),
+    m_loadOrder(other.m_loadOrder),
+    m_symbolReaderHolders(other.m_symbolReaderHolders)
 {
-    // Function should be matched by substring, i.e. received target function name should fully or partly equal with the
-    // real function name. For example:
-    //
-    // "MethodA" matches
-    // Program.ClassA.MethodA
-    // Program.ClassB.MethodA
-    // Program.ClassA.InnerClass.MethodA
-    //
-    // "ClassA.MethodB" matches
-    // Program.ClassA.MethodB
-    // Program.ClassB.ClassA.MethodB
+    if (m_iCorModule)
+        m_iCorModule->AddRef();
+}
 
-    auto fullIt = fullName.rbegin();
-    for (auto it = targetName.rbegin(); it != targetName.rend(); it++)
+void ModuleInfo::AddSymbolReaderHandle(PVOID Handle)
+{
+    m_symbolReaderHandles.emplace_back(Handle);
+    m_symbolReaderHolders.emplace_back(Handle, [](PVOID symbolReaderHandle)
     {
-        if (fullIt == fullName.rend() || *it != *fullIt)
-            return false;
-
-        fullIt++;
-    }
-
-    return true;
+        if (symbolReaderHandle != nullptr)
+            Interop::DisposeSymbols(symbolReaderHandle);
+    });
 }
 
 static HRESULT ForEachMethod(ICorDebugModule *pModule, std::function<bool(const std::string&, mdMethodDef&)> functor)
@@ -60,6 +61,9 @@ static HRESULT ForEachMethod(ICorDebugModule *pModule, std::function<bool(const
 
     IfFailRet(pModule->GetMetaDataInterface(IID_IMetaDataImport, &pMDUnknown));
     IfFailRet(pMDUnknown->QueryInterface(IID_IMetaDataImport, (LPVOID *)&pMDImport));
+    // Get generic types
+    ToRelease<IMetaDataImport2> pMDImport2;
+    IfFailRet(pMDUnknown->QueryInterface(IID_IMetaDataImport2, (LPVOID *)&pMDImport2));
 
     ULONG typesCnt = 0;
     HCORENUM fTypeEnum = NULL;
@@ -85,11 +89,6 @@ static HRESULT ForEachMethod(ICorDebugModule *pModule, std::function<bool(const
             if (FAILED(Status))
                 continue;
 
-            // Get generic types
-            ToRelease<IMetaDataImport2> pMDImport2;
-
-            IfFailRet(pMDUnknown->QueryInterface(IID_IMetaDataImport2, (LPVOID *)&pMDImport2));
-
             HCORENUM fGenEnum = NULL;
             mdGenericParam gp;
             ULONG fetched;
@@ -155,32 +154,279 @@ static std::vector<std::string> split_on_tokens(const std::string &str, const ch
     return res;
 }
 
-static HRESULT ResolveMethodInModule(ICorDebugModule *pModule, const std::string &funcName, ResolveFuncBreakpointCallback cb)
+HRESULT FuncNameMatcher::Init(const std::string &funcName)
+{
+    m_isRegex = funcName.size() > 2 && funcName.front() == '/' && funcName.back() == '/';
+    if (m_isRegex)
+    {
+        try
+        {
+            m_regex = std::regex(funcName.substr(1, funcName.size() - 2), std::regex::ECMAScript | std::regex::optimize);
+        }
+        catch (const std::regex_error &e)
+        {
+            LOGE("Invalid function breakpoint regular expression %s: %s", funcName.c_str(), e.what());
+            return E_INVALIDARG;
+        }
+        return S_OK;
+    }
+
+    m_splittedName = split_on_tokens(funcName, '.');
+    m_isGlob = funcName.find_first_of("*?") != std::string::npos;
+    return S_OK;
+}
+
+bool FuncNameMatcher::Match(Utility::string_view fullName) const
 {
-    std::vector<std::string> splittedName = split_on_tokens(funcName, '.');
+    if (m_isRegex)
+        return std::regex_search(fullName.data(), fullName.data() + fullName.size(), m_regex);
 
-    auto functor = [&](const std::string& fullName, mdMethodDef& mdMethod) -> bool
+    // Function should be matched by substring, i.e. received target function name should fully or partly equal with the
+    // real function name. For example:
+    //
+    // "MethodA" matches
+    // Program.ClassA.MethodA
+    // Program.ClassB.MethodA
+    // Program.ClassA.InnerClass.MethodA
+    //
+    // "ClassA.MethodB" matches
+    // Program.ClassA.MethodB
+    // Program.ClassB.ClassA.MethodB
+    //
+    // Full name components are compared from the end in place, without split.
+    static const size_t npos = Utility::string_view::npos;
+    size_t end = fullName.size();
+    for (auto it = m_splittedName.rbegin(); it != m_splittedName.rend(); it++)
     {
-        std::vector<std::string> splittedFullName = split_on_tokens(fullName, '.');
+        if (end == npos)
+            return false;
 
-        // If we've found the target function
-        if (IsTargetFunction(splittedFullName, splittedName))
+        size_t start = fullName.rfind('.', end); // note, Utility::string_view::rfind() search in [0, end) range
+        size_t begin = start == npos ? 0 : start + 1;
+        Utility::string_view component = fullName.substr(begin, end - begin);
+        if (m_isGlob ? !Utility::MatchPattern(component, *it) : component.compare(*it) != 0)
+            return false;
+
+        end = start;
+    }
+
+    return true;
+}
+
+std::shared_ptr<const Modules::MethodsNames> Modules::GetMethodsNames(ICorDebugModule *pModule)
+{
+    CORDB_ADDRESS modAddress;
+    if (FAILED(pModule->GetBaseAddress(&modAddress)))
+        return nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(m_methodsNamesMutex);
+        auto find = m_methodsNames.find(modAddress);
+        if (find != m_methodsNames.end())
+            return find->second;
+    }
+
+    // Note, index built without lock, since modules could be resolved in parallel (see ResolveFuncBreakpointInAny()).
+    std::shared_ptr<MethodsNames> methodsNames = std::make_shared<MethodsNames>();
+    if (FAILED(ForEachMethod(pModule, [&](const std::string &fullName, mdMethodDef &mdMethod) -> bool
         {
-            if (FAILED(cb(pModule, mdMethod)))
-                return false; // abort operation
-        }
+            methodsNames->emplace_back(fullName, mdMethod);
+            return true;
+        })))
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_methodsNamesMutex);
+    return m_methodsNames.emplace(modAddress, std::move(methodsNames)).first->second;
+}
+
+HRESULT Modules::ResolveMethodInModule(ICorDebugModule *pModule, const FuncNameMatcher &matcher, ResolveFuncBreakpointCallback cb)
+{
+    std::shared_ptr<const MethodsNames> methodsNames = GetMethodsNames(pModule);
+    if (!methodsNames)
+        return E_FAIL;
+
+    for (const auto &entry : *methodsNames)
+    {
+        if (!matcher.Match(entry.first))
+            continue;
+
+        mdMethodDef mdMethod = entry.second;
+        if (FAILED(cb(pModule, mdMethod)))
+            return E_FAIL; // abort operation
+    }
+
+    return S_OK;
+}
 
-        return true;  // continue for other functions with matching name
+// Caller must care about m_typesIndexMutex.
+HRESULT Modules::AddTypesToIndex(CORDB_ADDRESS modAddress, unsigned loadOrder, ICorDebugModule *pModule)
+{
+    if (!m_typesIndexModules.insert(modAddress).second)
+        return S_OK;
+
+    HRESULT Status;
+    ToRelease<IUnknown> pMDUnknown;
+    ToRelease<IMetaDataImport> pMDImport;
+    IfFailRet(pModule->GetMetaDataInterface(IID_IMetaDataImport, &pMDUnknown));
+    IfFailRet(pMDUnknown->QueryInterface(IID_IMetaDataImport, (LPVOID*) &pMDImport));
+
+    struct type_data_t
+    {
+        std::string name;
+        mdTypeDef enclosingClass;
     };
+    std::unordered_map<mdTypeDef, type_data_t> types;
+
+    ULONG numTypedefs = 0;
+    HCORENUM hEnum = NULL;
+    mdTypeDef typeDef;
+    while (SUCCEEDED(pMDImport->EnumTypeDefs(&hEnum, &typeDef, 1, &numTypedefs)) && numTypedefs != 0)
+    {
+        WCHAR name[mdNameLen];
+        ULONG nameLen;
+        if (FAILED(pMDImport->GetTypeDefProps(typeDef, name, _countof(name), &nameLen, nullptr, nullptr)))
+            continue;
+
+        mdTypeDef enclosingClass;
+        if (FAILED(pMDImport->GetNestedClassProps(typeDef, &enclosingClass)))
+            enclosingClass = mdTypeDefNil;
+
+        types.emplace(typeDef, type_data_t{to_utf8(name), enclosingClass});
+    }
+    pMDImport->CloseEnum(hEnum);
+
+    // Note, enclosing type could follow nested type in enumeration, so, full names are built after all types collected.
+    for (const auto &entry : types)
+    {
+        std::string fullName = entry.second.name;
+        mdTypeDef enclosingClass = entry.second.enclosingClass;
+        while (enclosingClass != mdTypeDefNil)
+        {
+            auto findEnclosing = types.find(enclosingClass);
+            if (findEnclosing == types.end())
+                break;
+
+            fullName = findEnclosing->second.name + "." + fullName;
+            enclosingClass = findEnclosing->second.enclosingClass;
+        }
+        if (enclosingClass != mdTypeDefNil)
+            continue;
+
+        // Note, module could be re-indexed after Hot Reload, but must keep its position for same names.
+        std::vector<TypesIndexEntry> &entries = m_typesIndex[fullName];
+        auto it = std::upper_bound(entries.begin(), entries.end(), loadOrder,
+            [](unsigned order, const TypesIndexEntry &e) { return order < e.loadOrder; });
+        entries.insert(it, TypesIndexEntry{modAddress, loadOrder, entry.first, entry.second.enclosingClass});
+    }
+
+    return S_OK;
+}
+
+// Caller must care about m_typesIndexMutex.
+void Modules::RemoveTypesFromIndex(CORDB_ADDRESS modAddress)
+{
+    if (m_typesIndexModules.erase(modAddress) == 0)
+        return;
+
+    for (auto it = m_typesIndex.begin(); it != m_typesIndex.end();)
+    {
+        std::vector<TypesIndexEntry> &entries = it->second;
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+            [modAddress](const TypesIndexEntry &e) { return e.modAddress == modAddress; }), entries.end());
+        if (entries.empty())
+            it = m_typesIndex.erase(it);
+        else
+            ++it;
+    }
+}
+
+HRESULT Modules::FindTypeByName(const std::string &fullName, ICorDebugModule *pModule, mdTypeDef enclosingClass,
+                                ICorDebugModule **ppModule, mdTypeDef &typeDef)
+{
+    HRESULT Status;
+    CORDB_ADDRESS modAddress = 0;
+    if (pModule)
+        IfFailRet(pModule->GetBaseAddress(&modAddress));
+
+    std::lock_guard<std::mutex> lock(m_typesIndexMutex);
+    // Note, modules loaded after this snapshot will be added into index by TryLoadModuleSymbols().
+    std::shared_ptr<const ModulesInfo> modulesInfo = GetModulesInfo();
+    if (!m_typesIndexBuilt)
+    {
+        for (const auto &info_pair : *modulesInfo)
+        {
+            if (FAILED(AddTypesToIndex(info_pair.first, info_pair.second->m_loadOrder, info_pair.second->m_iCorModule)))
+                LOGW("Could not index types for module %s", GetModuleFileName(info_pair.second->m_iCorModule).c_str());
+        }
+        m_typesIndexBuilt = true;
+    }
+
+    auto findName = m_typesIndex.find(fullName);
+    if (findName == m_typesIndex.end())
+        return E_FAIL;
+
+    for (const TypesIndexEntry &entry : findName->second)
+    {
+        if ((modAddress != 0 && entry.modAddress != modAddress) || entry.enclosingClass != enclosingClass)
+            continue;
+
+        if (ppModule)
+        {
+            auto findModule = modulesInfo->find(entry.modAddress);
+            if (findModule == modulesInfo->end())
+                continue;
+
+            findModule->second->m_iCorModule->AddRef();
+            *ppModule = findModule->second->m_iCorModule.GetPtr();
+        }
+        typeDef = entry.typeDef;
+        return S_OK;
+    }
+
+    return E_FAIL;
+}
+
+void Modules::RemoveModuleTypes(ICorDebugModule *pModule)
+{
+    CORDB_ADDRESS modAddress;
+    if (FAILED(pModule->GetBaseAddress(&modAddress)))
+        return;
+
+    std::lock_guard<std::mutex> lock(m_typesIndexMutex);
+    RemoveTypesFromIndex(modAddress);
+}
 
-    return ForEachMethod(pModule, functor);
+std::shared_ptr<const Modules::ModulesInfo> Modules::GetModulesInfo() const
+{
+    return std::atomic_load(&m_modulesInfo);
+}
+
+// Caller must care about m_modulesInfoMutex.
+void Modules::PublishModuleInfo(CORDB_ADDRESS modAddress, std::shared_ptr<const ModuleInfo> mdInfo)
+{
+    std::shared_ptr<ModulesInfo> modulesInfo = std::make_shared<ModulesInfo>(*GetModulesInfo());
+    (*modulesInfo)[modAddress] = std::move(mdInfo);
+    std::atomic_store(&m_modulesInfo, std::shared_ptr<const ModulesInfo>(std::move(modulesInfo)));
 }
 
 void Modules::CleanupAllModules()
 {
     std::lock_guard<std::mutex> lock(m_modulesInfoMutex);
-    m_modulesInfo.clear();
+    // Note, deferred modules must be removed before symbol readers release.
+    m_modulesSources.ClearDeferredModules();
+    std::atomic_store(&m_modulesInfo, std::shared_ptr<const ModulesInfo>(std::make_shared<ModulesInfo>()));
     m_modulesAppUpdate.Clear();
+    m_modulesLoadCounter = 0;
+    m_skippedModules.clear();
+    m_runtimeDirectory.clear();
+
+    std::lock_guard<std::mutex> lockNames(m_methodsNamesMutex);
+    m_methodsNames.clear();
+
+    std::lock_guard<std::mutex> lockTypes(m_typesIndexMutex);
+    m_typesIndex.clear();
+    m_typesIndexModules.clear();
+    m_typesIndexBuilt = false;
 }
 
 std::string GetModuleFileName(ICorDebugModule *pModule)
@@ -220,6 +466,99 @@ static std::string GetFileName(const std::string &path)
     return i == std::string::npos ? path : path.substr(i + 1);
 }
 
+static std::string GetDirectory(const std::string &path)
+{
+    std::size_t i = path.find_last_of("/\\");
+    return i == std::string::npos ? std::string() : path.substr(0, i + 1);
+}
+
+// Framework (loaded from runtime directory) and NuGet packages modules. Usually, such modules are non-user code and
+// don't have breakpoints, so, symbols load could be skipped with enabled JMC and sources indexing could be postponed.
+bool Modules::IsFrameworkModule(const std::string &modulePath)
+{
+    if (!m_runtimeDirectory.empty() && GetDirectory(modulePath) == m_runtimeDirectory)
+        return true;
+
+    return modulePath.find("/.nuget/packages/") != std::string::npos ||
+           modulePath.find("\\.nuget\\packages\\") != std::string::npos;
+}
+
+// Well known public keys of .NET framework assemblies (public key tokens are provided in comments).
+static const char *MicrosoftPublicKeys[] =
+{
+    // b77a5c561934e089 (ECMA)
+    "00000000000000000400000000000000",
+    // b03f5f7f11d50a3a (Microsoft)
+    "002400000480000094000000060200000024000052534131000400000100010007d1fa57c4aed9f0a32e84aa0faefd0de9e8fd6aec8f87fb"
+    "03766c834c99921eb23be79ad9d5dcc1dd9ad236132102900b723cf980957fc4e177108fc607774f29e8320e92ea05ece4e821c0a5efe8f164"
+    "5c4c0c93c1ab99285d622caa652c1dfad63d745d6f2de5f17e5eaf0fc4963d261c8a12436518206dc093344d5ad293",
+    // 31bf3856ad364e35 (Microsoft shared)
+    "0024000004800000940000000602000000240000525341310004000001000100b5fc90e7027f67871e773a8fde8938c81dd402ba65b9201d"
+    "60593e96c492651e889cc13f1415ebb53fac1131ae0bd333c5ee6021672d9718ea31a8aebd0da0072f25d87dba6fc90ffd598ed4da35e44c"
+    "398c454307e8e33b8426143daec9f596836f97c8f74750e5975c64e2189f45def46b2a2b1247adc3652bf5c308055da9",
+    // cc7b13ffcd2ddd51 (Open)
+    "00240000048000009400000006020000002400005253413100040000010001004b86c4cb78549b34bab61a3b1800e23bfeb5b3ec39007404"
+    "1536a7e3cbd97f5f04cf0f857155a8928eaa29ebfd11cfbbad3ba70efea7bda3226c6a8d370a4cd303f714486b6ebc225985a638471e6ef5"
+    "71cc92a4613c00b8fa65d61ccee0cbe5f36330c9a01f4183559f1bef24cc2917c6d913e3a541333a1d05d9bed22b38cb",
+    // 7cec85d7bea7798e (Silverlight)
+    "00240000048000009400000006020000002400005253413100040000010001008d56c76f9e8649383049f383c44be0ec204181822a6c31cf"
+    "5eb7ef486944d032188ea1d3920763712ccb12d75fb77e9811149e6148e5d32fbaab37611c1878ddc19e20ef135d0cb2cff2bfec3d115810"
+    "c3d9069638fe4be215dbf795861920e5ab6f7db2e2ceef136ac23d5dd2bf031700aec232f6c6b1c785b4305c123b37ab",
+    // adb9793829ddae60 (ASP.NET Core)
+    "0024000004800000940000000602000000240000525341310004000001000100f33a29044fa9d740c9b3213a93e57c84b472c84e0b8a0e1a"
+    "e48e67a9f8f6de9d5f7f3d52ac23e48ac51801f1dc950abe901da34d2a9e3baadb141a17c77ef3c565dd5ee5054b91cf63bb3c6ab83f72ab"
+    "3aafe93d0fc3c2348b764fafb0b1c0733de51459aeab46580384bf9d74c4e28164b7cde247f891ba07891c9d872ad2bb"
+};
+
+// Assembly is signed by one of well known Microsoft keys, assembly name can't be used here, since user's assembly
+// could have `System.*` or `Microsoft.*` name too.
+static bool IsMicrosoftAssembly(IUnknown *pMDUnknown)
+{
+    ToRelease<IMetaDataAssemblyImport> pMDAssemblyImport;
+    mdAssembly assembly;
+    if (FAILED(pMDUnknown->QueryInterface(IID_IMetaDataAssemblyImport, (LPVOID*) &pMDAssemblyImport)) ||
+        FAILED(pMDAssemblyImport->GetAssemblyFromScope(&assembly)))
+        return false;
+
+    const void *publicKey = nullptr;
+    ULONG publicKeySize = 0;
+    DWORD flags = 0;
+    if (FAILED(pMDAssemblyImport->GetAssemblyProps(assembly, &publicKey, &publicKeySize, nullptr, nullptr, 0, nullptr, nullptr, &flags)) ||
+        publicKey == nullptr || publicKeySize == 0)
+        return false;
+
+    std::ostringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (ULONG i = 0; i < publicKeySize; i++)
+        ss << std::setw(2) << (static_cast<int>(static_cast<const BYTE*>(publicKey)[i]) & 0xFF);
+    const std::string publicKeyHex = ss.str();
+
+    for (const char *microsoftPublicKey : MicrosoftPublicKeys)
+    {
+        if (publicKeyHex == microsoftPublicKey)
+            return true;
+    }
+    return false;
+}
+
+bool Modules::IsSymbolsLoadExcluded(const std::string &moduleName)
+{
+    std::lock_guard<std::mutex> lock(m_symbolOptionsMutex);
+    for (const auto &pattern : m_symbolOptions.excludedModules)
+    {
+        if (Utility::MatchPattern(moduleName, pattern))
+            return true;
+    }
+    return false;
+}
+
+void Modules::SetSymbolOptions(const SymbolOptions &options)
+{
+    std::lock_guard<std::mutex> lock(m_symbolOptionsMutex);
+    m_symbolOptions = options;
+    m_symbolSearchPathsChanged = true;
+}
+
 HRESULT IsModuleHaveSameName(ICorDebugModule *pModule, const std::string &Name, bool isFullPath)
 {
     HRESULT Status;
@@ -239,50 +578,100 @@ HRESULT IsModuleHaveSameName(ICorDebugModule *pModule, const std::string &Name,
 
 HRESULT Modules::GetModuleInfo(CORDB_ADDRESS modAddress, ModuleInfoCallback cb)
 {
-    std::lock_guard<std::mutex> lock(m_modulesInfoMutex);
-    auto info_pair = m_modulesInfo.find(modAddress);
-    return (info_pair == m_modulesInfo.end()) ? E_FAIL : cb(info_pair->second);
+    std::shared_ptr<const ModuleInfo> mdInfo;
+    HRESULT Status;
+    IfFailRet(GetModuleInfo(modAddress, mdInfo));
+    return cb(*mdInfo);
 }
 
-// Caller must care about m_modulesInfoMutex.
-HRESULT Modules::GetModuleInfo(CORDB_ADDRESS modAddress, ModuleInfo **ppmdInfo)
+HRESULT Modules::GetModuleInfo(CORDB_ADDRESS modAddress, std::shared_ptr<const ModuleInfo> &mdInfo)
 {
-    auto info_pair = m_modulesInfo.find(modAddress);
-    if (info_pair == m_modulesInfo.end())
+    std::shared_ptr<const ModulesInfo> modulesInfo = GetModulesInfo();
+    auto info_pair = modulesInfo->find(modAddress);
+    if (info_pair == modulesInfo->end())
         return E_FAIL;
 
-    *ppmdInfo = &info_pair->second;
+    mdInfo = info_pair->second;
     return S_OK;
 }
 
 HRESULT Modules::ResolveFuncBreakpointInAny(const std::string &module,
                                             bool &module_checked,
-                                            const std::string &funcname,
+                                            const FuncNameMatcher &matcher,
                                             ResolveFuncBreakpointCallback cb)
 {
     bool isFullPath = IsFullPath(module);
     HRESULT Status;
 
-    std::lock_guard<std::mutex> lock(m_modulesInfoMutex);
-
-    for (auto &info_pair : m_modulesInfo)
+    // Note, snapshot hold modules alive during resolve.
+    std::shared_ptr<const ModulesInfo> modulesInfo = GetModulesInfo();
+    if (!module.empty())
     {
-        ModuleInfo &mdInfo = info_pair.second;
-        ICorDebugModule *pModule = mdInfo.m_iCorModule.GetPtr();
-
-        if (!module.empty())
+        for (const auto &info_pair : *modulesInfo)
         {
+            ICorDebugModule *pModule = info_pair.second->m_iCorModule.GetPtr();
+
             IfFailRet(IsModuleHaveSameName(pModule, module, isFullPath));
             if (Status == S_FALSE)
                 continue;
 
             module_checked = true;
+            ResolveMethodInModule(pModule, matcher, cb);
+            break;
         }
 
-        ResolveMethodInModule(mdInfo.m_iCorModule, funcname, cb);
+        return S_OK;
+    }
 
-        if (module_checked)
-            break;
+    // Methods enumeration is independent for each module, so, modules are resolved in parallel by worker threads
+    // with per-module results. Callback (breakpoint creation) is called for all results in caller thread after.
+    std::vector<ICorDebugModule*> modules;
+    modules.reserve(modulesInfo->size());
+    for (const auto &info_pair : *modulesInfo)
+    {
+        modules.emplace_back(info_pair.second->m_iCorModule.GetPtr());
+    }
+
+    std::vector<std::vector<mdMethodDef>> resolved(modules.size());
+    std::atomic<size_t> nextModule(0);
+    auto worker = [&]()
+    {
+        for (size_t i = nextModule++; i < modules.size(); i = nextModule++)
+        {
+            ResolveMethodInModule(modules[i], matcher, [&resolved, i](ICorDebugModule *, mdMethodDef &methodToken) -> HRESULT
+            {
+                resolved[i].emplace_back(methodToken);
+                return S_OK;
+            });
+        }
+    };
+
+    const size_t workersCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), modules.size());
+    std::vector<std::thread> workers;
+    try
+    {
+        for (size_t i = 1; i < workersCount; i++)
+        {
+            workers.emplace_back(worker);
+        }
+    }
+    catch (const std::system_error &e)
+    {
+        LOGW("Could not create worker thread for function breakpoint resolve: %s", e.what());
+    }
+    worker(); // caller thread also resolve modules
+    for (auto &thread : workers)
+    {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < modules.size(); i++)
+    {
+        for (auto &methodToken : resolved[i])
+        {
+            if (FAILED(cb(modules[i], methodToken)))
+                break; // abort operation for this module only, same as for sequential resolve
+        }
     }
 
     return S_OK;
@@ -290,7 +679,7 @@ HRESULT Modules::ResolveFuncBreakpointInAny(const std::string &module,
 
 
 HRESULT Modules::ResolveFuncBreakpointInModule(ICorDebugModule *pModule, const std::string &module, bool &module_checked,
-                                               std::string &funcname, ResolveFuncBreakpointCallback cb)
+                                               const FuncNameMatcher &matcher, ResolveFuncBreakpointCallback cb)
 {
     HRESULT Status;
 
@@ -303,7 +692,7 @@ HRESULT Modules::ResolveFuncBreakpointInModule(ICorDebugModule *pModule, const s
         module_checked = true;
     }
 
-    return ResolveMethodInModule(pModule, funcname, cb);
+    return ResolveMethodInModule(pModule, matcher, cb);
 }
 
 HRESULT Modules::GetFrameILAndSequencePoint(
@@ -336,7 +725,7 @@ HRESULT Modules::GetFrameILAndSequencePoint(
     CORDB_ADDRESS modAddress;
     IfFailRet(pModule->GetBaseAddress(&modAddress));
 
-    return GetModuleInfo(modAddress, [&](ModuleInfo &mdInfo) -> HRESULT
+    return GetModuleInfo(modAddress, [&](const ModuleInfo &mdInfo) -> HRESULT
     {
         if (mdInfo.m_symbolReaderHandles.empty() || mdInfo.m_symbolReaderHandles.size() < methodVersion)
             return E_FAIL;
@@ -418,7 +807,7 @@ HRESULT Modules::GetStepRangeFromCurrentIP(ICorDebugThread *pThread, COR_DEBUG_S
     ULONG32 ilStartOffset;
     ULONG32 ilEndOffset;
 
-    IfFailRet(GetModuleInfo(modAddress, [&](ModuleInfo &mdInfo) -> HRESULT
+    IfFailRet(GetModuleInfo(modAddress, [&](const ModuleInfo &mdInfo) -> HRESULT
     {
         if (mdInfo.m_symbolReaderHandles.empty() || mdInfo.m_symbolReaderHandles.size() < methodVersion)
             return E_FAIL;
@@ -496,6 +885,55 @@ static HRESULT LoadSymbols(IMetaDataImport *pMD, ICorDebugModule *pModule, VOID
     );
 }
 
+void Modules::SetupModuleSymbols(ICorDebugModule *pModule, IMetaDataImport *pMDImport, PVOID pSymbolReaderHandle, const Module &module,
+                                 bool needJMC, bool needHotReload, std::string &outputText)
+{
+    HRESULT Status;
+    ToRelease<ICorDebugModule2> pModule2;
+    if (SUCCEEDED(pModule->QueryInterface(IID_ICorDebugModule2, (LPVOID *)&pModule2)))
+    {
+        if (needHotReload)
+            pModule2->SetJITCompilerFlags(CORDEBUG_JIT_ENABLE_ENC);
+        else if (!needJMC) // Note, CORDEBUG_JIT_DISABLE_OPTIMIZATION is part of CORDEBUG_JIT_ENABLE_ENC.
+            pModule2->SetJITCompilerFlags(CORDEBUG_JIT_DISABLE_OPTIMIZATION);
+
+        if (SUCCEEDED(Status = pModule2->SetJMCStatus(TRUE, 0, nullptr))) // If we can't enable JMC for module, no reason disable JMC on module's types/methods.
+        {
+            // Note, we use JMC in runtime all the time (same behaviour as MS vsdbg and MSVS debugger have),
+            // since this is the only way provide good speed for stepping in case "JMC disabled".
+            // But in case "JMC disabled", debugger must care about different logic for exceptions/stepping/breakpoints.
+
+            // https://docs.microsoft.com/en-us/visualstudio/debugger/just-my-code
+            // The .NET debugger considers optimized binaries and non-loaded .pdb files to be non-user code.
+            // Three compiler attributes also affect what the .NET debugger considers to be user code:
+            // * DebuggerNonUserCodeAttribute tells the debugger that the code it's applied to isn't user code.
+            // * DebuggerHiddenAttribute hides the code from the debugger, even if Just My Code is turned off.
+            // * DebuggerStepThroughAttribute tells the debugger to step through the code it's applied to, rather than step into the code.
+            // The .NET debugger considers all other code to be user code.
+            if (needJMC)
+                DisableJMCByAttributes(pModule);
+        }
+        else if (Status == CORDBG_E_CANT_SET_TO_JMC)
+        {
+            if (needJMC)
+                outputText = "You are debugging a Release build of " + module.name + ". Using Just My Code with Release builds using compiler optimizations results in a degraded debugging experience (e.g. breakpoints will not be hit).";
+            else
+                outputText = "You are debugging a Release build of " + module.name + ". Without Just My Code Release builds try not to use compiler optimizations, but in some cases (e.g. attach) this still results in a degraded debugging experience (e.g. breakpoints will not be hit).";
+        }
+    }
+
+    // Modules without breakpoints will be indexed at first request, that need their sources data (at breakpoint
+    // setup, for example). In case we have unresolved line breakpoints, they are resolved at each module load
+    // (see LineBreakpoints::ManagedCallbackLoadModule()), so, module will be indexed right after this call.
+    if (IsFrameworkModule(module.path))
+    {
+        if (FAILED(m_modulesSources.DeferSourcesCodeLinesForModule(pModule, pMDImport, pSymbolReaderHandle)))
+            LOGE("Could not defer source lines related info load.");
+    }
+    else if (FAILED(m_modulesSources.FillSourcesCodeLinesForModule(pModule, pMDImport, pSymbolReaderHandle)))
+        LOGE("Could not load source lines related info from PDB file. Could produce failures during breakpoint's source path resolve in future.");
+}
+
 HRESULT Modules::TryLoadModuleSymbols(ICorDebugModule *pModule, Module &module, bool needJMC, bool needHotReload, std::string &outputText)
 {
     HRESULT Status;
@@ -507,48 +945,37 @@ HRESULT Modules::TryLoadModuleSymbols(ICorDebugModule *pModule, Module &module,
 
     module.path = GetModuleFileName(pModule);
     module.name = GetFileName(module.path);
+    // Note, System.Private.CoreLib.dll is always first loaded module.
+    if (module.name == "System.Private.CoreLib.dll")
+        m_runtimeDirectory = GetDirectory(module.path);
 
-    PVOID pSymbolReaderHandle = nullptr;
-    LoadSymbols(pMDImport, pModule, &pSymbolReaderHandle);
-    module.symbolStatus = pSymbolReaderHandle != nullptr ? SymbolsLoaded : SymbolsNotFound;
-
-    if (module.symbolStatus == SymbolsLoaded)
+    // Note, managed part is initialized at CreateProcess callback, after symbol options were set by protocol.
+    if (m_symbolSearchPathsChanged.exchange(false))
     {
-        ToRelease<ICorDebugModule2> pModule2;
-        if (SUCCEEDED(pModule->QueryInterface(IID_ICorDebugModule2, (LPVOID *)&pModule2)))
-        {
-            if (needHotReload)
-                pModule2->SetJITCompilerFlags(CORDEBUG_JIT_ENABLE_ENC);
-            else if (!needJMC) // Note, CORDEBUG_JIT_DISABLE_OPTIMIZATION is part of CORDEBUG_JIT_ENABLE_ENC.
-                pModule2->SetJITCompilerFlags(CORDEBUG_JIT_DISABLE_OPTIMIZATION);
+        std::unique_lock<std::mutex> lock(m_symbolOptionsMutex);
+        const SymbolOptions symbolOptions = m_symbolOptions;
+        lock.unlock();
+        if (FAILED(Interop::SetSymbolSearchPaths(symbolOptions.searchPaths, symbolOptions.cachePath)))
+            LOGW("Could not set symbol search paths");
+    }
 
-            if (SUCCEEDED(Status = pModule2->SetJMCStatus(TRUE, 0, nullptr))) // If we can't enable JMC for module, no reason disable JMC on module's types/methods.
-            {
-                // Note, we use JMC in runtime all the time (same behaviour as MS vsdbg and MSVS debugger have),
-                // since this is the only way provide good speed for stepping in case "JMC disabled".
-                // But in case "JMC disabled", debugger must care about different logic for exceptions/stepping/breakpoints.
-
-                // https://docs.microsoft.com/en-us/visualstudio/debugger/just-my-code
-                // The .NET debugger considers optimized binaries and non-loaded .pdb files to be non-user code.
-                // Three compiler attributes also affect what the .NET debugger considers to be user code:
-                // * DebuggerNonUserCodeAttribute tells the debugger that the code it's applied to isn't user code.
-                // * DebuggerHiddenAttribute hides the code from the debugger, even if Just My Code is turned off.
-                // * DebuggerStepThroughAttribute tells the debugger to step through the code it's applied to, rather than step into the code.
-                // The .NET debugger considers all other code to be user code.
-                if (needJMC)
-                    DisableJMCByAttributes(pModule);
-            }
-            else if (Status == CORDBG_E_CANT_SET_TO_JMC)
-            {
-                if (needJMC)
-                    outputText = "You are debugging a Release build of " + module.name + ". Using Just My Code with Release builds using compiler optimizations results in a degraded debugging experience (e.g. breakpoints will not be hit).";
-                else
-                    outputText = "You are debugging a Release build of " + module.name + ". Without Just My Code Release builds try not to use compiler optimizations, but in some cases (e.g. attach) this still results in a degraded debugging experience (e.g. breakpoints will not be hit).";
-            }
-        }
+    // Classify module before any PDB probing, since symbols for non-user code are not needed with enabled JMC.
+    // The .NET debugger considers non-loaded .pdb files to be non-user code, so, JMC status setup is not needed.
+    const bool excluded = IsSymbolsLoadExcluded(module.name);
+    const bool nonUserCode = !excluded && needJMC && (IsFrameworkModule(module.path) || IsMicrosoftAssembly(pMDUnknown));
 
-        if (FAILED(m_modulesSources.FillSourcesCodeLinesForModule(pModule, pMDImport, pSymbolReaderHandle)))
-            LOGE("Could not load source lines related info from PDB file. Could produce failures during breakpoint's source path resolve in future.");
+    PVOID pSymbolReaderHandle = nullptr;
+    if (excluded || nonUserCode)
+    {
+        module.symbolStatus = SymbolsSkipped;
+    }
+    else
+    {
+        LoadSymbols(pMDImport, pModule, &pSymbolReaderHandle);
+        module.symbolStatus = pSymbolReaderHandle != nullptr ? SymbolsLoaded : SymbolsNotFound;
+
+        if (module.symbolStatus == SymbolsLoaded)
+            SetupModuleSymbols(pModule, pMDImport, pSymbolReaderHandle, module, needJMC, needHotReload, outputText);
     }
 
     IfFailRet(GetModuleId(pModule, module.id));
@@ -561,12 +988,85 @@ HRESULT Modules::TryLoadModuleSymbols(ICorDebugModule *pModule, Module &module,
     module.size = size;
 
     pModule->AddRef();
-    ModuleInfo mdInfo { pSymbolReaderHandle, pModule };
-    std::lock_guard<std::mutex> lock(m_modulesInfoMutex);
-    m_modulesInfo.insert(std::make_pair(baseAddress, std::move(mdInfo)));
+    std::shared_ptr<ModuleInfo> mdInfo = std::make_shared<ModuleInfo>(pSymbolReaderHandle, pModule);
+    unsigned loadOrder = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_modulesInfoMutex);
+        if (GetModulesInfo()->count(baseAddress) == 0)
+        {
+            mdInfo->m_loadOrder = loadOrder = ++m_modulesLoadCounter;
+            PublishModuleInfo(baseAddress, std::move(mdInfo));
+            if (nonUserCode)
+            {
+                pModule->AddRef();
+                m_skippedModules.emplace_back(pModule);
+            }
+        }
+
+        if (needHotReload)
+            IfFailRet(m_modulesAppUpdate.AddUpdateHandlerTypesForModule(pModule, pMDImport));
+    }
+
+    // Note, module must be published first, since index could be built in the same time from published modules.
+    std::lock_guard<std::mutex> lock(m_typesIndexMutex);
+    if (m_typesIndexBuilt && loadOrder != 0 && FAILED(AddTypesToIndex(baseAddress, loadOrder, pModule)))
+        LOGW("Could not index types for module %s", module.path.c_str());
+
+    return S_OK;
+}
+
+HRESULT Modules::LoadSkippedModulesSymbols(std::function<void(ICorDebugModule *, const Module &, const std::string &)> cb)
+{
+    std::vector<ToRelease<ICorDebugModule>> skippedModules;
+    {
+        std::lock_guard<std::mutex> lock(m_modulesInfoMutex);
+        skippedModules.swap(m_skippedModules);
+    }
+
+    HRESULT Status;
+    for (auto &iCorModule : skippedModules)
+    {
+        ToRelease<IUnknown> pMDUnknown;
+        ToRelease<IMetaDataImport> pMDImport;
+        IfFailRet(iCorModule->GetMetaDataInterface(IID_IMetaDataImport, &pMDUnknown));
+        IfFailRet(pMDUnknown->QueryInterface(IID_IMetaDataImport, (LPVOID*) &pMDImport));
+
+        Module module;
+        module.path = GetModuleFileName(iCorModule);
+        module.name = GetFileName(module.path);
+        IfFailRet(GetModuleId(iCorModule, module.id));
+        CORDB_ADDRESS baseAddress;
+        ULONG32 size;
+        IfFailRet(iCorModule->GetBaseAddress(&baseAddress));
+        IfFailRet(iCorModule->GetSize(&size));
+        module.baseAddress = baseAddress;
+        module.size = size;
+
+        PVOID pSymbolReaderHandle = nullptr;
+        LoadSymbols(pMDImport, iCorModule, &pSymbolReaderHandle);
+        module.symbolStatus = pSymbolReaderHandle != nullptr ? SymbolsLoaded : SymbolsNotFound;
+
+        std::string outputText;
+        if (module.symbolStatus == SymbolsLoaded)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_modulesInfoMutex);
+                std::shared_ptr<const ModuleInfo> mdInfo;
+                if (FAILED(GetModuleInfo(baseAddress, mdInfo)))
+                {
+                    Interop::DisposeSymbols(pSymbolReaderHandle);
+                    continue;
+                }
+                std::shared_ptr<ModuleInfo> newInfo = std::make_shared<ModuleInfo>(*mdInfo);
+                newInfo->AddSymbolReaderHandle(pSymbolReaderHandle);
+                PublishModuleInfo(baseAddress, std::move(newInfo));
+            }
+            // Note, JIT compiler flags can't be changed after module load, so, module code could be optimized.
+            SetupModuleSymbols(iCorModule, pMDImport, pSymbolReaderHandle, module, false, false, outputText);
+        }
 
-    if (needHotReload)
-        IfFailRet(m_modulesAppUpdate.AddUpdateHandlerTypesForModule(pModule, pMDImport));
+        cb(iCorModule, module, outputText);
+    }
 
     return S_OK;
 }
@@ -587,7 +1087,7 @@ HRESULT Modules::GetFrameNamedLocalVariable(
 
     WCHAR wLocalName[mdNameLen] = W("\0");
 
-    IfFailRet(GetModuleInfo(modAddress, [&](ModuleInfo &mdInfo) -> HRESULT
+    IfFailRet(GetModuleInfo(modAddress, [&](const ModuleInfo &mdInfo) -> HRESULT
     {
         if (mdInfo.m_symbolReaderHandles.empty() || mdInfo.m_symbolReaderHandles.size() < methodVersion)
             return E_FAIL;
@@ -604,29 +1104,27 @@ HRESULT Modules::GetHoistedLocalScopes(
     ICorDebugModule *pModule,
     mdMethodDef methodToken,
     ULONG32 methodVersion,
-    PVOID *data,
-    int32_t &hoistedLocalScopesCount)
+    std::vector<Interop::HoistedLocalScope> &hoistedLocalScopes)
 {
     HRESULT Status;
     CORDB_ADDRESS modAddress;
     IfFailRet(pModule->GetBaseAddress(&modAddress));
 
-    return GetModuleInfo(modAddress, [&](ModuleInfo &mdInfo) -> HRESULT
+    return GetModuleInfo(modAddress, [&](const ModuleInfo &mdInfo) -> HRESULT
     {
         if (mdInfo.m_symbolReaderHandles.empty() || mdInfo.m_symbolReaderHandles.size() < methodVersion)
             return E_FAIL;
 
-        return Interop::GetHoistedLocalScopes(mdInfo.m_symbolReaderHandles[methodVersion - 1], methodToken, data, hoistedLocalScopesCount);
+        return Interop::GetHoistedLocalScopes(mdInfo.m_symbolReaderHandles[methodVersion - 1], methodToken, hoistedLocalScopes);
     });
 }
 
 HRESULT Modules::GetModuleWithName(const std::string &name, ICorDebugModule **ppModule, bool onlyWithPDB)
 {
-    std::lock_guard<std::mutex> lock(m_modulesInfoMutex);
-
-    for (auto &info_pair : m_modulesInfo)
+    std::shared_ptr<const ModulesInfo> modulesInfo = GetModulesInfo();
+    for (const auto &info_pair : *modulesInfo)
     {
-        ModuleInfo &mdInfo = info_pair.second;
+        const ModuleInfo &mdInfo = *info_pair.second;
 
         std::string path = GetModuleFileName(mdInfo.m_iCorModule);
 
@@ -655,7 +1153,7 @@ HRESULT Modules::GetNextUserCodeILOffsetInMethod(
     CORDB_ADDRESS modAddress;
     IfFailRet(pModule->GetBaseAddress(&modAddress));
 
-    return GetModuleInfo(modAddress, [&](ModuleInfo &mdInfo) -> HRESULT
+    return GetModuleInfo(modAddress, [&](const ModuleInfo &mdInfo) -> HRESULT
     {
         if (mdInfo.m_symbolReaderHandles.empty() || mdInfo.m_symbolReaderHandles.size() < methodVersion)
             return E_FAIL;
@@ -693,7 +1191,7 @@ HRESULT Modules::GetSequencePointByILOffset(
     ULONG32 ilOffset,
     Modules::SequencePoint &sequencePoint)
 {
-    return GetModuleInfo(modAddress, [&](ModuleInfo &mdInfo) -> HRESULT
+    return GetModuleInfo(modAddress, [&](const ModuleInfo &mdInfo) -> HRESULT
     {
         if (mdInfo.m_symbolReaderHandles.empty() || mdInfo.m_symbolReaderHandles.size() < methodVersion)
             return E_FAIL;
@@ -705,33 +1203,57 @@ HRESULT Modules::GetSequencePointByILOffset(
 HRESULT Modules::ForEachModule(std::function<HRESULT(ICorDebugModule *pModule)> cb)
 {
     HRESULT Status;
-    std::lock_guard<std::mutex> lock(m_modulesInfoMutex);
-
-    for (auto &info_pair : m_modulesInfo)
+    std::shared_ptr<const ModulesInfo> modulesInfo = GetModulesInfo();
+    for (const auto &info_pair : *modulesInfo)
     {
-        ModuleInfo &mdInfo = info_pair.second;
-        IfFailRet(cb(mdInfo.m_iCorModule));
+        IfFailRet(cb(info_pair.second->m_iCorModule));
     }
     return S_OK;
 }
 
-HRESULT Modules::ResolveBreakpoint(/*in*/ CORDB_ADDRESS modAddress, /*in*/ std::string filename, /*out*/ unsigned &fullname_index,
+HRESULT Modules::ResolveBreakpoint(/*in*/ CORDB_ADDRESS modAddress, /*in*/ const std::string &filename, /*out*/ unsigned &fullname_index,
                                    /*in*/ int sourceLine, /*out*/ std::vector<ModulesSources::resolved_bp_t> &resolvedPoints)
 {
-#ifdef WIN32
-    HRESULT Status;
-    IfFailRet(Interop::StringToUpper(filename));
-#endif
-
-    // Note, in all code we use m_modulesInfoMutex > m_sourcesInfoMutex lock sequence.
-    std::lock_guard<std::mutex> lockModulesInfo(m_modulesInfoMutex);
     return m_modulesSources.ResolveBreakpoint(this, modAddress, filename, fullname_index, sourceLine, resolvedPoints);
 }
 
 HRESULT Modules::ApplyPdbDeltaAndLineUpdates(ICorDebugModule *pModule, bool needJMC, const std::string &deltaPDB,
                                              const std::string &lineUpdates, std::unordered_set<mdMethodDef> &methodTokens)
 {
-    return m_modulesSources.ApplyPdbDeltaAndLineUpdates(this, pModule, needJMC, deltaPDB, lineUpdates, methodTokens);
+    HRESULT Status;
+    CORDB_ADDRESS modAddress;
+    IfFailRet(pModule->GetBaseAddress(&modAddress));
+
+    // Hot Reload could add new methods, methods names index should be rebuilt at next function breakpoints resolve.
+    {
+        std::lock_guard<std::mutex> lock(m_methodsNamesMutex);
+        m_methodsNames.erase(modAddress);
+    }
+    // Same for new types, but types index is global, so, only module's types are re-indexed.
+    {
+        std::lock_guard<std::mutex> lock(m_typesIndexMutex);
+        std::shared_ptr<const ModulesInfo> modulesInfo = GetModulesInfo();
+        auto findModule = modulesInfo->find(modAddress);
+        if (m_typesIndexBuilt && findModule != modulesInfo->end())
+        {
+            RemoveTypesFromIndex(modAddress);
+            if (FAILED(AddTypesToIndex(modAddress, findModule->second->m_loadOrder, pModule)))
+                LOGW("Could not index types for module %s", GetModuleFileName(pModule).c_str());
+        }
+    }
+
+    // Note, in all code we use m_modulesInfoMutex > m_sourcesInfoMutex lock sequence.
+    std::lock_guard<std::mutex> lock(m_modulesInfoMutex);
+    std::shared_ptr<const ModuleInfo> mdInfo;
+    IfFailRet(GetModuleInfo(modAddress, mdInfo));
+
+    // Readers could use current module info in the same time, work with copy and publish it at the end.
+    std::shared_ptr<ModuleInfo> newInfo = std::make_shared<ModuleInfo>(*mdInfo);
+    Status = m_modulesSources.ApplyPdbDeltaAndLineUpdates(*newInfo, pModule, needJMC, deltaPDB, lineUpdates, methodTokens);
+    // Note, added symbol reader must be published even in case of line updates fail, since we use indexes that correspond to il/metadata apply number.
+    if (newInfo->m_symbolReaderHandles.size() != mdInfo->m_symbolReaderHandles.size())
+        PublishModuleInfo(modAddress, std::move(newInfo));
+    return Status;
 }
 
 HRESULT Modules::GetSourceFullPathByIndex(unsigned index, std::string &fullPath)
@@ -766,10 +1288,10 @@ void Modules::FindFunctions(Utility::string_view pattern, unsigned limit, std::f
         return true;  // continue for next functions
     }; 
 
-    std::lock_guard<std::mutex> lock(m_modulesInfoMutex);
-    for (const auto& modpair : m_modulesInfo)
+    std::shared_ptr<const ModulesInfo> modulesInfo = GetModulesInfo();
+    for (const auto& modpair : *modulesInfo)
     {
-        HRESULT Status = ForEachMethod(modpair.second.m_iCorModule, functor);
+        HRESULT Status = ForEachMethod(modpair.second->m_iCorModule, functor);
         if (FAILED(Status))
             break;
     }
@@ -781,7 +1303,7 @@ HRESULT Modules::GetSource(ICorDebugModule *pModule, const std::string &sourcePa
     CORDB_ADDRESS modAddress;
     IfFailRet(pModule->GetBaseAddress(&modAddress));
 
-    return GetModuleInfo(modAddress, [&](ModuleInfo &mdInfo) -> HRESULT
+    return GetModuleInfo(modAddress, [&](const ModuleInfo &mdInfo) -> HRESULT
     {
         if (mdInfo.m_symbolReaderHandles.size() > 1)
         {
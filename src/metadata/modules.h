@@ -7,10 +7,13 @@
 #include "cor.h"
 #include "cordebug.h"
 
+#include <atomic>
 #include <functional>
 #include <unordered_map>
+#include <unordered_set>
 #include <mutex>
 #include <memory>
+#include <regex>
 #include "interfaces/types.h"
 #include "metadata/modules_app_update.h"
 #include "metadata/modules_sources.h"
@@ -31,26 +34,41 @@ struct ModuleInfo
     ToRelease<ICorDebugModule> m_iCorModule;
     // Cache for LineUpdates data for all methods in this module (Hot Reload related).
     method_block_updates_t m_methodBlockUpdates;
+    // Module load sequence number, modules loaded earlier have priority in types search.
+    unsigned m_loadOrder = 0;
 
-    ModuleInfo(PVOID Handle, ICorDebugModule *Module) :
-        m_iCorModule(Module)
-    {
-        if (Handle == nullptr)
-            return;
-
-        m_symbolReaderHandles.reserve(1);
-        m_symbolReaderHandles.emplace_back(Handle);
-    }
-
-    ModuleInfo(ModuleInfo&& other) noexcept :
-        m_symbolReaderHandles(std::move(other.m_symbolReaderHandles)),
-        m_iCorModule(std::move(other.m_iCorModule))
-    {
-    }
-    ModuleInfo(const ModuleInfo&) = delete;
+    ModuleInfo(PVOID Handle, ICorDebugModule *Module);
+    // Copy for new modules snapshot (Hot Reload related), symbol readers are shared with original.
+    ModuleInfo(const ModuleInfo &other);
+    ModuleInfo(ModuleInfo&&) = delete;
     ModuleInfo& operator=(ModuleInfo&&) = delete;
     ModuleInfo& operator=(const ModuleInfo&) = delete;
-    ~ModuleInfo() noexcept;
+
+    void AddSymbolReaderHandle(PVOID Handle);
+
+private:
+
+    // Symbol readers disposed with last ModuleInfo that use them, since old snapshots could be still in use by readers.
+    std::vector<std::shared_ptr<void>> m_symbolReaderHolders;
+};
+
+// Function breakpoint name matcher, compiled once for breakpoint and used for methods of all modules. Name could be:
+// - `ClassA.MethodB`, components are matched from the end of method full name (`Program.ClassA.MethodB`);
+// - glob, same as above, but components could have `*` and `?` wildcards (`MyApp.Services.*.Handle*`);
+// - regular expression in slashes (`/^MyApp\..*Handler\.Handle/`), searched in method full name.
+class FuncNameMatcher
+{
+public:
+
+    HRESULT Init(const std::string &funcName);
+    bool Match(Utility::string_view fullName) const;
+
+private:
+
+    std::vector<std::string> m_splittedName;
+    bool m_isGlob = false;
+    bool m_isRegex = false;
+    std::regex m_regex;
 };
 
 class Modules
@@ -68,7 +86,7 @@ public:
 
     HRESULT ResolveBreakpoint(
         /*in*/ CORDB_ADDRESS modAddress,
-        /*in*/ std::string filename,
+        /*in*/ const std::string &filename,
         /*out*/ unsigned &fullname_index,
         /*in*/ int sourceLine,
         /*out*/ std::vector<ModulesSources::resolved_bp_t> &resolvedPoints);
@@ -82,9 +100,9 @@ public:
 
     void CopyModulesUpdateHandlerTypes(std::vector<ToRelease<ICorDebugType>> &modulesUpdateHandlerTypes);
 
-    typedef std::function<HRESULT(ModuleInfo &)> ModuleInfoCallback;
+    typedef std::function<HRESULT(const ModuleInfo &)> ModuleInfoCallback;
     HRESULT GetModuleInfo(CORDB_ADDRESS modAddress, ModuleInfoCallback cb);
-    HRESULT GetModuleInfo(CORDB_ADDRESS modAddress, ModuleInfo **ppmdInfo);
+    HRESULT GetModuleInfo(CORDB_ADDRESS modAddress, std::shared_ptr<const ModuleInfo> &mdInfo);
 
     HRESULT GetFrameILAndSequencePoint(
         ICorDebugFrame *pFrame,
@@ -100,14 +118,14 @@ public:
     HRESULT ResolveFuncBreakpointInAny(
         const std::string &module,
         bool &module_checked,
-        const std::string &funcname,
+        const FuncNameMatcher &matcher,
         ResolveFuncBreakpointCallback cb);
 
     HRESULT ResolveFuncBreakpointInModule(
         ICorDebugModule *pModule,
         const std::string &module,
         bool &module_checked,
-        std::string &funcname,
+        const FuncNameMatcher &matcher,
         ResolveFuncBreakpointCallback cb);
 
     HRESULT GetStepRangeFromCurrentIP(
@@ -121,6 +139,25 @@ public:
         bool needHotReload,
         std::string &outputText);
 
+    // Find type by namespace-qualified name, nested types names are joined with enclosing type name by '.' and generic types
+    // names must have arity suffix (for example, "NS.Outer`1.Inner"). Search in pModule only, in case it is not null.
+    // Note, types index is built at first call and updated at modules load/unload.
+    HRESULT FindTypeByName(
+        const std::string &fullName,
+        ICorDebugModule *pModule,
+        mdTypeDef enclosingClass,
+        ICorDebugModule **ppModule,
+        mdTypeDef &typeDef);
+
+    // Remove unloaded module's types from types index (see FindTypeByName()).
+    void RemoveModuleTypes(ICorDebugModule *pModule);
+
+    // Load symbols for modules, that was skipped as non-user code with enabled JMC (see TryLoadModuleSymbols()).
+    HRESULT LoadSkippedModulesSymbols(std::function<void(ICorDebugModule *pModule, const Module &module, const std::string &outputText)> cb);
+
+    // Note, must be set before debuggee process start or attach.
+    void SetSymbolOptions(const SymbolOptions &options);
+
     void CleanupAllModules();
 
     HRESULT GetFrameNamedLocalVariable(
@@ -136,8 +173,7 @@ public:
         ICorDebugModule *pModule,
         mdMethodDef methodToken,
         ULONG32 methodVersion,
-        PVOID *data,
-        int32_t &hoistedLocalScopesCount);
+        std::vector<Interop::HoistedLocalScope> &hoistedLocalScopes);
 
     HRESULT GetNextUserCodeILOffsetInMethod(
         ICorDebugModule *pModule,
@@ -162,12 +198,66 @@ public:
 
 private:
 
+    typedef std::unordered_map<CORDB_ADDRESS, std::shared_ptr<const ModuleInfo>> ModulesInfo;
+
+    // Modules table is immutable snapshot (RCU-like), readers take current snapshot and work with it without any lock
+    // (include managed symbol reader calls), writers serialized by m_modulesInfoMutex and publish modified copy.
+    // Note, m_modulesInfo must be accessed by std::atomic_load()/std::atomic_store() only.
     std::mutex m_modulesInfoMutex;
-    std::unordered_map<CORDB_ADDRESS, ModuleInfo> m_modulesInfo;
+    std::shared_ptr<const ModulesInfo> m_modulesInfo = std::make_shared<ModulesInfo>();
+    // Note, m_modulesAppUpdate and m_modulesLoadCounter covered by m_modulesInfoMutex.
     ModulesAppUpdate m_modulesAppUpdate;
+    unsigned m_modulesLoadCounter = 0;
 
-    // Note, m_modulesSources have its own mutex for private data state sync.
+    std::shared_ptr<const ModulesInfo> GetModulesInfo() const;
+    // Caller must care about m_modulesInfoMutex.
+    void PublishModuleInfo(CORDB_ADDRESS modAddress, std::shared_ptr<const ModuleInfo> mdInfo);
+
+    // Note, m_modulesSources have its own snapshot and writers mutex.
     ModulesSources m_modulesSources;
+    // Directory of System.Private.CoreLib.dll with trailing separator, used for framework modules detection.
+    // Note, modules load (TryLoadModuleSymbols() calls) is serialized, so, no lock needed.
+    std::string m_runtimeDirectory;
+    // Note, set by protocol thread and read at module load in managed callback thread.
+    std::mutex m_symbolOptionsMutex;
+    SymbolOptions m_symbolOptions;
+    // Search paths should be passed to managed part at first module load, since it is not initialized at options setup.
+    // Note, set by protocol thread and read at module load in managed callback thread.
+    std::atomic<bool> m_symbolSearchPathsChanged{false};
+    // Non-user code modules with skipped symbols load, covered by m_modulesInfoMutex.
+    std::vector<ToRelease<ICorDebugModule>> m_skippedModules;
+
+    // Methods full names index for function breakpoints resolve, built at first resolve in module.
+    typedef std::vector<std::pair<std::string, mdMethodDef>> MethodsNames;
+    std::mutex m_methodsNamesMutex;
+    std::unordered_map<CORDB_ADDRESS, std::shared_ptr<const MethodsNames>> m_methodsNames;
+
+    std::shared_ptr<const MethodsNames> GetMethodsNames(ICorDebugModule *pModule);
+
+    // Fully qualified types names index for evaluation, built at first FindTypeByName() call. Same name could be
+    // provided by different modules, or by top level and nested type (namespace vs enclosing type name).
+    // Entries for each name are sorted by module load order, since first loaded module's type should be found.
+    struct TypesIndexEntry
+    {
+        CORDB_ADDRESS modAddress;
+        unsigned loadOrder;
+        mdTypeDef typeDef;
+        mdTypeDef enclosingClass;
+    };
+    std::mutex m_typesIndexMutex;
+    bool m_typesIndexBuilt = false;
+    std::unordered_map<std::string, std::vector<TypesIndexEntry>> m_typesIndex;
+    std::unordered_set<CORDB_ADDRESS> m_typesIndexModules;
+
+    // Caller must care about m_typesIndexMutex.
+    HRESULT AddTypesToIndex(CORDB_ADDRESS modAddress, unsigned loadOrder, ICorDebugModule *pModule);
+    void RemoveTypesFromIndex(CORDB_ADDRESS modAddress);
+    HRESULT ResolveMethodInModule(ICorDebugModule *pModule, const FuncNameMatcher &matcher, ResolveFuncBreakpointCallback cb);
+
+    bool IsFrameworkModule(const std::string &modulePath);
+    bool IsSymbolsLoadExcluded(const std::string &moduleName);
+    void SetupModuleSymbols(ICorDebugModule *pModule, IMetaDataImport *pMDImport, PVOID pSymbolReaderHandle, const Module &module,
+                            bool needJMC, bool needHotReload, std::string &outputText);
 
     HRESULT GetSequencePointByILOffset(
         PVOID pSymbolReaderHandle,
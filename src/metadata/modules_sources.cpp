@@ -3,10 +3,11 @@
 // See the LICENSE file in the project root for more information.
 
 #include <list>
-#include <map>
 #include <memory>
 #include <algorithm>
 #include <fstream>
+#include <tuple>
+#include <cstring>
 
 #include "metadata/modules_sources.h"
 #include "metadata/modules.h"
@@ -20,130 +21,121 @@ namespace netcoredbg
 namespace
 {
 
-    struct file_methods_data_t
+    bool MultiMethodDataLess(const multi_method_data_t &lhs, const method_data_t &rhs)
     {
-        BSTR document;
-        int32_t methodNum;
-        method_data_t *methodsData;
-
-        file_methods_data_t() = delete;
-        file_methods_data_t(const file_methods_data_t&) = delete;
-        file_methods_data_t& operator=(const file_methods_data_t&) = delete;
-        file_methods_data_t(file_methods_data_t&&) = delete;
-        file_methods_data_t& operator=(file_methods_data_t&&) = delete;
-    };
-
-    struct module_methods_data_t
-    {
-        int32_t fileNum;
-        file_methods_data_t *moduleMethodsData;
-
-        module_methods_data_t() = delete;
-        module_methods_data_t(const module_methods_data_t&) = delete;
-        module_methods_data_t& operator=(const module_methods_data_t&) = delete;
-        module_methods_data_t(module_methods_data_t&&) = delete;
-        module_methods_data_t& operator=(module_methods_data_t&&) = delete;
-    };
+        const method_data_t &data = lhs.methodData;
+        return std::tie(data.methodDef, data.startLine, data.endLine, data.startColumn, data.endColumn) <
+               std::tie(rhs.methodDef, rhs.startLine, rhs.endLine, rhs.startColumn, rhs.endColumn);
+    }
 
-    struct module_methods_data_t_deleter
+    // Build nesting levels for source file methods, each level sorted by end position (see GetMethodTokensByLineNumber()).
+    // Methods sorted by start position (outer first for same start), so, stack always hold chain of methods that enclose
+    // current one and its size is nesting level. Method with same end position as already added method (constructors
+    // case) is not added to levels, but stored in multiMethodsData with first added method as key.
+    // Note, sort is stable, input order is used for methods with same ranges.
+    void BuildMethodsData(/*in,out*/ std::vector<method_data_t> &inputData, /*out*/ methods_index_t &methodsIndex)
     {
-        void operator()(module_methods_data_t *p) const
+        std::stable_sort(inputData.begin(), inputData.end(), [](const method_data_t &lhs, const method_data_t &rhs)
+        {
+            if (lhs.startLine != rhs.startLine || lhs.startColumn != rhs.startColumn)
+                return lhs.startLine < rhs.startLine || (lhs.startLine == rhs.startLine && lhs.startColumn < rhs.startColumn);
+            return rhs < lhs;
+        });
+
+        static const uint32_t multiMethod = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> levels(inputData.size());
+        std::vector<uint32_t> levelSizes;
+        std::unordered_map<method_data_t, std::vector<mdMethodDef>, method_data_t_hash> multiMethodBpData;
+        std::vector<const method_data_t*> stack;
+        for (size_t i = 0; i < inputData.size(); i++)
         {
-            if (p->moduleMethodsData)
+            const method_data_t &entry = inputData[i];
+            // pop methods that don't enclose entry (ended before entry or at same position)
+            while (!stack.empty() && !(entry < *stack.back()))
             {
-                for (int32_t i = 0; i < p->fileNum; i++)
-                {
-                    if (p->moduleMethodsData[i].document)
-                        Interop::SysFreeString(p->moduleMethodsData[i].document);
-                    if (p->moduleMethodsData[i].methodsData)
-                        Interop::CoTaskMemFree(p->moduleMethodsData[i].methodsData);
-                }
-                Interop::CoTaskMemFree(p->moduleMethodsData);
+                const method_data_t &top = *stack.back();
+                // same data that was already added, but with different method token (constructors case)
+                if (!(top < entry))
+                    break;
+                stack.pop_back();
+            }
+            if (!stack.empty() && !(entry < *stack.back()))
+            {
+                const method_data_t &top = *stack.back();
+                method_data_t key(top.methodDef, entry.startLine, entry.endLine, entry.startColumn, entry.endColumn);
+                multiMethodBpData[key].emplace_back(entry.methodDef);
+                levels[i] = multiMethod;
+                continue;
             }
-            Interop::CoTaskMemFree(p);
-        }
-    };
 
-    // Note, we use std::map since we need container that will not invalidate iterators on add new elements.
-    void AddMethodData(/*in,out*/ std::map<size_t, std::set<method_data_t>> &methodData,
-                       /*in,out*/ std::unordered_map<method_data_t, std::vector<mdMethodDef>, method_data_t_hash> &multiMethodBpData,
-                       const method_data_t &entry,
-                       const size_t nestedLevel)
-    {
-        // if we here, we need at least one nested level for sure
-        if (methodData.empty())
-        {
-            methodData.emplace(std::make_pair(0, std::set<method_data_t>{entry}));
-            return;
+            levels[i] = (uint32_t)stack.size();
+            if (levelSizes.size() == stack.size())
+                levelSizes.emplace_back(0);
+            levelSizes[stack.size()]++;
+            stack.emplace_back(&entry);
         }
-        assert(nestedLevel <= methodData.size()); // could be increased only at 1 per recursive call
-        if (nestedLevel == methodData.size())
+
+        methodsIndex.levelsOffsets.resize(levelSizes.size() + 1);
+        methodsIndex.levelsOffsets[0] = 0;
+        for (size_t i = 0; i < levelSizes.size(); i++)
         {
-            methodData.emplace(std::make_pair(nestedLevel, std::set<method_data_t>{entry}));
-            return;
+            methodsIndex.levelsOffsets[i + 1] = methodsIndex.levelsOffsets[i] + levelSizes[i];
         }
-
-        // same data that was already added, but with different method token (constructors case)
-        auto find = methodData[nestedLevel].find(entry);
-        if (find != methodData[nestedLevel].end())
+        std::vector<method_data_t> levelsData(methodsIndex.levelsOffsets.back());
+        std::vector<uint32_t> positions(methodsIndex.levelsOffsets.begin(), methodsIndex.levelsOffsets.end() - 1);
+        for (size_t i = 0; i < inputData.size(); i++)
         {
-            method_data_t key(find->methodDef, entry.startLine, entry.endLine, entry.startColumn, entry.endColumn);
-            auto find_multi = multiMethodBpData.find(key);
-            if (find_multi == multiMethodBpData.end())
-                multiMethodBpData.emplace(std::make_pair(key, std::vector<mdMethodDef>{entry.methodDef}));
-            else
-                find_multi->second.emplace_back(entry.methodDef);
-
-            return;
+            if (levels[i] != multiMethod)
+                levelsData[positions[levels[i]]++] = inputData[i];
         }
-
-        auto it = methodData[nestedLevel].lower_bound(entry);
-        if (it != methodData[nestedLevel].end() && entry.NestedInto(*it))
+        // Level could be unordered only in case methods ranges overlap without nesting (broken PDB data).
+        for (size_t i = 0; i < levelSizes.size(); i++)
         {
-            AddMethodData(methodData, multiMethodBpData, entry, nestedLevel + 1);
-            return;
+            auto first = levelsData.begin() + methodsIndex.levelsOffsets[i];
+            auto last = levelsData.begin() + methodsIndex.levelsOffsets[i + 1];
+            if (!std::is_sorted(first, last))
+                std::sort(first, last);
         }
 
-        // case with only one element on nested level, NestedInto() was already called and entry checked
-        if (it == methodData[nestedLevel].begin())
+        methodsIndex.methodsData.clear();
+        methodsIndex.methodsData.reserve(levelsData.size());
+        methodsIndex.overflowMethodsData.clear();
+        for (size_t i = 0; i < levelsData.size(); i++)
         {
-            methodData[nestedLevel].emplace(entry);
-            return;
+            methodsIndex.methodsData.emplace_back(levelsData[i]);
+            if (methodsIndex.methodsData.back().Overflow())
+                methodsIndex.overflowMethodsData.emplace_back((uint32_t)i, levelsData[i]);
         }
+        methodsIndex.overflowMethodsData.shrink_to_fit();
 
-        // move all previously added nested for new entry elements to level above
-        do
+        methodsIndex.multiMethodsData.clear();
+        methodsIndex.multiMethodsTokens.clear();
+        methodsIndex.multiMethodsData.reserve(multiMethodBpData.size());
+        for (const auto &data : multiMethodBpData)
         {
-            it = std::prev(it);
-
-            if ((*it).NestedInto(entry))
-            {
-                method_data_t tmp = *it;
-                it = methodData[nestedLevel].erase(it);
-                AddMethodData(methodData, multiMethodBpData, tmp, nestedLevel + 1);
-            }
-            else
-                break;
+            methodsIndex.multiMethodsData.emplace_back(data.first, (uint32_t)methodsIndex.multiMethodsTokens.size(), (uint32_t)data.second.size());
+            methodsIndex.multiMethodsTokens.insert(methodsIndex.multiMethodsTokens.end(), data.second.begin(), data.second.end());
         }
-        while(it != methodData[nestedLevel].begin());
-
-        methodData[nestedLevel].emplace(entry);
+        methodsIndex.multiMethodsTokens.shrink_to_fit();
+        std::sort(methodsIndex.multiMethodsData.begin(), methodsIndex.multiMethodsData.end(),
+                  [](const multi_method_data_t &lhs, const multi_method_data_t &rhs) { return MultiMethodDataLess(lhs, rhs.methodData); });
     }
 
 
-    bool GetMethodTokensByLineNumber(const std::vector<std::vector<method_data_t>> &methodBpData,
-                                     const std::unordered_map<method_data_t, std::vector<mdMethodDef>, method_data_t_hash> &multiMethodBpData,
+    bool GetMethodTokensByLineNumber(const methods_index_t &methodsIndex,
                                      /*in,out*/ int32_t &lineNum,
                                      /*out*/ std::vector<mdMethodDef> &Tokens,
                                      /*out*/ mdMethodDef &closestNestedToken)
     {
-        const method_data_t *result = nullptr;
+        const packed_method_data_t *result = nullptr;
         closestNestedToken = 0;
 
-        for (auto it = methodBpData.cbegin(); it != methodBpData.cend(); ++it)
+        for (size_t level = 0; level + 1 < methodsIndex.levelsOffsets.size(); level++)
         {
-            auto lower = std::lower_bound((*it).cbegin(), (*it).cend(), lineNum);
-            if (lower == (*it).cend())
+            auto first = methodsIndex.methodsData.cbegin() + methodsIndex.levelsOffsets[level];
+            auto last = methodsIndex.methodsData.cbegin() + methodsIndex.levelsOffsets[level + 1];
+            auto lower = std::lower_bound(first, last, lineNum);
+            if (lower == last)
                 break; // point behind last method for this nested level
 
             // case with first line of method, for example:
@@ -170,7 +162,7 @@ namespace
             // out of first level methods lines - forced move line to first method below, for example:
             //  <-- breakpoint at line without code (out of any methods)
             // void Method() {...}
-            else if (it == methodBpData.cbegin() && lineNum < (*lower).startLine)
+            else if (level == 0 && lineNum < (*lower).startLine)
             {
                 lineNum = (*lower).startLine;
                 result = &(*lower);
@@ -193,11 +185,12 @@ namespace
 
         if (result)
         {
-            auto find = multiMethodBpData.find(*result);
-            if (find != multiMethodBpData.end()) // only constructors segments could be part of multiple methods
+            const method_data_t resultData = methodsIndex.GetMethodData((uint32_t)(result - methodsIndex.methodsData.data()));
+            auto find = std::lower_bound(methodsIndex.multiMethodsData.begin(), methodsIndex.multiMethodsData.end(), resultData, MultiMethodDataLess);
+            if (find != methodsIndex.multiMethodsData.end() && find->methodData == resultData) // only constructors segments could be part of multiple methods
             {
-                Tokens.resize((*find).second.size());
-                std::copy(find->second.begin(), find->second.end(), Tokens.begin());
+                auto tokens = methodsIndex.multiMethodsTokens.begin() + find->tokensOffset;
+                Tokens.assign(tokens, tokens + find->tokensCount);
             }
             Tokens.emplace_back(result->methodDef);
         }
@@ -207,8 +200,21 @@ namespace
 
 } // unnamed namespace
 
+method_data_t methods_index_t::GetMethodData(uint32_t index) const
+{
+    const packed_method_data_t &data = methodsData[index];
+    if (!data.Overflow())
+        return method_data_t(data.methodDef, data.startLine, data.endLine, data.startColumn, data.endColumn);
+
+    auto find = std::lower_bound(overflowMethodsData.begin(), overflowMethodsData.end(), index,
+                                 [](const std::pair<uint32_t, method_data_t> &lhs, uint32_t rhs) { return lhs.first < rhs; });
+    assert(find != overflowMethodsData.end() && find->first == index);
+    return find->second;
+}
+
+// Note, filesData and methodsData are used as buffers and could be reused by caller for next modules.
 static HRESULT GetPdbMethodsRanges(IMetaDataImport *pMDImport, PVOID pSymbolReaderHandle, std::unordered_set<mdMethodDef> *methodTokens,
-                                   std::unique_ptr<module_methods_data_t, module_methods_data_t_deleter> &inputData)
+                                   std::vector<Interop::FileMethodsData> &filesData, std::vector<method_data_t> &methodsData)
 {
     HRESULT Status;
     // Note, we need 2 arrays of tokens - for normal methods and constructors (.ctor/.cctor, that could have segmented code).
@@ -252,41 +258,137 @@ static HRESULT GetPdbMethodsRanges(IMetaDataImport *pMDImport, PVOID pSymbolRead
         return E_FAIL;
     }
 
-    PVOID data = nullptr;
-    IfFailRet(Interop::GetModuleMethodsRanges(pSymbolReaderHandle, (uint32_t)constrTokens.size(), constrTokens.data(), (uint32_t)normalTokens.size(), normalTokens.data(), &data));
-    if (data == nullptr)
-        return S_OK;
-
-    inputData.reset((module_methods_data_t*)data);
-    return S_OK;
+    return Interop::GetModuleMethodsRanges(pSymbolReaderHandle, (uint32_t)constrTokens.size(), constrTokens.data(), (uint32_t)normalTokens.size(), normalTokens.data(),
+                                           filesData, methodsData);
 }
 
-static std::string GetFileName(const std::string &path)
+static Utility::string_view GetFileName(Utility::string_view path)
 {
     std::size_t i = path.find_last_of("/\\");
     return i == std::string::npos ? path : path.substr(i + 1);
 }
 
+Utility::string_view ModulesSources::PathsArena::Add(Utility::string_view path)
+{
+    // Note, writer could add paths into last block, that is shared with published snapshot, but readers never access
+    // memory behind paths from their snapshot.
+    static const size_t defaultBlockSize = 64 * 1024;
+    const size_t size = path.size() + 1;
+    if (m_blocks.empty() || m_lastBlockSize - m_lastBlockUsed < size)
+    {
+        m_lastBlockSize = std::max(defaultBlockSize, size);
+        m_lastBlockUsed = 0;
+        m_blocks.emplace_back(new char[m_lastBlockSize], std::default_delete<char[]>());
+    }
+
+    char *result = m_blocks.back().get() + m_lastBlockUsed;
+    memcpy(result, path.data(), path.size());
+    result[path.size()] = '\0';
+    m_lastBlockUsed += size;
+    return Utility::string_view(result, path.size());
+}
+
+HRESULT ModulesSources::DeferSourcesCodeLinesForModule(ICorDebugModule *pModule, IMetaDataImport *pMDImport, PVOID pSymbolReaderHandle)
+{
+    HRESULT Status;
+    CORDB_ADDRESS modAddress;
+    IfFailRet(pModule->GetBaseAddress(&modAddress));
+
+    pModule->AddRef();
+    pMDImport->AddRef();
+    std::lock_guard<std::mutex> lock(m_deferredModulesMutex);
+    m_deferredModules.emplace_back(modAddress, pModule, pMDImport, pSymbolReaderHandle);
+    m_haveDeferredModules = true;
+    return S_OK;
+}
+
+void ModulesSources::ClearDeferredModules()
+{
+    std::lock_guard<std::mutex> lock(m_deferredModulesMutex);
+    m_deferredModules.clear();
+    m_haveDeferredModules = false;
+}
+
+// Caller must care about m_deferredModulesMutex.
+bool ModulesSources::IsDeferredModuleHaveFile(DeferredModule &deferredModule, Utility::string_view fileName)
+{
+    if (!deferredModule.fileNamesLoaded)
+    {
+        // Note, only documents names are read from PDB, this is much cheaper than methods ranges load for sources indexing.
+        std::vector<std::string> documentNames;
+        if (FAILED(Interop::GetDocumentNames(deferredModule.pSymbolReaderHandle, documentNames)))
+            return true; // can't check, index module
+
+        for (auto &documentName : documentNames)
+        {
+#ifdef WIN32
+            if (FAILED(Interop::StringToUpper(documentName)))
+                return true;
+#endif
+            deferredModule.fileNames.emplace(GetFileName(documentName));
+        }
+        deferredModule.fileNamesLoaded = true;
+    }
+
+    return deferredModule.fileNames.find(std::string(fileName)) != deferredModule.fileNames.end();
+}
+
+void ModulesSources::IndexDeferredModules(CORDB_ADDRESS modAddress, const std::string &filename)
+{
+    if (!m_haveDeferredModules)
+        return;
+
+    // Note, file name check is enough here, since protocols could provide source path relative to project directory.
+    std::string fileName(GetFileName(filename));
+#ifdef WIN32
+    if (FAILED(Interop::StringToUpper(fileName)))
+        fileName.clear();
+#endif
+
+    std::lock_guard<std::mutex> lock(m_deferredModulesMutex);
+    for (auto it = m_deferredModules.begin(); it != m_deferredModules.end();)
+    {
+        if ((modAddress != 0 && it->modAddress != modAddress) ||
+            (!fileName.empty() && !IsDeferredModuleHaveFile(*it, fileName)))
+        {
+            ++it;
+            continue;
+        }
+
+        if (FAILED(FillSourcesCodeLinesForModule(it->iCorModule, it->iMDImport, it->pSymbolReaderHandle)))
+            LOGE("Could not load source lines related info from PDB file. Could produce failures during breakpoint's source path resolve in future.");
+
+        it = m_deferredModules.erase(it);
+    }
+    m_haveDeferredModules = !m_deferredModules.empty();
+}
+
+std::shared_ptr<const ModulesSources::SourcesInfo> ModulesSources::GetSourcesInfo() const
+{
+    return std::atomic_load(&m_sourcesInfo);
+}
+
 // Caller must care about m_sourcesInfoMutex.
-HRESULT ModulesSources::GetFullPathIndex(BSTR document, unsigned &fullPathIndex)
+HRESULT ModulesSources::GetFullPathIndex(SourcesInfo &sourcesInfo, const std::string &document, unsigned &fullPathIndex)
 {
-    std::string fullPath = to_utf8(document);
+    std::string fullPath = document;
 #ifdef WIN32
     HRESULT Status;
     std::string initialFullPath = fullPath;
     IfFailRet(Interop::StringToUpper(fullPath));
 #endif
-    auto findPathIndex = m_sourcePathToIndex.find(fullPath);
-    if (findPathIndex == m_sourcePathToIndex.end())
+    auto findPathIndex = sourcesInfo.sourcePathToIndex.find(Utility::string_view(fullPath));
+    if (findPathIndex == sourcesInfo.sourcePathToIndex.end())
     {
-        fullPathIndex = (unsigned)m_sourceIndexToPath.size();
-        m_sourcePathToIndex.emplace(std::make_pair(fullPath, fullPathIndex));
-        m_sourceIndexToPath.emplace_back(fullPath);
+        fullPathIndex = (unsigned)sourcesInfo.sourceIndexToPath.size();
+        Utility::string_view path = sourcesInfo.paths.Add(fullPath);
+        sourcesInfo.sourcePathToIndex.emplace(std::make_pair(path, fullPathIndex));
+        sourcesInfo.sourceIndexToPath.emplace_back(path);
 #ifdef WIN32
-        m_sourceIndexToInitialFullPath.emplace_back(initialFullPath);
+        sourcesInfo.sourceIndexToInitialFullPath.emplace_back(sourcesInfo.paths.Add(initialFullPath));
 #endif
-        m_sourceNameToFullPathsIndexes[GetFileName(fullPath)].emplace(fullPathIndex);
-        m_sourcesMethodsData.emplace_back(std::vector<FileMethodsData>{});
+        sourcesInfo.sourceNameToFullPathsIndexes[GetFileName(path)].emplace_back(fullPathIndex);
+        sourcesInfo.sourcesMethodsData.emplace_back(std::make_shared<std::vector<FileMethodsData>>());
     }
     else
         fullPathIndex = findPathIndex->second;
@@ -299,67 +401,54 @@ HRESULT ModulesSources::FillSourcesCodeLinesForModule(ICorDebugModule *pModule,
     std::lock_guard<std::mutex> lock(m_sourcesInfoMutex);
 
     HRESULT Status;
-    std::unique_ptr<module_methods_data_t, module_methods_data_t_deleter> inputData;
-    IfFailRet(GetPdbMethodsRanges(pMDImport, pSymbolReaderHandle, nullptr, inputData));
-    if (inputData == nullptr)
+    IfFailRet(GetPdbMethodsRanges(pMDImport, pSymbolReaderHandle, nullptr, m_filesDataBuffer, m_methodsDataBuffer));
+    if (m_filesDataBuffer.empty())
         return S_OK;
 
+    std::shared_ptr<SourcesInfo> sourcesInfo = std::make_shared<SourcesInfo>(*GetSourcesInfo());
+
     // Usually, modules provide files with unique full paths for sources.
-    m_sourceIndexToPath.reserve(m_sourceIndexToPath.size() + inputData->fileNum);
-    m_sourcesMethodsData.reserve(m_sourcesMethodsData.size() + inputData->fileNum);
+    sourcesInfo->sourceIndexToPath.reserve(sourcesInfo->sourceIndexToPath.size() + m_filesDataBuffer.size());
+    sourcesInfo->sourcesMethodsData.reserve(sourcesInfo->sourcesMethodsData.size() + m_filesDataBuffer.size());
 #ifdef WIN32
-    m_sourceIndexToInitialFullPath.reserve(m_sourceIndexToInitialFullPath.size() + inputData->fileNum);
+    sourcesInfo->sourceIndexToInitialFullPath.reserve(sourcesInfo->sourceIndexToInitialFullPath.size() + m_filesDataBuffer.size());
 #endif
 
     CORDB_ADDRESS modAddress;
     IfFailRet(pModule->GetBaseAddress(&modAddress));
 
-    for (int i = 0; i < inputData->fileNum; i++)
+    std::string document;
+    const method_data_t *methodsData = m_methodsDataBuffer.data();
+    for (const auto &fileData : m_filesDataBuffer)
     {
         unsigned fullPathIndex;
-        IfFailRet(GetFullPathIndex(inputData->moduleMethodsData[i].document, fullPathIndex));
+        IfFailRet(Interop::GetDocumentName(pSymbolReaderHandle, fileData.documentIndex, document));
+        IfFailRet(GetFullPathIndex(*sourcesInfo, document, fullPathIndex));
 
-        m_sourcesMethodsData[fullPathIndex].emplace_back(FileMethodsData{});
-        auto &fileMethodsData = m_sourcesMethodsData[fullPathIndex].back();
+        std::shared_ptr<std::vector<FileMethodsData>> filesMethodsData =
+            std::make_shared<std::vector<FileMethodsData>>(*sourcesInfo->sourcesMethodsData[fullPathIndex]);
+        filesMethodsData->emplace_back(FileMethodsData{});
+        auto &fileMethodsData = filesMethodsData->back();
         fileMethodsData.modAddress = modAddress;
 
-        // Note, don't reorder input data, since it have almost ideal order for us.
-        // For example, for Private.CoreLib (about 22000 methods) only 8 relocations were made.
-        // In case default methods ordering will be dramatically changed, we could use data reordering,
-        // for example based on this solution:
-        //    struct compare {
-        //        bool operator()(const method_data_t &lhs, const method_data_t &rhs) const
-        //        { return lhs.endLine > rhs.endLine || (lhs.endLine == rhs.endLine && lhs.endColumn > rhs.endColumn); }
-        //    };
-        //    std::multiset<method_data_t, compare> orderedInputData;
-        std::map<size_t, std::set<method_data_t>> inputMethodsData;
-        for (int j = 0; j < inputData->moduleMethodsData[i].methodNum; j++)
-        {
-            AddMethodData(inputMethodsData, fileMethodsData.multiMethodsData, inputData->moduleMethodsData[i].methodsData[j], 0);
-        }
-
-        fileMethodsData.methodsData.resize(inputMethodsData.size());
-        for (size_t i =  0; i < inputMethodsData.size(); i++)
-        {
-            fileMethodsData.methodsData[i].resize(inputMethodsData[i].size());
-            std::copy(inputMethodsData[i].begin(), inputMethodsData[i].end(), fileMethodsData.methodsData[i].begin());
-        }
-        for (auto &data : fileMethodsData.multiMethodsData)
-        {
-            data.second.shrink_to_fit();
-        }
+        std::vector<method_data_t> inputMethodsData(methodsData, methodsData + fileData.methodNum);
+        methodsData += fileData.methodNum;
+        BuildMethodsData(inputMethodsData, fileMethodsData.methodsIndex);
+        sourcesInfo->sourcesMethodsData[fullPathIndex] = std::move(filesMethodsData);
     }
 
-    m_sourcesMethodsData.shrink_to_fit();
-    m_sourceIndexToPath.shrink_to_fit();
+    sourcesInfo->sourcesMethodsData.shrink_to_fit();
+    sourcesInfo->sourceIndexToPath.shrink_to_fit();
 #ifdef WIN32
-    m_sourceIndexToInitialFullPath.shrink_to_fit();
+    sourcesInfo->sourceIndexToInitialFullPath.shrink_to_fit();
 #endif
 
+    std::atomic_store(&m_sourcesInfo, std::shared_ptr<const SourcesInfo>(std::move(sourcesInfo)));
     return S_OK;
 }
 
-HRESULT ModulesSources::LineUpdatesForMethodData(ICorDebugModule *pModule, unsigned fullPathIndex, method_data_t &methodData,
+// Caller must care about m_sourcesInfoMutex.
+HRESULT ModulesSources::LineUpdatesForMethodData(SourcesInfo &sourcesInfo, ICorDebugModule *pModule, unsigned fullPathIndex, method_data_t &methodData,
                                                  const std::vector<block_update_t> &blockUpdate, ModuleInfo &mdInfo)
 {
     int32_t startLineOffset = 0;
@@ -404,34 +493,25 @@ HRESULT ModulesSources::LineUpdatesForMethodData(ICorDebugModule *pModule, unsig
             if (mdInfo.m_symbolReaderHandles.empty() || mdInfo.m_symbolReaderHandles.size() < methodVersion)
                 return E_FAIL;
 
-            Interop::SequencePoint *sequencePoints = nullptr;
-            int32_t count = 0;
-            if (FAILED(Status = Interop::GetSequencePoints(mdInfo.m_symbolReaderHandles[methodVersion - 1], methodData.methodDef, &sequencePoints, count)))
+            PVOID pSymbolReaderHandle = mdInfo.m_symbolReaderHandles[methodVersion - 1];
+            IfFailRet(Interop::GetSequencePoints(pSymbolReaderHandle, methodData.methodDef, m_sequencePointsBuffer));
+
+            // Method's sequence points usually refer one or few documents, resolve each document name only once.
+            std::unordered_map<int32_t, unsigned> documentsIndexes;
+            std::string document;
+            for (const auto &sequencePoint : m_sequencePointsBuffer)
             {
-                if (sequencePoints)
+                auto findIndex = documentsIndexes.find(sequencePoint.documentIndex);
+                if (findIndex == documentsIndexes.end())
                 {
-                    for (int i = 0; i < count; i++)
-                    {
-                        Interop::SysFreeString(sequencePoints[i].document);
-                    }
-                    Interop::CoTaskMemFree(sequencePoints);
+                    unsigned index;
+                    IfFailRet(Interop::GetDocumentName(pSymbolReaderHandle, sequencePoint.documentIndex, document));
+                    IfFailRet(GetFullPathIndex(sourcesInfo, document, index));
+                    findIndex = documentsIndexes.emplace(sequencePoint.documentIndex, index).first;
                 }
 
-                return Status;
+                mdInfo.m_methodBlockUpdates[methodData.methodDef].emplace_back(findIndex->second, sequencePoint.startLine, sequencePoint.startLine, sequencePoint.endLine - sequencePoint.startLine);
             }
-
-            for (int i = 0; i < count; i++)
-            {
-                unsigned index;
-                IfFailRet(GetFullPathIndex(sequencePoints[i].document, index));
-                Interop::SysFreeString(sequencePoints[i].document);
-
-                mdInfo.m_methodBlockUpdates[methodData.methodDef].emplace_back(index, sequencePoints[i].startLine, sequencePoints[i].startLine, sequencePoints[i].endLine - sequencePoints[i].startLine);
-
-            }
-
-            if (sequencePoints)
-                Interop::CoTaskMemFree(sequencePoints);
         }
 
         for (std::size_t i = 0; i < mdInfo.m_methodBlockUpdates[methodData.methodDef].size(); ++i)
@@ -474,27 +554,29 @@ HRESULT ModulesSources::UpdateSourcesCodeLinesForModule(ICorDebugModule *pModule
     std::lock_guard<std::mutex> lock(m_sourcesInfoMutex);
 
     HRESULT Status;
-    std::unique_ptr<module_methods_data_t, module_methods_data_t_deleter> inputData;
-    IfFailRet(GetPdbMethodsRanges(pMDImport, mdInfo.m_symbolReaderHandles.back(), &methodTokens, inputData));
+    PVOID pSymbolReaderHandle = mdInfo.m_symbolReaderHandles.back();
+    IfFailRet(GetPdbMethodsRanges(pMDImport, pSymbolReaderHandle, &methodTokens, m_filesDataBuffer, m_methodsDataBuffer));
 
     struct src_update_data_t
     {
         std::vector<block_update_t> blockUpdate;
         int32_t methodNum = 0;
-        method_data_t *methodsData = nullptr;
+        method_data_t *methodsData = nullptr; // points into m_methodsDataBuffer
     };
     std::unordered_map<unsigned, src_update_data_t> srcUpdateData;
+    std::shared_ptr<SourcesInfo> sourcesInfo = std::make_shared<SourcesInfo>(*GetSourcesInfo());
 
-    if (inputData)
+    std::string document;
+    method_data_t *methodsData = m_methodsDataBuffer.data();
+    for (const auto &fileData : m_filesDataBuffer)
     {
-        for (int i = 0; i < inputData->fileNum; i++)
-        {
-            unsigned fullPathIndex;
-            IfFailRet(GetFullPathIndex(inputData->moduleMethodsData[i].document, fullPathIndex));
+        unsigned fullPathIndex;
+        IfFailRet(Interop::GetDocumentName(pSymbolReaderHandle, fileData.documentIndex, document));
+        IfFailRet(GetFullPathIndex(*sourcesInfo, document, fullPathIndex));
 
-            srcUpdateData[fullPathIndex].methodNum = inputData->moduleMethodsData[i].methodNum;
-            srcUpdateData[fullPathIndex].methodsData = inputData->moduleMethodsData[i].methodsData;
-        }
+        srcUpdateData[fullPathIndex].methodNum = fileData.methodNum;
+        srcUpdateData[fullPathIndex].methodsData = methodsData;
+        methodsData += fileData.methodNum;
     }
     for (const auto &entry : srcBlockUpdates)
     {
@@ -511,17 +593,16 @@ HRESULT ModulesSources::UpdateSourcesCodeLinesForModule(ICorDebugModule *pModule
     {
         const unsigned fullPathIndex = updateData.first;
 
-        std::map<size_t, std::set<method_data_t>> inputMethodsData;
-        if (m_sourcesMethodsData[fullPathIndex].empty())
+        std::shared_ptr<std::vector<FileMethodsData>> filesMethodsData =
+            std::make_shared<std::vector<FileMethodsData>>(*sourcesInfo->sourcesMethodsData[fullPathIndex]);
+        std::vector<method_data_t> inputMethodsData;
+        if (filesMethodsData->empty())
         { // New source file added.
-            m_sourcesMethodsData[fullPathIndex].emplace_back(FileMethodsData{});
-            auto &tmpFileMethodsData = m_sourcesMethodsData[fullPathIndex].back();
+            filesMethodsData->emplace_back(FileMethodsData{});
+            auto &tmpFileMethodsData = filesMethodsData->back();
             tmpFileMethodsData.modAddress = modAddress;
 
-            for (int j = 0; j < updateData.second.methodNum; j++)
-            {
-                AddMethodData(inputMethodsData, tmpFileMethodsData.multiMethodsData, updateData.second.methodsData[j], 0);
-            }
+            inputMethodsData.assign(updateData.second.methodsData, updateData.second.methodsData + updateData.second.methodNum);
         }
         else
         {
@@ -535,73 +616,116 @@ HRESULT ModulesSources::UpdateSourcesCodeLinesForModule(ICorDebugModule *pModule
 
             // Move multiMethodsData first (since this is constructors and all will be on level 0 for sure).
             // Use std::unordered_set here instead array for fast search.
-            auto &tmpFileMethodsData = m_sourcesMethodsData[fullPathIndex].back();
+            auto &tmpFileMethodsData = filesMethodsData->back();
             std::vector<method_data_t> tmpMultiMethodsData;
-            for (const auto &entryData : tmpFileMethodsData.multiMethodsData)
+            const methods_index_t &methodsIndex = tmpFileMethodsData.methodsIndex;
+            for (const auto &entryData : methodsIndex.multiMethodsData)
             {
-                auto findData = inputMetodDefSet.find(entryData.first.methodDef);
+                const method_data_t &methodData = entryData.methodData;
+                auto findData = inputMetodDefSet.find(methodData.methodDef);
                 if (findData == inputMetodDefSet.end())
-                    tmpMultiMethodsData.emplace_back(entryData.first);
+                    tmpMultiMethodsData.emplace_back(methodData);
 
-                for (const auto &entryMethodDef : entryData.second)
+                for (uint32_t i = entryData.tokensOffset; i < entryData.tokensOffset + entryData.tokensCount; i++)
                 {
+                    const mdMethodDef entryMethodDef = methodsIndex.multiMethodsTokens[i];
                     findData = inputMetodDefSet.find(entryMethodDef);
                     if (findData == inputMetodDefSet.end())
-                        tmpMultiMethodsData.emplace_back(entryMethodDef, entryData.first.startLine, entryData.first.endLine,
-                                                         entryData.first.startColumn, entryData.first.endColumn);
+                        tmpMultiMethodsData.emplace_back(entryMethodDef, methodData.startLine, methodData.endLine,
+                                                         methodData.startColumn, methodData.endColumn);
                 }
             }
 
-            tmpFileMethodsData.multiMethodsData.clear();
             for (auto &methodData : tmpMultiMethodsData)
             {
-                IfFailRet(LineUpdatesForMethodData(pModule, fullPathIndex, methodData, updateData.second.blockUpdate, mdInfo));
-                AddMethodData(inputMethodsData, tmpFileMethodsData.multiMethodsData, methodData, 0);
+                IfFailRet(LineUpdatesForMethodData(*sourcesInfo, pModule, fullPathIndex, methodData, updateData.second.blockUpdate, mdInfo));
+                inputMethodsData.emplace_back(methodData);
             }
 
             // Move normal methods.
-            for (auto &methodsData : tmpFileMethodsData.methodsData)
+            for (uint32_t i = 0; i < (uint32_t)methodsIndex.methodsData.size(); i++)
             {
-                for (auto &methodData : methodsData)
+                method_data_t methodData = methodsIndex.GetMethodData(i);
+                auto findData = inputMetodDefSet.find(methodData.methodDef);
+                if (findData == inputMetodDefSet.end())
                 {
-                    auto findData = inputMetodDefSet.find(methodData.methodDef);
-                    if (findData == inputMetodDefSet.end())
-                    {
-                        IfFailRet(LineUpdatesForMethodData(pModule, fullPathIndex, methodData, updateData.second.blockUpdate, mdInfo));
-                        AddMethodData(inputMethodsData, tmpFileMethodsData.multiMethodsData, methodData, 0);
-                    }
+                    IfFailRet(LineUpdatesForMethodData(*sourcesInfo, pModule, fullPathIndex, methodData, updateData.second.blockUpdate, mdInfo));
+                    inputMethodsData.emplace_back(methodData);
                 }
             }
-            tmpFileMethodsData.methodsData.clear();
 
             // Move new and modified methods.
-            for (int j = 0; j < updateData.second.methodNum; j++)
+            inputMethodsData.insert(inputMethodsData.end(), updateData.second.methodsData, updateData.second.methodsData + updateData.second.methodNum);
+        }
+
+        auto &fileMethodsData = filesMethodsData->back();
+        BuildMethodsData(inputMethodsData, fileMethodsData.methodsIndex);
+        sourcesInfo->sourcesMethodsData[fullPathIndex] = std::move(filesMethodsData);
+    }
+
+    std::atomic_store(&m_sourcesInfo, std::shared_ptr<const SourcesInfo>(std::move(sourcesInfo)));
+    return S_OK;
+}
+
+HRESULT ModulesSources::GetIndexByProtocolPath(const SourcesInfo &sourcesInfo, const std::string &filename, unsigned &index)
+{
+    const size_t sourcesCount = sourcesInfo.sourceIndexToPath.size();
+    {
+        std::lock_guard<std::mutex> lock(m_pathsCacheMutex);
+        if (m_pathsCacheSourcesCount < sourcesCount)
+        {
+            m_pathsCache.clear();
+            m_pathsCacheSourcesCount = sourcesCount;
+        }
+        else if (m_pathsCacheSourcesCount == sourcesCount)
+        {
+            auto findCached = m_pathsCache.find(filename);
+            if (findCached != m_pathsCache.end())
             {
-                AddMethodData(inputMethodsData, tmpFileMethodsData.multiMethodsData, updateData.second.methodsData[j], 0);
+                index = findCached->second;
+                return index == InvalidIndex ? E_FAIL : S_OK;
             }
         }
+    }
+
+    std::string path = filename;
+#ifdef WIN32
+    HRESULT Status;
+    IfFailRet(Interop::StringToUpper(path));
+#endif
 
-        auto &fileMethodsData = m_sourcesMethodsData[fullPathIndex].back();
-        fileMethodsData.methodsData.resize(inputMethodsData.size());
-        for (size_t i =  0; i < inputMethodsData.size(); i++)
+    auto findIndex = sourcesInfo.sourcePathToIndex.find(Utility::string_view(path));
+    if (findIndex == sourcesInfo.sourcePathToIndex.end())
+    {
+        // Check for absolute path.
+#ifdef WIN32
+        // Check, if start from drive letter, for example "D:\" or "D:/".
+        if (path.size() > 2 && path[1] == ':' && (path[2] == '/' || path[2] == '\\'))
+#else
+        if (path[0] == '/')
+#endif
         {
-            fileMethodsData.methodsData[i].resize(inputMethodsData[i].size());
-            std::copy(inputMethodsData[i].begin(), inputMethodsData[i].end(), fileMethodsData.methodsData[i].begin());
+            findIndex = sourcesInfo.sourcePathToIndex.end();
         }
-        for (auto &data : fileMethodsData.multiMethodsData)
+        else if (SUCCEEDED(ResolveRelativeSourceFileName(sourcesInfo, path)))
         {
-            data.second.shrink_to_fit();
+            findIndex = sourcesInfo.sourcePathToIndex.find(Utility::string_view(path));
         }
     }
 
-    return S_OK;
+    index = findIndex == sourcesInfo.sourcePathToIndex.end() ? InvalidIndex : findIndex->second;
+
+    std::lock_guard<std::mutex> lock(m_pathsCacheMutex);
+    if (m_pathsCacheSourcesCount == sourcesCount)
+        m_pathsCache[filename] = index;
+
+    return index == InvalidIndex ? E_FAIL : S_OK;
 }
 
-HRESULT ModulesSources::ResolveRelativeSourceFileName(std::string &filename)
+HRESULT ModulesSources::ResolveRelativeSourceFileName(const SourcesInfo &sourcesInfo, std::string &filename)
 {
-    // IMPORTANT! Caller should care about m_sourcesInfoMutex.
-    auto findIndexesByFileName = m_sourceNameToFullPathsIndexes.find(GetFileName(filename));
-    if (findIndexesByFileName == m_sourceNameToFullPathsIndexes.end())
+    auto findIndexesByFileName = sourcesInfo.sourceNameToFullPathsIndexes.find(GetFileName(filename));
+    if (findIndexesByFileName == sourcesInfo.sourceNameToFullPathsIndexes.end())
         return E_FAIL;
 
     auto const &possiblePathsIndexes = findIndexesByFileName->second;
@@ -633,16 +757,16 @@ HRESULT ModulesSources::ResolveRelativeSourceFileName(std::string &filename)
     if (result == GetFileName(result))
     {
         auto it = std::min_element(possiblePathsIndexes.begin(), possiblePathsIndexes.end(),
-                        [&](const unsigned a, const unsigned b){ return m_sourceIndexToPath[a].size() < m_sourceIndexToPath[b].size(); } );
+                        [&](const unsigned a, const unsigned b){ return sourcesInfo.sourceIndexToPath[a].size() < sourcesInfo.sourceIndexToPath[b].size(); } );
 
-        filename = it == possiblePathsIndexes.end() ? result : m_sourceIndexToPath[*it];
+        filename = it == possiblePathsIndexes.end() ? result : std::string(sourcesInfo.sourceIndexToPath[*it]);
         return S_OK;
     }
 
     std::list<std::string> possibleResults;
     for (const auto pathIndex : possiblePathsIndexes)
     {
-        if (result.size() > m_sourceIndexToPath[pathIndex].size())
+        if (result.size() > sourcesInfo.sourceIndexToPath[pathIndex].size())
             continue;
 
         // Note, since assemblies could be built in different OSes, we could have different delimiters in source files paths.
@@ -657,7 +781,7 @@ HRESULT ModulesSources::ResolveRelativeSourceFileName(std::string &filename)
         //    possibleResults.push_back(path);
         auto first1 = result.begin();
         auto last1 = result.end();
-        auto first2 = m_sourceIndexToPath[pathIndex].end() - result.size();
+        auto first2 = sourcesInfo.sourceIndexToPath[pathIndex].end() - result.size();
         auto equal = [&]()
         {
             for (; first1 != last1; ++first1, ++first2)
@@ -668,7 +792,7 @@ HRESULT ModulesSources::ResolveRelativeSourceFileName(std::string &filename)
             return true;
         };
         if (equal())
-            possibleResults.push_back(m_sourceIndexToPath[pathIndex]);
+            possibleResults.emplace_back(sourcesInfo.sourceIndexToPath[pathIndex]);
     }
     // The problem is - we could have several assemblies that could have sources with same relative paths with different path's root.
     // We don't really have a lot of options here, so, we assume, that all possible sources paths have same root and just find the shortest.
@@ -689,7 +813,7 @@ HRESULT ModulesSources::ResolveRelativeSourceFileName(std::string &filename)
 // Note, this is breakpoint only backward correction, that will care for "closest next executable code line" in PDB stored data.
 // We can't map line from new to old PDB location, since impossible map new added line data to PDB data that don't have this line.
 // Plus, methodBlockUpdates store sequence points only data.
-static void LineUpdatesBackwardCorrection(unsigned fullPathIndex, mdMethodDef methodToken, method_block_updates_t &methodBlockUpdates, int32_t &startLine)
+static void LineUpdatesBackwardCorrection(unsigned fullPathIndex, mdMethodDef methodToken, const method_block_updates_t &methodBlockUpdates, int32_t &startLine)
 {
     auto findSourceUpdate = methodBlockUpdates.find(methodToken);
     if (findSourceUpdate != methodBlockUpdates.end())
@@ -706,52 +830,19 @@ static void LineUpdatesBackwardCorrection(unsigned fullPathIndex, mdMethodDef me
     }
 }
 
-HRESULT ModulesSources::ResolveBreakpoint(/*in*/ Modules *pModules, /*in*/ CORDB_ADDRESS modAddress, /*in*/ std::string filename, /*out*/ unsigned &fullname_index,
+HRESULT ModulesSources::ResolveBreakpoint(/*in*/ Modules *pModules, /*in*/ CORDB_ADDRESS modAddress, /*in*/ const std::string &filename, /*out*/ unsigned &fullname_index,
                                           /*in*/ int sourceLine, /*out*/ std::vector<resolved_bp_t> &resolvedPoints)
 {
-    std::lock_guard<std::mutex> lockSourcesInfo(m_sourcesInfoMutex);
+    // Note, only modules with same source file name are indexed, other modules sources indexing still postponed.
+    IndexDeferredModules(modAddress, filename);
+    std::shared_ptr<const SourcesInfo> sourcesInfo = GetSourcesInfo();
 
     HRESULT Status;
-    auto findIndex = m_sourcePathToIndex.find(filename);
-    if (findIndex == m_sourcePathToIndex.end())
-    {
-        // Check for absolute path.
-#ifdef WIN32
-        // Check, if start from drive letter, for example "D:\" or "D:/".
-        if (filename.size() > 2 && filename[1] == ':' && (filename[2] == '/' || filename[2] == '\\'))
-#else
-        if (filename[0] == '/')
-#endif
-        {
-            return E_FAIL;
-        }
-
-        IfFailRet(ResolveRelativeSourceFileName(filename));
+    IfFailRet(GetIndexByProtocolPath(*sourcesInfo, filename, fullname_index));
 
-        findIndex = m_sourcePathToIndex.find(filename);
-        if (findIndex == m_sourcePathToIndex.end())
-            return E_FAIL;
-    }
-
-    fullname_index = findIndex->second;
-
-    struct resolved_input_bp_t
-    {
-        int32_t startLine;
-        int32_t endLine;
-        uint32_t ilOffset;
-        uint32_t methodToken;
-    };
-
-    struct resolved_input_bp_t_deleter
-    {
-        void operator()(resolved_input_bp_t *p) const
-        {
-            Interop::CoTaskMemFree(p);
-        }
-    };
-
-    for (const auto &sourceData : m_sourcesMethodsData[findIndex->second])
+    // Reused for all modules with this source, in order to avoid result buffer allocation for each managed call.
+    std::vector<Interop::ResolvedBreakpoint> inputData;
+    for (const auto &sourceData : *sourcesInfo->sourcesMethodsData[findIndex->second])
     {
         if (modAddress && modAddress != sourceData.modAddress)
             continue;
@@ -759,7 +850,7 @@ HRESULT ModulesSources::ResolveBreakpoint(/*in*/ Modules *pModules, /*in*/ CORDB
         std::vector<mdMethodDef> Tokens;
         int32_t correctedStartLine = sourceLine;
         mdMethodDef closestNestedToken = 0;
-        if (!GetMethodTokensByLineNumber(sourceData.methodsData, sourceData.multiMethodsData, correctedStartLine, Tokens, closestNestedToken))
+        if (!GetMethodTokensByLineNumber(sourceData.methodsIndex, correctedStartLine, Tokens, closestNestedToken))
             continue;
         // correctedStartLine - in case line not belong any methods, if possible, will be "moved" to first line of method below sourceLine.
 
@@ -769,9 +860,9 @@ HRESULT ModulesSources::ResolveBreakpoint(/*in*/ Modules *pModules, /*in*/ CORDB
             return E_FAIL;
         }
 
-        ModuleInfo *pmdInfo; // Note, pmdInfo must be covered by m_modulesInfoMutex.
-        IfFailRet(pModules->GetModuleInfo(sourceData.modAddress, &pmdInfo)); // we must have it, since we loaded data from it
-        if (pmdInfo->m_symbolReaderHandles.empty())
+        // Note, module info could be not published yet, since sources info published first at module load.
+        std::shared_ptr<const ModuleInfo> pmdInfo;
+        if (FAILED(pModules->GetModuleInfo(sourceData.modAddress, pmdInfo)) || pmdInfo->m_symbolReaderHandles.empty())
             continue;
 
         // In case one source line (field/property initialization) compiled into all constructors, after Hot Reload, constructors may have different
@@ -797,30 +888,26 @@ HRESULT ModulesSources::ResolveBreakpoint(/*in*/ Modules *pModules, /*in*/ CORDB
         // In case Hot Reload we may have line updates that we must take into account.
         LineUpdatesBackwardCorrection(findIndex->second, Tokens[0], pmdInfo->m_methodBlockUpdates, correctedStartLine);
 
-        PVOID data = nullptr;
-        int32_t Count = 0;
 #ifndef _WIN32
-        std::string fullName = m_sourceIndexToPath[findIndex->second];
+        std::string fullName = sourcesInfo->sourceIndexToPath[findIndex->second];
 #else
-        std::string fullName = m_sourceIndexToInitialFullPath[findIndex->second];
+        std::string fullName = sourcesInfo->sourceIndexToInitialFullPath[findIndex->second];
 #endif
         if (FAILED(Interop::ResolveBreakPoints(symbolReaderHandles.data(), (int32_t)Tokens.size(), Tokens.data(),
-                                               correctedStartLine, closestNestedToken, Count, fullName, &data))
-            || data == nullptr)
+                                               correctedStartLine, closestNestedToken, fullName, inputData)))
         {
             continue;
         }
-        std::unique_ptr<resolved_input_bp_t, resolved_input_bp_t_deleter> inputData((resolved_input_bp_t*)data);
 
-        for (int32_t i = 0; i < Count; i++)
+        for (auto &entry : inputData)
         {
             pmdInfo->m_iCorModule->AddRef();
 
             // In case Hot Reload we may have line updates that we must take into account.
-            LineUpdatesForwardCorrection(findIndex->second, inputData.get()[i].methodToken, pmdInfo->m_methodBlockUpdates, inputData.get()[i]);
+            LineUpdatesForwardCorrection(findIndex->second, entry.methodToken, pmdInfo->m_methodBlockUpdates, entry);
 
-            resolvedPoints.emplace_back(resolved_bp_t(inputData.get()[i].startLine, inputData.get()[i].endLine, inputData.get()[i].ilOffset,
-                                                      inputData.get()[i].methodToken, pmdInfo->m_iCorModule.GetPtr()));
+            resolvedPoints.emplace_back(resolved_bp_t(entry.startLine, entry.endLine, entry.ilOffset,
+                                                      entry.methodToken, pmdInfo->m_iCorModule.GetPtr()));
         }
     }
 
@@ -910,52 +997,52 @@ static HRESULT LoadLineUpdatesFile(ModulesSources *pModulesSources, const std::s
     return S_OK;
 }
 
-HRESULT ModulesSources::ApplyPdbDeltaAndLineUpdates(Modules *pModules, ICorDebugModule *pModule, bool needJMC, const std::string &deltaPDB,
+// Note, mdInfo is not published module info copy, caller care about publish it.
+HRESULT ModulesSources::ApplyPdbDeltaAndLineUpdates(ModuleInfo &mdInfo, ICorDebugModule *pModule, bool needJMC, const std::string &deltaPDB,
                                                     const std::string &lineUpdates, std::unordered_set<mdMethodDef> &methodTokens)
 {
+    if (mdInfo.m_symbolReaderHandles.empty())
+        return E_FAIL; // Deltas could be applied for already loaded modules with PDB only.
+
     HRESULT Status;
+    // Line updates must be applied on top of module's sources data.
     CORDB_ADDRESS modAddress;
     IfFailRet(pModule->GetBaseAddress(&modAddress));
+    IndexDeferredModules(modAddress, std::string());
 
-    return pModules->GetModuleInfo(modAddress, [&](ModuleInfo &mdInfo) -> HRESULT
-    {
-        if (mdInfo.m_symbolReaderHandles.empty())
-            return E_FAIL; // Deltas could be applied for already loaded modules with PDB only.
-
-        PVOID pSymbolReaderHandle = nullptr;
-        IfFailRet(Interop::LoadDeltaPdb(deltaPDB, &pSymbolReaderHandle, methodTokens));
-        // Note, even if methodTokens is empty, pSymbolReaderHandle must be added into vector (we use indexes that correspond to il/metadata apply number + will care about release it in proper way).
-        mdInfo.m_symbolReaderHandles.emplace_back(pSymbolReaderHandle);
+    PVOID pSymbolReaderHandle = nullptr;
+    IfFailRet(Interop::LoadDeltaPdb(deltaPDB, &pSymbolReaderHandle, methodTokens));
+    // Note, even if methodTokens is empty, pSymbolReaderHandle must be added into vector (we use indexes that correspond to il/metadata apply number + will care about release it in proper way).
+    mdInfo.AddSymbolReaderHandle(pSymbolReaderHandle);
 
-        src_block_updates_t srcBlockUpdates;
-        IfFailRet(LoadLineUpdatesFile(this, lineUpdates, srcBlockUpdates));
+    src_block_updates_t srcBlockUpdates;
+    IfFailRet(LoadLineUpdatesFile(this, lineUpdates, srcBlockUpdates));
 
-        if (methodTokens.empty() && srcBlockUpdates.empty())
-            return S_OK;
+    if (methodTokens.empty() && srcBlockUpdates.empty())
+        return S_OK;
 
-        if (needJMC && !methodTokens.empty())
-            DisableJMCByAttributes(pModule, methodTokens);
+    if (needJMC && !methodTokens.empty())
+        DisableJMCByAttributes(pModule, methodTokens);
 
-        ToRelease<IUnknown> pMDUnknown;
-        IfFailRet(pModule->GetMetaDataInterface(IID_IMetaDataImport, &pMDUnknown));
-        ToRelease<IMetaDataImport> pMDImport;
-        IfFailRet(pMDUnknown->QueryInterface(IID_IMetaDataImport, (LPVOID*) &pMDImport));
+    ToRelease<IUnknown> pMDUnknown;
+    IfFailRet(pModule->GetMetaDataInterface(IID_IMetaDataImport, &pMDUnknown));
+    ToRelease<IMetaDataImport> pMDImport;
+    IfFailRet(pMDUnknown->QueryInterface(IID_IMetaDataImport, (LPVOID*) &pMDImport));
 
-        return UpdateSourcesCodeLinesForModule(pModule, pMDImport, methodTokens, srcBlockUpdates, mdInfo);
-    });
+    return UpdateSourcesCodeLinesForModule(pModule, pMDImport, methodTokens, srcBlockUpdates, mdInfo);
 }
 
 HRESULT ModulesSources::GetSourceFullPathByIndex(unsigned index, std::string &fullPath)
 {
-    std::lock_guard<std::mutex> lock(m_sourcesInfoMutex);
+    std::shared_ptr<const SourcesInfo> sourcesInfo = GetSourcesInfo();
 
-    if (m_sourceIndexToPath.size() <= index)
+    if (sourcesInfo->sourceIndexToPath.size() <= index)
         return E_FAIL;
 
 #ifndef _WIN32
-    fullPath = m_sourceIndexToPath[index];
+    fullPath = std::string(sourcesInfo->sourceIndexToPath[index]);
 #else
-    fullPath = m_sourceIndexToInitialFullPath[index];
+    fullPath = std::string(sourcesInfo->sourceIndexToInitialFullPath[index]);
 #endif
 
     return S_OK;
@@ -968,10 +1055,16 @@ HRESULT ModulesSources::GetIndexBySourceFullPath(std::string fullPath, unsigned
     IfFailRet(Interop::StringToUpper(fullPath));
 #endif
 
-    std::lock_guard<std::mutex> lock(m_sourcesInfoMutex);
-
-    auto findIndex = m_sourcePathToIndex.find(fullPath);
-    if (findIndex == m_sourcePathToIndex.end())
+    // Note, source index never changed after add, so, deferred modules could be indexed only in case path was not found.
+    std::shared_ptr<const SourcesInfo> sourcesInfo = GetSourcesInfo();
+    auto findIndex = sourcesInfo->sourcePathToIndex.find(Utility::string_view(fullPath));
+    if (findIndex == sourcesInfo->sourcePathToIndex.end() && m_haveDeferredModules)
+    {
+        IndexDeferredModules(0, fullPath);
+        sourcesInfo = GetSourcesInfo();
+        findIndex = sourcesInfo->sourcePathToIndex.find(Utility::string_view(fullPath));
+    }
+    if (findIndex == sourcesInfo->sourcePathToIndex.end())
         return E_FAIL;
 
     index = findIndex->second;
@@ -987,37 +1080,40 @@ void ModulesSources::FindFileNames(Utility::string_view pattern, unsigned limit,
     pattern = uppercase;
 #endif
 
-    auto check = [&](const std::string& str)
+    // Note, all sources are needed for file names search, this is explicit user request, not breakpoint resolve.
+    IndexDeferredModules(0, std::string());
+    std::shared_ptr<const SourcesInfo> sourcesInfo = GetSourcesInfo();
+    auto check = [&](Utility::string_view str)
     {
         if (limit == 0)
             return false;
 
         auto pos = str.find(pattern);
-        if (pos != std::string::npos && (pos == 0 || str[pos-1] == '/' || str[pos-1] == '\\'))
+        if (pos != Utility::string_view::npos && (pos == 0 || str[pos-1] == '/' || str[pos-1] == '\\'))
         {
             limit--;
 #ifndef _WIN32
-            cb(str.c_str());
+            // All paths are stored in zero terminated arena blocks, see PathsArena::Add().
+            cb(str.data());
 #else
-            auto it = m_sourcePathToIndex.find(str);
-            cb (it != m_sourcePathToIndex.end() ? m_sourceIndexToInitialFullPath[it->second].c_str() : str.c_str());
+            auto it = sourcesInfo->sourcePathToIndex.find(str);
+            cb (it != sourcesInfo->sourcePathToIndex.end() ? sourcesInfo->sourceIndexToInitialFullPath[it->second].data() : str.data());
 #endif
         }
 
         return true;
     };
 
-    std::lock_guard<std::mutex> lock(m_sourcesInfoMutex);
-    for (const auto &pair : m_sourceNameToFullPathsIndexes)
+    for (const auto &pair : sourcesInfo->sourceNameToFullPathsIndexes)
     {
-        LOGD("first '%s'", pair.first.c_str());
+        LOGD("first '%s'", pair.first.data());
         if (!check(pair.first))
             return;
 
         for (const unsigned fileIndex : pair.second)
         {
-            LOGD("second '%s'", m_sourceIndexToPath[fileIndex].c_str());
-            if (!check(m_sourceIndexToPath[fileIndex]))
+            LOGD("second '%s'", sourcesInfo->sourceIndexToPath[fileIndex].data());
+            if (!check(sourcesInfo->sourceIndexToPath[fileIndex]))
                 return;
         }
     }
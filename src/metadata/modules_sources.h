@@ -7,14 +7,18 @@
 #include "cor.h"
 #include "cordebug.h"
 
-#include <set>
+#include <atomic>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <functional>
+#include <limits>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
 #include "utils/string_view.h"
 #include "utils/torelease.h"
+#include "managed/interop.h"
 
 
 namespace netcoredbg
@@ -81,6 +85,84 @@ struct method_data_t_hash
     }
 };
 
+// Compact method's data for methods index, same as method_data_t, but columns stored in 16 bits. Method with column that
+// don't fit (generated or minified code with very long lines) have ColumnOverflow and full data in methods index side table.
+struct packed_method_data_t
+{
+    static const uint16_t ColumnOverflow = std::numeric_limits<uint16_t>::max();
+
+    mdMethodDef methodDef;
+    int32_t startLine;
+    int32_t endLine;
+    uint16_t startColumn;
+    uint16_t endColumn;
+
+    packed_method_data_t() :
+        methodDef(0),
+        startLine(0),
+        endLine(0),
+        startColumn(0),
+        endColumn(0)
+    {}
+
+    explicit packed_method_data_t(const method_data_t &data) :
+        methodDef(data.methodDef),
+        startLine(data.startLine),
+        endLine(data.endLine),
+        startColumn(PackColumn(data.startColumn)),
+        endColumn(PackColumn(data.endColumn))
+    {}
+
+    bool operator < (const int32_t lineNum) const
+    {
+        return endLine < lineNum;
+    }
+
+    bool Overflow() const
+    {
+        return startColumn == ColumnOverflow || endColumn == ColumnOverflow;
+    }
+
+private:
+
+    static uint16_t PackColumn(int32_t column)
+    {
+        return (uint32_t)column >= ColumnOverflow ? (uint16_t)ColumnOverflow : (uint16_t)column;
+    }
+};
+
+static_assert(sizeof(packed_method_data_t) == 16, "packed_method_data_t must be 16 bytes");
+
+// Method's data that also represent code of other methods (constructor's segment could be part of multiple constructors),
+// with range of other methods tokens in methods_index_t::multiMethodsTokens.
+struct multi_method_data_t
+{
+    method_data_t methodData;
+    uint32_t tokensOffset;
+    uint32_t tokensCount;
+
+    multi_method_data_t(const method_data_t &methodData_, uint32_t tokensOffset_, uint32_t tokensCount_) :
+        methodData(methodData_),
+        tokensOffset(tokensOffset_),
+        tokensCount(tokensCount_)
+    {}
+};
+
+// Methods ranges index for one source file, all data stored in flat arrays.
+struct methods_index_t
+{
+    // methods data of all nested levels, level N is [levelsOffsets[N], levelsOffsets[N + 1]) range ordered by end position
+    std::vector<packed_method_data_t> methodsData;
+    std::vector<uint32_t> levelsOffsets;
+    // full data for methodsData entries with columns overflow, ordered by methodsData index
+    std::vector<std::pair<uint32_t, method_data_t>> overflowMethodsData;
+    // ordered by methodData array of multiple methods code data, aimed to resolve all methods token for constructor's segment
+    std::vector<multi_method_data_t> multiMethodsData;
+    std::vector<mdMethodDef> multiMethodsTokens;
+
+    method_data_t GetMethodData(uint32_t index) const;
+};
+
 struct block_update_t
 {
     int32_t newLine;
@@ -105,7 +187,7 @@ struct file_block_update_t
 typedef std::unordered_map<mdMethodDef, std::vector<file_block_update_t>> method_block_updates_t;
 
 template <class T>
-void LineUpdatesForwardCorrection(unsigned fullPathIndex, mdMethodDef methodToken, method_block_updates_t &methodBlockUpdates, T &block)
+void LineUpdatesForwardCorrection(unsigned fullPathIndex, mdMethodDef methodToken, const method_block_updates_t &methodBlockUpdates, T &block)
 {
     auto findSourceUpdate = methodBlockUpdates.find(methodToken);
     if (findSourceUpdate == methodBlockUpdates.end())
@@ -152,15 +234,19 @@ public:
     HRESULT ResolveBreakpoint(
         /*in*/ Modules *pModules,
         /*in*/ CORDB_ADDRESS modAddress,
-        /*in*/ std::string filename,
+        /*in*/ const std::string &filename,
         /*out*/ unsigned &fullname_index,
         /*in*/ int sourceLine,
         /*out*/ std::vector<resolved_bp_t> &resolvedPoints);
 
     HRESULT FillSourcesCodeLinesForModule(ICorDebugModule *pModule, IMetaDataImport *pMDImport, PVOID pSymbolReaderHandle);
+    // Postpone module sources indexing till first request, that need this module sources data.
+    // Note, symbol reader handle must be valid till module indexed or ClearDeferredModules() call.
+    HRESULT DeferSourcesCodeLinesForModule(ICorDebugModule *pModule, IMetaDataImport *pMDImport, PVOID pSymbolReaderHandle);
+    void ClearDeferredModules();
     HRESULT GetSourceFullPathByIndex(unsigned index, std::string &fullPath);
     HRESULT GetIndexBySourceFullPath(std::string fullPath, unsigned &index);
-    HRESULT ApplyPdbDeltaAndLineUpdates(Modules *pModules, ICorDebugModule *pModule, bool needJMC, const std::string &deltaPDB,
+    HRESULT ApplyPdbDeltaAndLineUpdates(ModuleInfo &mdInfo, ICorDebugModule *pModule, bool needJMC, const std::string &deltaPDB,
                                         const std::string &lineUpdates, std::unordered_set<mdMethodDef> &methodTokens);
 
     void FindFileNames(Utility::string_view pattern, unsigned limit, std::function<void(const char *)> cb);
@@ -170,38 +256,116 @@ private:
     struct FileMethodsData
     {
         CORDB_ADDRESS modAddress = 0;
-        // properly ordered on each nested level arrays of methods data
-        std::vector<std::vector<method_data_t>> methodsData;
-        // mapping method's data to array of tokens, that also represent same code
-        // aimed to resolve all methods token for constructor's segment, since it could be part of multiple constructors
-        std::unordered_map<method_data_t, std::vector<mdMethodDef>, method_data_t_hash> multiMethodsData;
+        methods_index_t methodsIndex;
+    };
+
+    // Append-only storage for zero terminated source paths. Blocks are never moved and already added paths are never
+    // changed, so, blocks are shared between sources info snapshots and paths could be referenced by string_view.
+    class PathsArena
+    {
+    public:
+        Utility::string_view Add(Utility::string_view path);
+
+    private:
+        std::vector<std::shared_ptr<char>> m_blocks;
+        size_t m_lastBlockSize = 0;
+        size_t m_lastBlockUsed = 0;
+    };
+
+    struct string_view_hash
+    {
+        size_t operator()(Utility::string_view str) const
+        {
+            // FNV-1a
+            uint32_t hash = 2166136261u;
+            for (char c : str)
+            {
+                hash = (hash ^ (uint8_t)c) * 16777619u;
+            }
+            return hash;
+        }
+    };
+
+    struct SourcesInfo
+    {
+        // Note, all paths are stored in `paths` arena only, other containers refer them.
+        PathsArena paths;
+        // Note, we only add to sourceIndexToPath/sourcePathToIndex/sourceIndexToInitialFullPath, "size()" used as index in map at new element add.
+        // sourceIndexToPath - mapping index to full path
+        std::vector<Utility::string_view> sourceIndexToPath;
+        // sourcePathToIndex - mapping full path to index
+        std::unordered_map<Utility::string_view, unsigned, string_view_hash> sourcePathToIndex;
+        // sourceNameToFullPathsIndexes - mapping file name (full path suffix) to ordered array of paths with this file name
+        std::unordered_map<Utility::string_view, std::vector<unsigned>, string_view_hash> sourceNameToFullPathsIndexes;
+        // sourcesMethodsData - all methods data indexed by full path, second vector hold data with same full path for different modules,
+        //                      since we may have modules with same source full path. Shared between snapshots, never changed after publish.
+        std::vector<std::shared_ptr<const std::vector<FileMethodsData>>> sourcesMethodsData;
+#ifdef WIN32
+        // on Windows OS, all files names converted to uppercase in containers above, but this vector hold initial full path names
+        std::vector<Utility::string_view> sourceIndexToInitialFullPath;
+#endif
     };
 
     // Note, breakpoints setup and ran debuggee's process could be in the same time.
+    // Sources info is immutable snapshot (RCU-like), readers take current snapshot and work with it without any lock
+    // (include managed calls), writers serialized by m_sourcesInfoMutex and publish modified copy.
+    // Note, m_sourcesInfo must be accessed by std::atomic_load()/std::atomic_store() only.
     std::mutex m_sourcesInfoMutex;
-    // Note, we only add to m_sourceIndexToPath/m_sourcePathToIndex/m_sourceIndexToInitialFullPath, "size()" used as index in map at new element add.
-    // m_sourceIndexToPath - mapping index to full path
-    std::vector<std::string> m_sourceIndexToPath;
-    // m_sourcePathToIndex - mapping full path to index
-    std::unordered_map<std::string, unsigned> m_sourcePathToIndex;
-    // m_sourceNameToFullPathsIndexes - mapping file name to set of paths with this file name
-    std::unordered_map<std::string, std::set<unsigned>> m_sourceNameToFullPathsIndexes;
-    // m_sourcesMethodsData - all methods data indexed by full path, second vector hold data with same full path for different modules,
-    //                        since we may have modules with same source full path
-    std::vector<std::vector<FileMethodsData>> m_sourcesMethodsData;
-
-    HRESULT GetFullPathIndex(BSTR document, unsigned &fullPathIndex);
+    std::shared_ptr<const SourcesInfo> m_sourcesInfo = std::make_shared<SourcesInfo>();
+    // Managed calls result buffers, reused for all modules in order to avoid allocation for each call, guarded by m_sourcesInfoMutex.
+    std::vector<Interop::FileMethodsData> m_filesDataBuffer;
+    std::vector<method_data_t> m_methodsDataBuffer;
+    std::vector<Interop::MethodSequencePoint> m_sequencePointsBuffer;
+
+    // Protocol supplied path (as is, before case folding and relative path resolution) to source index cache, aimed
+    // to avoid same paths normalization on each breakpoints update. Cache related to sources info snapshot with
+    // m_pathsCacheSourcesCount indexed sources and reset, when new sources indexed (we only add sources, so, new
+    // snapshot always have more sources). Failed resolution also cached as InvalidIndex, since breakpoints for not
+    // loaded yet sources are checked on each module load.
+    static const unsigned InvalidIndex = unsigned(-1);
+    std::mutex m_pathsCacheMutex;
+    std::unordered_map<std::string, unsigned> m_pathsCache;
+    size_t m_pathsCacheSourcesCount = 0;
+
+    struct DeferredModule
+    {
+        CORDB_ADDRESS modAddress;
+        ToRelease<ICorDebugModule> iCorModule;
+        ToRelease<IMetaDataImport> iMDImport;
+        PVOID pSymbolReaderHandle;
+        // Source files names (without directory) from module's PDB, loaded at first check, see IsDeferredModuleHaveFile().
+        bool fileNamesLoaded;
+        std::unordered_set<std::string> fileNames;
+
+        DeferredModule(CORDB_ADDRESS modAddress_, ICorDebugModule *pModule, IMetaDataImport *pMDImport, PVOID pSymbolReaderHandle_) :
+            modAddress(modAddress_),
+            iCorModule(pModule),
+            iMDImport(pMDImport),
+            pSymbolReaderHandle(pSymbolReaderHandle_),
+            fileNamesLoaded(false)
+        {}
+    };
+
+    // Modules with postponed sources indexing, see DeferSourcesCodeLinesForModule().
+    // Note, in all code we use m_deferredModulesMutex > m_sourcesInfoMutex lock sequence.
+    std::mutex m_deferredModulesMutex;
+    std::list<DeferredModule> m_deferredModules;
+    std::atomic<bool> m_haveDeferredModules{false};
+
+    // Index postponed sources for module with modAddress (or for all modules in case modAddress is 0), that have source
+    // with same file name as `filename` path has (or for all modules in case `filename` is empty).
+    void IndexDeferredModules(CORDB_ADDRESS modAddress, const std::string &filename);
+    // Caller must care about m_deferredModulesMutex.
+    bool IsDeferredModuleHaveFile(DeferredModule &deferredModule, Utility::string_view fileName);
+    std::shared_ptr<const SourcesInfo> GetSourcesInfo() const;
+    HRESULT GetIndexByProtocolPath(const SourcesInfo &sourcesInfo, const std::string &filename, unsigned &index);
+    HRESULT GetFullPathIndex(SourcesInfo &sourcesInfo, const std::string &document, unsigned &fullPathIndex);
     HRESULT UpdateSourcesCodeLinesForModule(ICorDebugModule *pModule, IMetaDataImport *pMDImport, std::unordered_set<mdMethodDef> methodTokens,
                                             src_block_updates_t &blockUpdates, ModuleInfo &mdInfo);
-    HRESULT ResolveRelativeSourceFileName(std::string &filename);
-    HRESULT LineUpdatesForMethodData(ICorDebugModule *pModule, unsigned fullPathIndex, method_data_t &methodData,
+    HRESULT ResolveRelativeSourceFileName(const SourcesInfo &sourcesInfo, std::string &filename);
+    HRESULT LineUpdatesForMethodData(SourcesInfo &sourcesInfo, ICorDebugModule *pModule, unsigned fullPathIndex, method_data_t &methodData,
                                      const std::vector<block_update_t> &blockUpdate, ModuleInfo &mdInfo);
 
-#ifdef WIN32
-    // on Windows OS, all files names converted to uppercase in containers above, but this vector hold initial full path names
-    std::vector<std::string> m_sourceIndexToInitialFullPath;
-#endif
-
 };
 
 } // namespace netcoredbg
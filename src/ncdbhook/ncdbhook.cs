@@ -2,6 +2,9 @@
 // Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
 
 using System;
+using System.Diagnostics;
+using System.Net.Sockets;
+using System.Reflection;
 using System.Threading.Tasks;
 
 internal sealed class StartupHook
@@ -35,15 +38,75 @@ internal sealed class StartupHook
     public static void Initialize()
     {
         ClearHotReloadEnvironmentVariables(Environment.GetEnvironmentVariable, Environment.SetEnvironmentVariable);
-        Task.Run((Action)ncdbloop);
+        // Debugger inject startup hook for debuggee side helpers (see `ncdbGetPropertiesValues()`) at any launch,
+        // but `ncdbfunc()` calls loop is needed only in case Hot Reload enabled.
+        const string HotReloadEnvironment = "NCDB_HOOK_HOT_RELOAD";
+        bool hotReload = Environment.GetEnvironmentVariable(HotReloadEnvironment) == "1";
+        Environment.SetEnvironmentVariable(HotReloadEnvironment, null);
+        if (!hotReload)
+            return;
+
+        Socket? signalSocket = CreateSignalSocket(Environment.GetEnvironmentVariable, Environment.SetEnvironmentVariable);
+        Task.Run(() => ncdbloop(signalSocket));
     }
 
-    public static void ncdbloop()
+    // Debugger connect to local socket right after changes applied (see `SignalStartupHook()` in hotreloadhelpers.cpp),
+    // so, we don't need wait for next poll in order to call `ncdbfunc()`.
+    internal static Socket? CreateSignalSocket(
+        Func<string, string?> getEnvironmentVariable,
+        Action<string, string?> setEnvironmentVariable)
     {
+        const string SignalEnvironment = "NCDB_HOOK_SIGNAL";
+        var signalPath = getEnvironmentVariable(SignalEnvironment);
+        // Child processes should not be affected by this variable.
+        setEnvironmentVariable(SignalEnvironment, null);
+        if (string.IsNullOrEmpty(signalPath))
+            return null;
+
+        Socket? socket = null;
+        try
+        {
+            File.Delete(signalPath);
+            socket = new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified);
+            socket.Bind(new UnixDomainSocketEndPoint(signalPath));
+            socket.Listen(1);
+            return socket;
+        }
+        catch
+        {
+            socket?.Dispose();
+            return null;
+        }
+    }
+
+    public static void ncdbloop(Socket? signalSocket)
+    {
+        // In case debugger can't signal us for some reason, `ncdbfunc()` still called by timeout.
+        const int PollTimeout = 200; // milliseconds
+        byte[] buffer = new byte[16];
         while (true)
         {
             ncdbfunc();
-            System.Threading.Thread.Sleep(200);
+
+            if (signalSocket == null)
+            {
+                System.Threading.Thread.Sleep(PollTimeout);
+                continue;
+            }
+
+            try
+            {
+                if (!signalSocket.Poll(PollTimeout * 1000, SelectMode.SelectRead))
+                    continue;
+
+                using var connection = signalSocket.Accept();
+                while (connection.Receive(buffer) > 0) {}
+            }
+            catch
+            {
+                signalSocket.Dispose();
+                signalSocket = null;
+            }
         }
     }
 
@@ -85,4 +148,68 @@ internal sealed class StartupHook
         return types?.ToArray() ?? Type.EmptyTypes;
     }
 
+    // Get instance properties values of object in one func-eval, instead of separate func-eval for each getter call.
+    // Properties provided as string with `<declaring type module MVID>:<declaring type token>:<getter token>` entries
+    // separated by `;` symbol, debugger already filtered properties (static, DebuggerBrowsableState.Never), so, only
+    // getter search is needed. Note, tokens are unique only inside one module, so, declaring type module must be checked.
+    // Result array have two elements for each property - value and exception. In case both are null, property was not
+    // evaluated (not found, can't be invoked by reflection or boxing will lose type) or returns null, debugger should
+    // use regular func-eval for this property.
+    public static object?[] ncdbGetPropertiesValues(object obj, string properties)
+    {
+        const BindingFlags flags = BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic | BindingFlags.DeclaredOnly;
+        string[] entries = properties.Split(';');
+        object?[] result = new object?[entries.Length * 2];
+
+        for (int i = 0; i < entries.Length; i++)
+        {
+            string[] fields = entries[i].Split(':');
+            if (fields.Length != 3 ||
+                !Guid.TryParse(fields[0], out Guid moduleId) ||
+                !int.TryParse(fields[1], out int typeToken) ||
+                !int.TryParse(fields[2], out int getterToken))
+                continue;
+
+            // Note, for generic types MetadataToken is generic type definition token, but declared methods are from
+            // constructed type, so, getter could be invoked for obj.
+            MethodInfo? getter = null;
+            for (Type? type = obj.GetType(); type != null && getter == null; type = type.BaseType)
+            {
+                if (type.MetadataToken != typeToken || type.Module.ModuleVersionId != moduleId)
+                    continue;
+
+                foreach (var method in type.GetMethods(flags))
+                {
+                    if (method.MetadataToken == getterToken)
+                    {
+                        getter = method;
+                        break;
+                    }
+                }
+            }
+
+            if (getter == null || getter.GetParameters().Length != 0 || getter.ContainsGenericParameters)
+                continue;
+
+            Type returnType = getter.ReturnType;
+            if (returnType.IsByRef || returnType.IsPointer || returnType.IsByRefLike || Nullable.GetUnderlyingType(returnType) != null)
+                continue;
+
+            try
+            {
+                result[i * 2] = getter.Invoke(obj, null);
+            }
+            catch (TargetInvocationException e)
+            {
+                result[i * 2 + 1] = e.InnerException ?? e;
+            }
+            catch
+            {
+                continue;
+            }
+        }
+
+        return result;
+    }
+
 }
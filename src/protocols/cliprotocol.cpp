@@ -9,6 +9,7 @@
 #else
 #include <termios.h>
 #include <unistd.h>
+#include <sys/ioctl.h>
 #define _isatty(fd) ::isatty(fd)
 #define _fileno(file) ::fileno(file)
 #endif
@@ -86,6 +87,7 @@ enum class CLIProtocol::CommandTag
     Backtrace,
     Break,
     Catch,
+    Commands,
     Continue,
     Delete,
     Detach,
@@ -110,6 +112,7 @@ enum class CLIProtocol::CommandTag
     SetArgs,
     SetJustMyCode,
     SetStepFiltering,
+    SetHeight,
     SetHelp,
 
     // info subcommand
@@ -198,6 +201,10 @@ constexpr static const CLIParams::CommandInfo set_commands[] =
             {{"1 or 0"},  "Prevent or allow stepping into properties and operators\n"
                           "in managed code."}},
 
+    {CommandTag::SetHeight, {}, {}, {{"height"}},
+            {{"<lines>"}, "Set number of lines per screen for long commands output,\n"
+                          "0 disables pagination (terminal height by default)."}},
+
     {CommandTag::SetHelp, {}, {}, {{"help"}}, {{}, {}}},
 
     // This should be placed at end of command (sub)lists.
@@ -222,14 +229,23 @@ constexpr static const CLIParams::CommandInfo commands_list[] =
         {{}, "Print backtrace info."}},
 
     {CommandTag::Break, {}, {{{1, CompletionTag::Break}}}, {{"break", "b"}},
-        {"<loc>", "Set breakpoint at specified location, where the\n"
+        {"<loc> [thread <id>] [trigger <id>] [if <cond>]", "Set breakpoint at specified location, where the\n"
                   "location might be filename.cs:line or function name.\n"
                   "Optional, module name also could be provided as part\n"
-                  "of location: module.dll!filename.cs:line"}},
+                  "of location: module.dll!filename.cs:line\n"
+                  "Breakpoint with thread id stop only this thread.\n"
+                  "Breakpoint with trigger id is disabled until trigger\n"
+                  "breakpoint hit, trigger breakpoint don't stop debuggee.\n"
+                  "Breakpoint with condition stop only if condition is true."}},
 
     {CommandTag::Catch, {}, {}, {{"catch"}},
         {{}, "Set exception breakpoints."}},
 
+    {CommandTag::Commands, {}, {}, {{"commands"}},
+        {"<num> <cmd>[; <cmd>...]", "Set commands executed at breakpoint N hit: print <expr>,\n"
+                  "backtrace and continue (don't stop at breakpoint).\n"
+                  "Output of all commands printed as one block."}},
+
     {CommandTag::Continue, {}, {}, {{"continue", "c"}},
         {{}, "Continue debugging after stop/pause."}},
 
@@ -350,11 +366,26 @@ public:
         return {string_view{cmdline.get()}, Success};
     }
 
+    virtual std::tuple<string_view, Result> get_answer(const char *prompt) override
+    {
+        errno = 0;
+        cmdline.reset(linenoise(prompt));
+        if (!cmdline)
+            return {string_view{}, errno == EAGAIN ? Interrupt : Eof};
+
+        return {string_view{cmdline.get()}, Success};
+    }
+
     virtual void setLastCommand(std::string lc) override
     {
         m_last_command = lc;
     }
 
+    virtual bool isInteractive() const override
+    {
+        return _isatty(_fileno(stdin));
+    }
+
 private:
     static void deleter(void *s) { ::free(s); };
     std::unique_ptr<char, decltype(&deleter)> cmdline;
@@ -565,6 +596,7 @@ CLIProtocol::CLIProtocol(InStream& input, OutStream& output) :
   m_frameIdx(0),
   m_sources(nullptr),
   m_term_settings(*this), 
+  m_pageHeight(-1),
   line_reader(),
   m_commandMode(CommandMode::Unset)
 {
@@ -611,6 +643,147 @@ int CLIProtocol::printf_checked(const char *fmt, ...)
 }
 
 
+// Get console window size, zero values returned in case size can't be detected.
+static void GetTerminalSize(unsigned &rows, unsigned &columns)
+{
+    rows = 0;
+    columns = 0;
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info))
+    {
+        rows = unsigned(info.srWindow.Bottom - info.srWindow.Top + 1);
+        columns = unsigned(info.srWindow.Right - info.srWindow.Left + 1);
+    }
+#else
+    struct winsize ws;
+    if (ioctl(_fileno(stdin), TIOCGWINSZ, &ws) == 0)
+    {
+        rows = ws.ws_row;
+        columns = ws.ws_col;
+    }
+#endif
+}
+
+// This class prints command output incrementally and after each screen asks user to continue (same as GDB's
+// pagination), so command could print first screen before whole result computed and stop computation in case
+// user requested to quit. Pagination enabled for interactive console input only, otherwise output just printed.
+class CLIProtocol::Pager
+{
+public:
+    Pager(CLIProtocol &protocol);
+
+    // Print text (might contain several lines), return false in case user requested to quit.
+    bool Print(string_view text);
+#ifdef _MSC_VER
+    bool Printf(_Printf_format_string_ const char *fmt, ...);
+#else
+    bool Printf(const char *fmt, ...) __attribute__((format (printf, 2, 3)));
+#endif
+    bool Aborted() const { return m_aborted; }
+
+private:
+    CLIProtocol &m_protocol;
+    unsigned m_height; // 0 - pagination disabled
+    unsigned m_width;  // 0 - lines are not wrapped
+    unsigned m_line;
+    unsigned m_column;
+    bool m_aborted;
+
+    bool Prompt();
+};
+
+CLIProtocol::Pager::Pager(CLIProtocol &protocol) :
+    m_protocol(protocol),
+    m_height(0),
+    m_width(0),
+    m_line(0),
+    m_column(0),
+    m_aborted(false)
+{
+    if (protocol.m_pageHeight == 0 || !protocol.line_reader || !protocol.line_reader->isInteractive())
+        return;
+
+    unsigned rows;
+    GetTerminalSize(rows, m_width);
+    m_height = protocol.m_pageHeight > 0 ? unsigned(protocol.m_pageHeight) : rows;
+    // At least one line of output plus prompt line.
+    if (m_height < 2)
+        m_height = 0;
+}
+
+bool CLIProtocol::Pager::Prompt()
+{
+    m_line = 0;
+    m_column = 0;
+
+    string_view input;
+    LineReader::Result result;
+    std::tie(input, result) = m_protocol.getAnswer("--Type <RET> for more, q to quit--");
+    if (result == LineReader::Success)
+    {
+        size_t pos = 0;
+        while (pos < input.size() && strchr(" \r\n\t", input[pos]))
+            pos++;
+
+        // Empty answer (just <RET>) or anything except 'q' - continue output.
+        if (pos == input.size() || input[pos] != 'q')
+            return true;
+    }
+
+    m_protocol.printf_checked("Quit\n");
+    m_aborted = true;
+    return false;
+}
+
+bool CLIProtocol::Pager::Print(string_view text)
+{
+    if (m_aborted)
+        return false;
+
+    size_t start = 0;
+    for (size_t i = 0; m_height != 0 && i < text.size(); i++)
+    {
+        // Screen is full (last line reserved for prompt), ask user before print next symbol.
+        if (m_line + 1 >= m_height)
+        {
+            m_protocol.printf_checked("%.*s", int(i - start), text.data() + start);
+            start = i;
+            if (!Prompt())
+                return false;
+        }
+
+        if (text[i] == '\n' || (m_width != 0 && ++m_column >= m_width))
+        {
+            m_line++;
+            m_column = 0;
+        }
+    }
+
+    if (start < text.size())
+        m_protocol.printf_checked("%.*s", int(text.size() - start), text.data() + start);
+
+    return true;
+}
+
+bool CLIProtocol::Pager::Printf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(nullptr, 0, fmt, args);
+    va_end(args);
+    if (len <= 0)
+        return !m_aborted;
+
+    std::string text(size_t(len) + 1, '\0');
+    va_start(args, fmt);
+    vsnprintf(&text[0], text.size(), fmt, args);
+    va_end(args);
+    text.resize(size_t(len));
+
+    return Print(text);
+}
+
 HRESULT CLIProtocol::PrintBreakpoint(const Breakpoint &b, std::string &output)
 {
     HRESULT Status;
@@ -936,26 +1109,29 @@ void CLIProtocol::EmitOutputEvent(OutputCategory category, string_view output, s
 template <>
 HRESULT CLIProtocol::doCommand<CommandTag::Backtrace>(const std::vector<std::string> &args_orig, std::string &output)
 {
-    lock_guard lock(m_mutex);
-
-    if (m_processStatus == NotStarted || m_processStatus == Exited)
+    ThreadId tid;
     {
-        output = "No process.";
-        return E_FAIL;
-    }
+        lock_guard lock(m_mutex);
 
-    if (m_processStatus != Paused)
-    {
-        output = "Can't get backtrace for running process.";
-        return E_FAIL;
-    }
+        if (m_processStatus == NotStarted || m_processStatus == Exited)
+        {
+            output = "No process.";
+            return E_FAIL;
+        }
 
-    // assuming call of m_sharedDebugger->GetAnything() with locked mutex not lead to deadlock
-    ThreadId tid = m_sharedDebugger->GetLastStoppedThreadId();
-    if (tid == ThreadId::AllThreads)
-    {
-        output ="No stack.";
-        return E_FAIL;
+        if (m_processStatus != Paused)
+        {
+            output = "Can't get backtrace for running process.";
+            return E_FAIL;
+        }
+
+        // assuming call of m_sharedDebugger->GetAnything() with locked mutex not lead to deadlock
+        tid = m_sharedDebugger->GetLastStoppedThreadId();
+        if (tid == ThreadId::AllThreads)
+        {
+            output ="No stack.";
+            return E_FAIL;
+        }
     }
 
     std::vector<std::string> args = args_orig;
@@ -964,7 +1140,27 @@ HRESULT CLIProtocol::doCommand<CommandTag::Backtrace>(const std::vector<std::str
     int highFrame = FrameLevel::MaxFrameLevel;
     ProtocolUtils::StripArgs(args);
     ProtocolUtils::GetIndices(args, lowFrame, highFrame);
-    return PrintFrames(threadId, output, FrameLevel{lowFrame}, FrameLevel{highFrame});
+
+    // Frames are printed during unwind, so output of deep stack could be stopped by user at any screen
+    // (unwind of rest frames stopped too).
+    HRESULT Status;
+    Pager pager(*this);
+    int currentFrame = lowFrame;
+    IfFailRet(m_sharedDebugger->WalkStackTrace(threadId, FrameLevel{lowFrame}, [&](const StackFrame &stackFrame)
+    {
+        if (currentFrame >= highFrame)
+            return false;
+
+        std::string frameLocation;
+        PrintFrameLocation(stackFrame, frameLocation);
+        if (!pager.Printf("#%d%s%s\n", currentFrame, frameLocation.empty() ? "" : " ", frameLocation.c_str()))
+            return false;
+
+        currentFrame++;
+        return currentFrame < highFrame;
+    }));
+
+    return currentFrame == lowFrame && !pager.Aborted() ? E_INVALIDARG : S_OK;
 }
 
 template <>
@@ -976,6 +1172,43 @@ HRESULT CLIProtocol::doCommand<CommandTag::Break>(const std::vector<std::string>
 
     ProtocolUtils::StripArgs(args);
 
+    // Thread specific breakpoint: `break <loc> thread <thread-id>` (same as GDB).
+    ThreadFilter thread;
+    std::string threadIdArg;
+    if (ProtocolUtils::FindAndEraseBreakpointArgValue(args, "thread", threadIdArg))
+    {
+        bool ok;
+        int threadId = ProtocolUtils::ParseInt(threadIdArg, ok);
+        if (!ok || threadId <= 0)
+        {
+            output = "Wrong thread id specified";
+            return E_FAIL;
+        }
+        thread.threadId = ThreadId{threadId};
+    }
+
+    // Dependent breakpoint: `break <loc> trigger <bkpt-id>`, breakpoint is disabled until trigger breakpoint hit.
+    uint32_t triggerId = 0;
+    std::string triggerIdArg;
+    if (ProtocolUtils::FindAndEraseBreakpointArgValue(args, "trigger", triggerIdArg))
+    {
+        bool ok;
+        int id = ProtocolUtils::ParseInt(triggerIdArg, ok);
+        if (!ok || id <= 0)
+        {
+            output = "Wrong trigger breakpoint id specified";
+            return E_FAIL;
+        }
+        triggerId = id;
+    }
+
+    // Conditional breakpoint: `break <loc> [thread <id>] [trigger <id>] if <condition>` (same as GDB).
+    if (!ProtocolUtils::FindAndEraseBreakpointCondition(args))
+    {
+        output = "Wrong breakpoint condition specified";
+        return E_FAIL;
+    }
+
     BreakType bt = ProtocolUtils::GetBreakpointType(args);
 
     if (bt == BreakType::Error)
@@ -988,21 +1221,21 @@ HRESULT CLIProtocol::doCommand<CommandTag::Break>(const std::vector<std::string>
     {
         struct LineBreak lb;
 
-        if (ProtocolUtils::ParseBreakpoint(args, lb)
-            && SUCCEEDED(m_breakpointsHandle.SetLineBreakpoint(m_sharedDebugger, lb.module, lb.filename, lb.linenum, lb.condition, breakpoint)))
-            Status = S_OK;
+        if (ProtocolUtils::ParseBreakpoint(args, lb))
+            Status = m_breakpointsHandle.SetLineBreakpoint(m_sharedDebugger, lb.module, lb.filename, lb.linenum, lb.condition, breakpoint, SnapshotSettings(), thread, triggerId);
     }
     else if (bt == BreakType::FuncBreak)
     {
         struct FuncBreak fb;
 
-        if (ProtocolUtils::ParseBreakpoint(args, fb)
-            && SUCCEEDED(m_breakpointsHandle.SetFuncBreakpoint(m_sharedDebugger, fb.module, fb.funcname, fb.params, fb.condition, breakpoint)))
-            Status = S_OK;
+        if (ProtocolUtils::ParseBreakpoint(args, fb))
+            Status = m_breakpointsHandle.SetFuncBreakpoint(m_sharedDebugger, fb.module, fb.funcname, fb.params, fb.condition, breakpoint, SnapshotSettings(), thread, triggerId);
     }
 
-    if (Status == S_OK)
+    if (SUCCEEDED(Status))
         PrintBreakpoint(breakpoint, output);
+    else if (Status == E_INVALIDARG && triggerId != 0)
+        output = "Unknown trigger breakpoint id " + std::to_string(triggerId);
     else
         output = "Unknown breakpoint location format";
 
@@ -1073,6 +1306,51 @@ HRESULT CLIProtocol::doCommand<CommandTag::Catch>(const std::vector<std::string>
     return S_OK;
 }
 
+template <>
+HRESULT CLIProtocol::doCommand<CommandTag::Commands>(const std::vector<std::string> &args, std::string &output)
+{
+    if (args.empty())
+    {
+        output = "Command usage: commands <num> <cmd>[; <cmd>...]";
+        return E_INVALIDARG;
+    }
+
+    bool ok;
+    int id = ProtocolUtils::ParseInt(args.at(0), ok);
+    if (!ok)
+    {
+        output = "Unknown breakpoint id";
+        return E_INVALIDARG;
+    }
+
+    std::string commandsLine;
+    for (size_t i = 1; i < args.size(); i++)
+    {
+        if (i > 1)
+            commandsLine += " ";
+        commandsLine += args[i];
+    }
+
+    std::vector<std::string> commands;
+    std::istringstream ss(commandsLine);
+    std::string command;
+    while (std::getline(ss, command, ';'))
+    {
+        size_t start = command.find_first_not_of(' ');
+        if (start == std::string::npos)
+            continue;
+        size_t end = command.find_last_not_of(' ');
+        commands.emplace_back(command.substr(start, end - start + 1));
+    }
+
+    if (SUCCEEDED(m_breakpointsHandle.SetLineBreakpointCommands(m_sharedDebugger, id, commands)) ||
+        SUCCEEDED(m_breakpointsHandle.SetFuncBreakpointCommands(m_sharedDebugger, id, commands)))
+        return S_OK;
+
+    output = "No breakpoint number " + args.at(0) + ".";
+    return E_FAIL;
+}
+
 template <>
 HRESULT CLIProtocol::doCommand<CommandTag::Continue>(const std::vector<std::string> &, std::string &output)
 {
@@ -1362,6 +1640,8 @@ HRESULT CLIProtocol::doCommand<CommandTag::InfoBreakpoints>(const std::vector<st
 
     unsigned nlines = 0;
 
+    Pager pager(*this);
+
     // function which prints each particular breakpoint
     auto printer = [&](const IDebugger::BreakpointInfo& bp) -> bool
     {
@@ -1370,18 +1650,18 @@ HRESULT CLIProtocol::doCommand<CommandTag::InfoBreakpoints>(const std::vector<st
         {
             for (unsigned n = 0; n < Utility::Size(header); n++)
             {
-                printf("%s%*.*s",
+                pager.Printf("%s%*.*s",
                     n == 0 ? "" : gap,
                     widths[n]*justify[n], int(header[n].size()), header[n].data());
             }
 
-            printf("\n%.*s\n", dashlen, dashline);
+            pager.Printf("\n%.*s\n", dashlen, dashline);
         }
 
         nlines++;
 
         // common information for each breakpoint
-        printf("%*u%s%*s%s%*s%s%*u%s%.*s",
+        pager.Printf("%*u%s%*s%s%*s%s%*u%s%.*s",
             widths[0]*justify[0], bp.id, gap,
             widths[1]*justify[1], (bp.enabled ? "y" : "n"), gap,
             widths[2]*justify[2], (bp.resolved ? "y" : "n"), gap,
@@ -1390,22 +1670,22 @@ HRESULT CLIProtocol::doCommand<CommandTag::InfoBreakpoints>(const std::vector<st
 
         if (!bp.funcsig.empty())
         {
-            printf("%.*s", int(bp.funcsig.size()), bp.funcsig.data());
+            pager.Printf("%.*s", int(bp.funcsig.size()), bp.funcsig.data());
         }
         else if (bp.line)
         {
-            printf(":%u", bp.line);
+            pager.Printf(":%u", bp.line);
         }
 
         if (!bp.module.empty())
-            printf("\n%*s[in %.*s]", offset, "", int(bp.module.size()), bp.module.data());
+            pager.Printf("\n%*s[in %.*s]", offset, "", int(bp.module.size()), bp.module.data());
 
         if (!bp.condition.empty())
-            printf("\n%*sif (%.*s)", offset, "", int(bp.condition.size()), bp.condition.data());
+            pager.Printf("\n%*sif (%.*s)", offset, "", int(bp.condition.size()), bp.condition.data());
 
-        printf("\n");
+        pager.Printf("\n");
 
-        return true;  // return false to stop enumerating breakpoints
+        return !pager.Aborted();  // return false to stop enumerating breakpoints
     };
 
     m_sharedDebugger->EnumerateBreakpoints(printer);
@@ -1561,29 +1841,40 @@ HRESULT CLIProtocol::doCommand<CommandTag::Next>(const std::vector<std::string>
     return StepCommand(args, output, IDebugger::StepType::STEP_OVER);
 }
 
-HRESULT CLIProtocol::PrintVariable(const Variable &v, std::ostringstream &ss, bool expand, bool is_static)
+HRESULT CLIProtocol::PrintVariable(const Variable &v, Pager &pager, bool expand, bool is_static)
 {
     if (v.namedVariables > 0 && expand)
     {
-        std::vector<Variable> children;
-
         if (is_static)
-            ss << "" << v.name << ": {";
+            pager.Print(v.name + ": {");
         else
-            ss << v.name << " = " << v.value << ": {";
+            pager.Print(v.name + " = " + v.value + ": {");
 
-        m_sharedDebugger->GetVariables(v.variablesReference, VariablesBoth, 0, v.namedVariables, children);
-        for (auto &child : children)
+        // Children are requested and printed by chunks, so huge arrays are not loaded into memory at once.
+        static const int ChildrenChunk = 100;
+        const char *sep = "";
+        for (int start = 0; start < v.namedVariables && !pager.Aborted(); start += ChildrenChunk)
         {
-            bool stm = (child.name == "Static members") ? true : false;
-            PrintVariable (child, ss, stm, stm);
-            ss << ", ";
+            std::vector<Variable> children;
+            m_sharedDebugger->GetVariables(v.variablesReference, VariablesBoth, start, std::min(ChildrenChunk, v.namedVariables - start), children);
+            if (children.empty())
+                break;
+
+            for (auto &child : children)
+            {
+                if (!pager.Print(sep))
+                    break;
+                sep = ", ";
+
+                bool stm = (child.name == "Static members") ? true : false;
+                PrintVariable (child, pager, stm, stm);
+            }
         }
-        ss << "\b\b}";
+        pager.Print("}");
     }
     else
     {
-        ss << v.name << " = " << v.value;
+        pager.Print(v.name + " = " + v.value);
     }
     return S_OK;
 }
@@ -1594,7 +1885,6 @@ HRESULT CLIProtocol::doCommand<CommandTag::Print>(const std::vector<std::string>
     ThreadId threadId;
     FrameId frameId;
     Variable v(0);
-    std::ostringstream ss;
 
     {
         lock_guard lock(m_mutex);
@@ -1617,8 +1907,9 @@ HRESULT CLIProtocol::doCommand<CommandTag::Print>(const std::vector<std::string>
     HRESULT Status;
     IfFailRet(m_sharedDebugger->Evaluate(frameId, m_lastPrintArg, v, output));
     v.name = m_lastPrintArg;
-    PrintVariable (v, ss, true, false);
-    output = ss.str();
+    Pager pager(*this);
+    PrintVariable (v, pager, true, false);
+    pager.Print("\n");
     return S_OK;
 }
 
@@ -1897,6 +2188,19 @@ HRESULT CLIProtocol::doCommand<CommandTag::SetStepFiltering>(const std::vector<s
     return S_OK;
 }
 
+template <>
+HRESULT CLIProtocol::doCommand<CommandTag::SetHeight>(const std::vector<std::string> &args, std::string &output)
+{
+    bool ok = false;
+    int height = args.empty() ? 0 : ProtocolUtils::ParseInt(args[0], ok);
+    if (!ok || height < 0)
+        return E_INVALIDARG;
+
+    lock_guard lock(m_mutex);
+    m_pageHeight = height;
+    return S_OK;
+}
+
 template <>
 HRESULT CLIProtocol::doCommand<CommandTag::SetHelp>(const std::vector<std::string> &args, std::string &output)
 {
@@ -2151,6 +2455,12 @@ std::tuple<string_view, CLIProtocol::LineReader::Result> CLIProtocol::getLine(co
     return line_reader->get_line(prompt);
 }
 
+std::tuple<string_view, CLIProtocol::LineReader::Result> CLIProtocol::getAnswer(const char *prompt)
+{
+    assert(line_reader);
+    return line_reader->get_answer(prompt);
+}
+
 
 HRESULT CLIProtocol::execCommands(LineReader&& lr, bool printCommands)
 {
@@ -2247,10 +2557,10 @@ HRESULT CLIProtocol::execCommands(LineReader&& lr, bool printCommands)
         {
             std::vector<std::string> args;
             args.reserve(10);
-            std::string result;
+            string_view result;
             Tokenizer tokenizer(str.substr(prefix_len));
             while (tokenizer.Next(result))
-               args.push_back(result);
+               args.emplace_back(result.data(), result.size());
 
             hr = (this->*func)(args, output);
             have_result = true;
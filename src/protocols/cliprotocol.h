@@ -178,7 +178,14 @@ private:
                         std::string &output,
                         IDebugger::StepType stepType);
     HRESULT PrintFrames(ThreadId threadId, std::string &output, FrameLevel lowFrame, FrameLevel highFrame);
-    HRESULT PrintVariable(const Variable &v, std::ostringstream &output, bool expand, bool is_static);
+
+    // Pagination for commands with potentially huge output (see cliprotocol.cpp).
+    class Pager;
+
+    // Lines per screen for pagination, 0 - pagination disabled, -1 - terminal height.
+    int m_pageHeight;
+
+    HRESULT PrintVariable(const Variable &v, Pager &pager, bool expand, bool is_static);
     static HRESULT PrintFrameLocation(const StackFrame &stackFrame, std::string &output);
     bool ParseLine(const std::string &str, std::string &token, std::string &cmd, std::vector<std::string> &args);
 
@@ -200,6 +207,13 @@ public:
         virtual std::tuple<string_view, Result> get_line(const char *prompt) = 0;
         virtual void setLastCommand(std::string lc) {}
 
+        // This function reads user's answer to debugger's question (see Pager): answer is not
+        // added to commands history and empty answer is not replaced by last command.
+        virtual std::tuple<string_view, Result> get_answer(const char *prompt) { return get_line(prompt); }
+
+        // Lines are read from user's (pseudo)terminal, so user could be asked to continue output (see Pager).
+        virtual bool isInteractive() const { return false; }
+
         virtual ~LineReader() {}
     };
 
@@ -211,6 +225,9 @@ private:
     // to read input lines for interpreting (commands, etc...)
     std::tuple<string_view, LineReader::Result> getLine(const char *prompt);
 
+    // This function should be used to read user's answers (not commands).
+    std::tuple<string_view, LineReader::Result> getAnswer(const char *prompt);
+
     // This function interprets commands from the input till reaching Eof or Error.
     // Function returns E_FAIL in case of input error.
     HRESULT execCommands(LineReader&&, bool printCommands = false);
@@ -206,7 +206,7 @@ static HRESULT PrintFrames(std::shared_ptr<IDebugger> &sharedDebugger, ThreadId
     return S_OK;
 }
 
-static HRESULT PrintVariables(const std::vector<Variable> &variables, std::string &output)
+static HRESULT PrintVariables(const std::vector<Variable> &variables, VariablesValues values, std::string &output)
 {
     std::ostringstream ss;
     ss << "variables=[";
@@ -218,7 +218,11 @@ static HRESULT PrintVariables(const std::vector<Variable> &variables, std::strin
         sep = ",";
 
         ss << "{name=\"" << MIProtocol::EscapeMIValue(var.name) << "\"";
-        ss << ",value=\"" << MIProtocol::EscapeMIValue(var.value) << "\"";
+        if (values == VariablesSimpleValues)
+            ss << ",type=\"" << MIProtocol::EscapeMIValue(var.type) << "\"";
+        // In simple values mode complex values are not printed at all (same as GDB does).
+        if (values == VariablesAllValues || (values == VariablesSimpleValues && !var.value.empty()))
+            ss << ",value=\"" << MIProtocol::EscapeMIValue(var.value) << "\"";
         ss << "}";
     }
 
@@ -319,9 +323,50 @@ void MIProtocol::Cleanup()
     m_breakpointsHandle.Cleanup();
 }
 
+// Snapshot data is not changed by continue/step, so, var object is reused until it was deleted or all var objects cleared.
+HRESULT MIProtocol::VariablesHandle::PrintSnapshotLocals(const Snapshot &snapshot, FrameLevel level, std::string &output)
+{
+    if (int(level) < 0 || size_t(int(level)) >= snapshot.frames.size())
+        return E_INVALIDARG;
+
+    const SnapshotFrame &frame = snapshot.frames[int(level)];
+    const std::string key = std::to_string(snapshot.id) + ":" + std::to_string(int(level));
+    auto find = m_snapshotVars.find(key);
+    if (find != m_snapshotVars.end())
+    {
+        auto var = m_vars.find(find->second);
+        if (var != m_vars.end())
+        {
+            PrintVar(var->first, var->second.variable, snapshot.threadId, 0, output);
+            return S_OK;
+        }
+        m_snapshotVars.erase(find);
+    }
+
+    Variable locals;
+    locals.name = frame.scope.name;
+    locals.variablesReference = frame.scope.variablesReference;
+    locals.namedVariables = frame.scope.namedVariables;
+    std::string name = "var" + std::to_string(m_vars.size() + 1);
+    HRESULT Status;
+    IfFailRet(PrintNewVar(name, locals, snapshot.threadId, level, 0, output));
+    m_snapshotVars[key] = name;
+    return S_OK;
+}
+
+void MIProtocol::VariablesHandle::DeleteSnapshotVars()
+{
+    for (const auto &entry : m_snapshotVars)
+    {
+        m_vars.erase(entry.second);
+    }
+    m_snapshotVars.clear();
+}
+
 void MIProtocol::VariablesHandle::Cleanup()
 {
     m_vars.clear();
+    m_snapshotVars.clear();
 }
 
 HRESULT MIProtocol::VariablesHandle::PrintChildren(std::vector<Variable> &children, ThreadId threadId, FrameLevel level,
@@ -605,6 +650,32 @@ static HRESULT HandleCommand(std::shared_ptr<IDebugger> &sharedDebugger, Breakpo
         Breakpoint breakpoint;
         std::vector<std::string> args = unmutable_args;
 
+        // Snapshot breakpoint: `--snapshot <frames>` and optional `--snapshot-depth <depth>` (members expand level).
+        SnapshotSettings snapshot(ProtocolUtils::GetIntArg(args, "--snapshot", 0), ProtocolUtils::GetIntArg(args, "--snapshot-depth", 1));
+        // Thread specific breakpoint: `-p <thread-id>` (same as GDB) and/or `--thread-name <pattern>`.
+        ThreadFilter thread;
+        ProtocolUtils::FindAndEraseArgValue(args, "--thread-name", thread.namePattern);
+        std::string threadIdArg;
+        if (ProtocolUtils::FindAndEraseArgValue(args, "-p", threadIdArg))
+        {
+            bool ok;
+            int threadId = ProtocolUtils::ParseInt(threadIdArg, ok);
+            if (!ok || threadId <= 0)
+            {
+                output = "Wrong thread id specified";
+                return E_FAIL;
+            }
+            thread.threadId = ThreadId{threadId};
+        }
+        // Dependent breakpoint: `--trigger <bkpt-id>`, breakpoint is disabled until trigger breakpoint hit.
+        // Note, trigger breakpoint don't stop debuggee, but enable dependent breakpoints and continue.
+        int triggerId = ProtocolUtils::GetIntArg(args, "--trigger", 0);
+        if (triggerId < 0)
+        {
+            output = "Wrong trigger breakpoint id specified";
+            return E_FAIL;
+        }
+
         ProtocolUtils::StripArgs(args);
 
         BreakType bt = ProtocolUtils::GetBreakpointType(args);
@@ -619,21 +690,21 @@ static HRESULT HandleCommand(std::shared_ptr<IDebugger> &sharedDebugger, Breakpo
         {
             struct LineBreak lb;
 
-            if (ProtocolUtils::ParseBreakpoint(args, lb)
-                && SUCCEEDED(breakpointsHandle.SetLineBreakpoint(sharedDebugger, lb.module, lb.filename, lb.linenum, lb.condition, breakpoint)))
-                Status = S_OK;
+            if (ProtocolUtils::ParseBreakpoint(args, lb))
+                Status = breakpointsHandle.SetLineBreakpoint(sharedDebugger, lb.module, lb.filename, lb.linenum, lb.condition, breakpoint, snapshot, thread, triggerId);
         }
         else if (bt == BreakType::FuncBreak)
         {
             struct FuncBreak fb;
 
-            if (ProtocolUtils::ParseBreakpoint(args, fb)
-                && SUCCEEDED(breakpointsHandle.SetFuncBreakpoint(sharedDebugger, fb.module, fb.funcname, fb.params, fb.condition, breakpoint)))
-                Status = S_OK;
+            if (ProtocolUtils::ParseBreakpoint(args, fb))
+                Status = breakpointsHandle.SetFuncBreakpoint(sharedDebugger, fb.module, fb.funcname, fb.params, fb.condition, breakpoint, snapshot, thread, triggerId);
         }
 
-        if (Status == S_OK)
+        if (SUCCEEDED(Status))
             PrintBreakpoint(breakpoint, output);
+        else if (Status == E_INVALIDARG && triggerId != 0)
+            output = "Unknown trigger breakpoint id " + std::to_string(triggerId);
         else
             output = "Unknown breakpoint location format";
 
@@ -710,6 +781,82 @@ static HRESULT HandleCommand(std::shared_ptr<IDebugger> &sharedDebugger, Breakpo
         });
         return S_OK;
     }},
+    { "break-snapshot-list", [&](const std::vector<std::string> &, std::string &output) -> HRESULT {
+        HRESULT Status;
+        std::vector<Snapshot> snapshots;
+        IfFailRet(sharedDebugger->GetSnapshots(snapshots));
+
+        std::ostringstream ss;
+        ss << "snapshots=[";
+        const char *sep = "";
+        for (auto &snapshot : snapshots)
+        {
+            ss << sep << "snapshot={id=\"" << snapshot.id << "\",bkptno=\"" << snapshot.breakpointId << "\","
+               << "thread-id=\"" << int(snapshot.threadId) << "\",frames=[";
+            sep = ",";
+
+            const char *frameSep = "";
+            for (size_t i = 0; i < snapshot.frames.size(); i++)
+            {
+                SnapshotFrame &frame = snapshot.frames[i];
+                ss << frameSep << "frame={level=\"" << i << "\",func=\"" << MIProtocol::EscapeMIValue(frame.name) << "\",";
+                frameSep = ",";
+                if (!frame.source.IsNull())
+                {
+                    ss << "file=\"" << MIProtocol::EscapeMIValue(frame.source.name) << "\","
+                       << "fullname=\"" << MIProtocol::EscapeMIValue(frame.source.path) << "\","
+                       << "line=\"" << frame.line << "\","
+                       << "col=\"" << frame.column << "\",";
+                }
+
+                // Frame's locals var object is created by `break-snapshot-locals` request only.
+                ss << "locals-numchild=\"" << frame.scope.namedVariables << "\"}";
+            }
+            ss << "]}";
+        }
+        ss << "]";
+        output = ss.str();
+        return S_OK;
+    } },
+    { "break-snapshot-locals", [&](const std::vector<std::string> &args, std::string &output) -> HRESULT {
+        // Frame's locals are provided as var object, children could be requested by `var-list-children`.
+        if (args.size() != 2)
+        {
+            output = "Command requires 2 arguments";
+            return E_FAIL;
+        }
+
+        bool ok1, ok2;
+        int id = ProtocolUtils::ParseInt(args.at(0), ok1);
+        int level = ProtocolUtils::ParseInt(args.at(1), ok2);
+        if (!ok1 || !ok2)
+        {
+            output = "Unknown snapshot id or frame level";
+            return E_FAIL;
+        }
+
+        HRESULT Status;
+        std::vector<Snapshot> snapshots;
+        IfFailRet(sharedDebugger->GetSnapshots(snapshots));
+        for (const auto &snapshot : snapshots)
+        {
+            if (snapshot.id != uint32_t(id))
+                continue;
+
+            std::string varout;
+            IfFailRet(variablesHandle.PrintSnapshotLocals(snapshot, FrameLevel{level}, varout));
+            output = "locals={" + varout + "}";
+            return S_OK;
+        }
+
+        output = "Unknown snapshot id";
+        return E_FAIL;
+    } },
+    { "break-snapshot-delete", [&](const std::vector<std::string> &, std::string &) -> HRESULT {
+        sharedDebugger->DeleteSnapshots();
+        variablesHandle.DeleteSnapshotVars();
+        return S_OK;
+    } },
     { "break-condition", [&](const std::vector<std::string> &args, std::string &output) -> HRESULT {
         if (args.size() < 2)
         {
@@ -731,6 +878,30 @@ static HRESULT HandleCommand(std::shared_ptr<IDebugger> &sharedDebugger, Breakpo
 
         return breakpointsHandle.SetFuncBreakpointCondition(sharedDebugger, id, args.at(1));
     } },
+    { "break-commands", [&](const std::vector<std::string> &args, std::string &output) -> HRESULT {
+        // Commands executed by debugger at breakpoint hit: `print <expr>`, `backtrace` and `continue` (don't stop).
+        // Note, breakpoint without commands provided will reset commands list.
+        if (args.empty())
+        {
+            output = "Command requires at least 1 argument";
+            return E_FAIL;
+        }
+
+        bool ok;
+        int id = ProtocolUtils::ParseInt(args.at(0), ok);
+        if (!ok)
+        {
+            output = "Unknown breakpoint id";
+            return E_FAIL;
+        }
+
+        std::vector<std::string> commands(args.begin() + 1, args.end());
+        HRESULT Status = breakpointsHandle.SetLineBreakpointCommands(sharedDebugger, id, commands);
+        if (SUCCEEDED(Status))
+            return Status;
+
+        return breakpointsHandle.SetFuncBreakpointCommands(sharedDebugger, id, commands);
+    } },
     { "exec-step", [&](const std::vector<std::string> &args, std::string &output) -> HRESULT {
         return StepCommand(sharedDebugger, variablesHandle, args, IDebugger::StepType::STEP_IN, output);
     }},
@@ -775,20 +946,58 @@ static HRESULT HandleCommand(std::shared_ptr<IDebugger> &sharedDebugger, Breakpo
         ProtocolUtils::GetIndices(args, lowFrame, highFrame);
         return PrintFrames(sharedDebugger, threadId, output, FrameLevel{lowFrame}, FrameLevel{highFrame}, hotReloadAwareCaller);
     }},
-    { "stack-list-variables", [&](const std::vector<std::string> &args, std::string &output) -> HRESULT {
+    { "stack-info-depth", [&](const std::vector<std::string> &args_orig, std::string &output) -> HRESULT {
         HRESULT Status;
+        std::vector<std::string> args = args_orig;
+        ThreadId threadId { ProtocolUtils::GetIntArg(args, "--thread", int(sharedDebugger->GetLastStoppedThreadId())) };
+        ProtocolUtils::StripArgs(args);
+        int maxDepth = 0; // unlimited
+        if (!args.empty())
+        {
+            bool ok;
+            maxDepth = ProtocolUtils::ParseInt(args.at(0), ok);
+            if (!ok || maxDepth < 0)
+            {
+                output = "Invalid max-depth";
+                return E_FAIL;
+            }
+        }
 
+        int depth = 0;
+        IfFailRet(sharedDebugger->GetStackDepth(threadId, maxDepth, depth));
+        output = "depth=\"" + std::to_string(depth) + "\"";
+        return S_OK;
+    }},
+    { "stack-list-variables", [&](const std::vector<std::string> &args_orig, std::string &output) -> HRESULT {
+        HRESULT Status;
+
+        std::vector<std::string> args = args_orig;
         ThreadId threadId { ProtocolUtils::GetIntArg(args, "--thread", int(sharedDebugger->GetLastStoppedThreadId())) };
         StackFrame stackFrame(threadId, FrameLevel{ProtocolUtils::GetIntArg(args, "--frame", 0)}, "");
+
+        VariablesValues values = VariablesAllValues;
+        if (ProtocolUtils::FindAndEraseArg(args, "--no-values"))
+            values = VariablesNoValues;
+        else if (ProtocolUtils::FindAndEraseArg(args, "--simple-values"))
+            values = VariablesSimpleValues;
+        else if (!ProtocolUtils::FindAndEraseArg(args, "--all-values"))
+        {
+            ProtocolUtils::StripArgs(args);
+            if (!args.empty() && args.back() == "0")
+                values = VariablesNoValues;
+            else if (!args.empty() && args.back() == "2")
+                values = VariablesSimpleValues;
+        }
+
         std::vector<Scope> scopes;
         std::vector<Variable> variables;
         IfFailRet(sharedDebugger->GetScopes(stackFrame.id, scopes));
         if (!scopes.empty() && scopes[0].variablesReference != 0)
         {
-            IfFailRet(sharedDebugger->GetVariables(scopes[0].variablesReference, VariablesNamed, 0, 0, variables));
+            IfFailRet(sharedDebugger->GetVariables(scopes[0].variablesReference, VariablesNamed, 0, 0, variables, values));
         }
 
-        PrintVariables(variables, output);
+        PrintVariables(variables, values, output);
 
         return S_OK;
     }},
@@ -900,6 +1109,8 @@ static HRESULT HandleCommand(std::shared_ptr<IDebugger> &sharedDebugger, Breakpo
             sharedDebugger->SetStepFiltering(args.at(1) == "1");
         else if (args.at(0) == "enable-hot-reload")
             return sharedDebugger->SetHotReload(args.at(1) == "1");
+        else if (args.at(0) == "enable-properties-helper")
+            return sharedDebugger->SetPropertiesHelper(args.at(1) == "1");
         else
             return E_FAIL;
 
@@ -1016,66 +1227,75 @@ static HRESULT HandleCommand(std::shared_ptr<IDebugger> &sharedDebugger, Breakpo
     return command_it->second(args, output);
 }
 
+// Note, all output containers are reused by caller for each line, so memory allocated only in case
+// some token don't fit into already allocated capacity.
 static bool ParseLine(const std::string &str, std::string &token, std::string &cmd, std::vector<std::string> &args)
 {
     token.clear();
     cmd.clear();
-    args.clear();
 
     Tokenizer tokenizer(str);
-    std::string result;
+    string_view result;
+    size_t argsCount = 0;
+    auto AddArg = [&](string_view arg)
+    {
+        if (argsCount < args.size())
+            args[argsCount].assign(arg.data(), arg.size());
+        else
+            args.emplace_back(arg.data(), arg.size());
+        argsCount++;
+    };
 
     if (!tokenizer.Next(result) || result.empty())
+    {
+        args.clear();
         return false;
+    }
 
     std::size_t i = result.find_first_not_of("0123456789");
-    if (i == std::string::npos)
-        return false;
-
-    if (result.at(i) != '-')
+    if (i == string_view::npos || result[i] != '-')
+    {
+        args.clear();
         return false;
+    }
 
-    token = result.substr(0, i);
-    cmd = result.substr(i + 1);
+    token.assign(result.data(), i);
+    cmd.assign(result.data() + i + 1, result.size() - i - 1);
 
-    if (cmd == "var-assign")
+    if (cmd == "var-assign" || cmd == "break-condition")
     {
         tokenizer.Next(result);
-        args.push_back(result); // name
-        args.push_back(tokenizer.Remain()); // expression
-        return true;
+        AddArg(result); // name or id
+        AddArg(tokenizer.Remain()); // expression
     }
-    else if (cmd == "break-condition")
+    else
     {
-        tokenizer.Next(result);
-        args.push_back(result); // id
-        args.push_back(tokenizer.Remain()); // expression
-        return true;
+        while (tokenizer.Next(result))
+            AddArg(result);
     }
 
-    while (tokenizer.Next(result))
-        args.push_back(result);
-
+    args.resize(argsCount);
     return true;
 }
 
 void MIProtocol::CommandLoop()
 {
+    // Reused for each command line, so scripted sessions don't allocate memory for each line.
     std::string token;
+    std::string input;
+    std::string command;
+    std::vector<std::string> args;
 
     Printf("(gdb)\n");
 
     while (!m_exit)
     {
         token.clear();
-        std::string input;
 
         std::getline(cin, input);
         if (input.empty() && cin.eof())
             break;
 
-        std::vector<std::string> args;
-        std::string command;
         if (!ParseLine(input, token, command, args))
         {
             Printf("%s^error,msg=\"Failed to parse input\"\n", token.c_str());
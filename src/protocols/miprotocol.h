@@ -60,6 +60,8 @@ public:
     {
     private:
         std::unordered_map<std::string, MIVariable> m_vars;
+        // Snapshot frame locals var objects created by request and reused: `<snapshot id>:<frame level>` -> var object name.
+        std::unordered_map<std::string, std::string> m_snapshotVars;
 
     public:
         HRESULT CreateVar(std::shared_ptr<IDebugger> &sharedDebugger, ThreadId threadId, FrameLevel level, int evalFlags,
@@ -70,6 +72,8 @@ public:
         HRESULT PrintNewVar(const std::string& varobjName, Variable &v, ThreadId threadId, FrameLevel level, int print_values, std::string &output);
         HRESULT ListChildren(std::shared_ptr<IDebugger> &sharedDebugger, int childStart, int childEnd,
                              const MIVariable &miVariable, int print_values, std::string &output);
+        HRESULT PrintSnapshotLocals(const Snapshot &snapshot, FrameLevel level, std::string &output);
+        void DeleteSnapshotVars();
         void Cleanup();
     };
 
@@ -51,7 +51,9 @@ HRESULT BreakpointsHandle::UpdateLineBreakpoint(std::shared_ptr<IDebugger> &shar
 
 HRESULT BreakpointsHandle::SetLineBreakpoint(std::shared_ptr<IDebugger> &sharedDebugger,
                                              const std::string &module, const std::string &filename, int linenum,
-                                             const std::string &condition, Breakpoint &breakpoint)
+                                             const std::string &condition, Breakpoint &breakpoint,
+                                             const SnapshotSettings &snapshot, const ThreadFilter &thread,
+                                             uint32_t triggerId)
 {
     HRESULT Status;
 
@@ -61,6 +63,9 @@ HRESULT BreakpointsHandle::SetLineBreakpoint(std::shared_ptr<IDebugger> &sharedD
         lineBreakpoints.push_back(it.second);
 
     lineBreakpoints.emplace_back(module, linenum, condition);
+    lineBreakpoints.back().snapshot = snapshot;
+    lineBreakpoints.back().thread = thread;
+    lineBreakpoints.back().triggerId = triggerId;
 
     std::vector<Breakpoint> breakpoints;
     IfFailRet(sharedDebugger->SetLineBreakpoints(filename, lineBreakpoints, breakpoints));
@@ -73,7 +78,9 @@ HRESULT BreakpointsHandle::SetLineBreakpoint(std::shared_ptr<IDebugger> &sharedD
 
 HRESULT BreakpointsHandle::SetFuncBreakpoint(std::shared_ptr<IDebugger> &sharedDebugger,
                                              const std::string &module, const std::string &funcname, const std::string &params,
-                                             const std::string &condition, Breakpoint &breakpoint)
+                                             const std::string &condition, Breakpoint &breakpoint,
+                                             const SnapshotSettings &snapshot, const ThreadFilter &thread,
+                                             uint32_t triggerId)
 {
     HRESULT Status;
 
@@ -82,6 +89,9 @@ HRESULT BreakpointsHandle::SetFuncBreakpoint(std::shared_ptr<IDebugger> &sharedD
         funcBreakpoints.push_back(it.second);
 
     funcBreakpoints.emplace_back(module, funcname, params, condition);
+    funcBreakpoints.back().snapshot = snapshot;
+    funcBreakpoints.back().thread = thread;
+    funcBreakpoints.back().triggerId = triggerId;
 
     std::vector<Breakpoint> breakpoints;
     IfFailRet(sharedDebugger->SetFuncBreakpoints(funcBreakpoints, breakpoints));
@@ -161,6 +171,48 @@ HRESULT BreakpointsHandle::SetFuncBreakpointCondition(std::shared_ptr<IDebugger>
     return sharedDebugger->SetFuncBreakpoints(existingFuncBreakpoints, tmpBreakpoints);
 }
 
+HRESULT BreakpointsHandle::SetLineBreakpointCommands(std::shared_ptr<IDebugger> &sharedDebugger, uint32_t id, const std::vector<std::string> &commands)
+{
+    for (auto &breakpointsIter : m_lineBreakpoints)
+    {
+        std::unordered_map<uint32_t, LineBreakpoint> &fileBreakpoints = breakpointsIter.second;
+
+        const auto &sbIter = fileBreakpoints.find(id);
+        if (sbIter == fileBreakpoints.end())
+            continue;
+
+        sbIter->second.commands = commands;
+
+        std::vector<LineBreakpoint> existingBreakpoints;
+        existingBreakpoints.reserve(fileBreakpoints.size());
+        for (const auto &it : fileBreakpoints)
+            existingBreakpoints.emplace_back(it.second);
+
+        const std::string &filename = breakpointsIter.first;
+        std::vector<Breakpoint> tmpBreakpoints;
+        return sharedDebugger->SetLineBreakpoints(filename, existingBreakpoints, tmpBreakpoints);
+    }
+
+    return E_FAIL;
+}
+
+HRESULT BreakpointsHandle::SetFuncBreakpointCommands(std::shared_ptr<IDebugger> &sharedDebugger, uint32_t id, const std::vector<std::string> &commands)
+{
+    const auto &fbIter = m_funcBreakpoints.find(id);
+    if (fbIter == m_funcBreakpoints.end())
+        return E_FAIL;
+
+    fbIter->second.commands = commands;
+
+    std::vector<FuncBreakpoint> existingFuncBreakpoints;
+    existingFuncBreakpoints.reserve(m_funcBreakpoints.size());
+    for (const auto &fb : m_funcBreakpoints)
+        existingFuncBreakpoints.emplace_back(fb.second);
+
+    std::vector<Breakpoint> tmpBreakpoints;
+    return sharedDebugger->SetFuncBreakpoints(existingFuncBreakpoints, tmpBreakpoints);
+}
+
 void BreakpointsHandle::DeleteLineBreakpoints(std::shared_ptr<IDebugger> &sharedDebugger, const std::unordered_set<uint32_t> &ids)
 {
     for (auto &breakpointsIter : m_lineBreakpoints)
@@ -301,6 +353,71 @@ bool FindAndEraseArg(std::vector<std::string> &args, const std::string& name)
     return false;
 }
 
+// Return `true` in case arg with value was found and erased, value returned in `value`.
+bool FindAndEraseArgValue(std::vector<std::string> &args, const std::string &name, std::string &value)
+{
+    auto it = std::find(args.begin(), args.end(), name);
+    if (it == args.end() || it + 1 == args.end())
+        return false;
+
+    value = *(it + 1);
+    args.erase(it, it + 2);
+    return true;
+}
+
+// Skip `-f` and `-c <condition>` options at breakpoint args start.
+static std::vector<std::string>::iterator BreakpointLocationBegin(std::vector<std::string> &args)
+{
+    auto it = args.begin();
+    if (it != args.end() && *it == "-f")
+        ++it;
+    if (it != args.end() && *it == "-c")
+        it = (it + 1 == args.end()) ? args.end() : it + 2;
+    return it;
+}
+
+// Same as FindAndEraseArgValue(), but search only breakpoint location part, so, `-c <condition>`
+// option and `if <condition>` suffix tokens are never treated as breakpoint arguments.
+bool FindAndEraseBreakpointArgValue(std::vector<std::string> &args, const std::string &name, std::string &value)
+{
+    auto begin = BreakpointLocationBegin(args);
+    auto end = std::find(begin, args.end(), std::string("if"));
+    auto it = std::find(begin, end, name);
+    if (it == end || it + 1 == end)
+        return false;
+
+    value = *(it + 1);
+    args.erase(it, it + 2);
+    return true;
+}
+
+// Convert `<loc> if <condition>` suffix into `-c <condition>` option, return `false` in case
+// condition is empty or breakpoint have both forms of condition.
+bool FindAndEraseBreakpointCondition(std::vector<std::string> &args)
+{
+    const size_t optPos = (!args.empty() && args.front() == "-f") ? 1 : 0;
+    const bool hasCondOption = args.size() > optPos && args.at(optPos) == "-c";
+    auto it = std::find(BreakpointLocationBegin(args), args.end(), std::string("if"));
+    if (it == args.end())
+        return true;
+
+    if (it + 1 == args.end() || hasCondOption)
+        return false;
+
+    std::string condition;
+    for (auto cond = it + 1; cond != args.end(); ++cond)
+    {
+        if (!condition.empty())
+            condition += " ";
+        condition += *cond;
+    }
+    args.erase(it, args.end());
+
+    auto condPos = args.insert(args.begin() + optPos, condition);
+    args.insert(condPos, "-c");
+    return true;
+}
+
 bool GetIndices(const std::vector<std::string> &args, int &index1, int &index2)
 {
     if (args.size() < 2)
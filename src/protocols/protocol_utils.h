@@ -44,13 +44,19 @@ private:
 public:
     HRESULT UpdateLineBreakpoint(std::shared_ptr<IDebugger> &sharedDebugger, int id, int linenum, Breakpoint &breakpoint);
     HRESULT SetLineBreakpoint(std::shared_ptr<IDebugger> &sharedDebugger, const std::string &module, const std::string &filename,
-                              int linenum, const std::string &condition, Breakpoint &breakpoints);
+                              int linenum, const std::string &condition, Breakpoint &breakpoints,
+                              const SnapshotSettings &snapshot = SnapshotSettings(), const ThreadFilter &thread = ThreadFilter(),
+                              uint32_t triggerId = 0);
     HRESULT SetFuncBreakpoint(std::shared_ptr<IDebugger> &sharedDebugger, const std::string &module, const std::string &funcname,
-                              const std::string &params, const std::string &condition, Breakpoint &breakpoint);
+                              const std::string &params, const std::string &condition, Breakpoint &breakpoint,
+                              const SnapshotSettings &snapshot = SnapshotSettings(), const ThreadFilter &thread = ThreadFilter(),
+                              uint32_t triggerId = 0);
     HRESULT SetExceptionBreakpoints(std::shared_ptr<IDebugger> &sharedDebugger, std::vector<ExceptionBreakpoint> &excBreakpoints,
                                     std::vector<Breakpoint> &breakpoints);
     HRESULT SetLineBreakpointCondition(std::shared_ptr<IDebugger> &sharedDebugger, uint32_t id, const std::string &condition);
     HRESULT SetFuncBreakpointCondition(std::shared_ptr<IDebugger> &sharedDebugger, uint32_t id, const std::string &condition);
+    HRESULT SetLineBreakpointCommands(std::shared_ptr<IDebugger> &sharedDebugger, uint32_t id, const std::vector<std::string> &commands);
+    HRESULT SetFuncBreakpointCommands(std::shared_ptr<IDebugger> &sharedDebugger, uint32_t id, const std::vector<std::string> &commands);
     void DeleteLineBreakpoints(std::shared_ptr<IDebugger> &sharedDebugger, const std::unordered_set<uint32_t> &ids);
     void DeleteFuncBreakpoints(std::shared_ptr<IDebugger> &sharedDebugger, const std::unordered_set<uint32_t> &ids);
     void DeleteExceptionBreakpoints(std::shared_ptr<IDebugger> &sharedDebugger, const std::unordered_set<uint32_t> &ids);
@@ -63,6 +69,9 @@ namespace ProtocolUtils
     void StripArgs(std::vector<std::string> &args);
     int GetIntArg(const std::vector<std::string> &args, const std::string& name, int defaultValue);
     bool FindAndEraseArg(std::vector<std::string> &args, const std::string &name);
+    bool FindAndEraseArgValue(std::vector<std::string> &args, const std::string &name, std::string &value);
+    bool FindAndEraseBreakpointArgValue(std::vector<std::string> &args, const std::string &name, std::string &value);
+    bool FindAndEraseBreakpointCondition(std::vector<std::string> &args);
     bool GetIndices(const std::vector<std::string> &args, int &index1, int &index2);
     BreakType GetBreakpointType(const std::vector<std::string> &args);
     std::string GetConditionPrepareArgs(std::vector<std::string> &args);
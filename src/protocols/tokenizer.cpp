@@ -7,15 +7,16 @@
 namespace netcoredbg
 {
 
-Tokenizer::Tokenizer(const std::string &str, const std::string &delimiters)
+Tokenizer::Tokenizer(string_view str, string_view delimiters)
     : m_str(str), m_delimiters(delimiters), m_next(0)
 {
-    m_str.erase(m_str.find_last_not_of(m_delimiters) + 1);
+    size_t last = m_str.find_last_not_of(m_delimiters);
+    m_str = m_str.substr(0, last == string_view::npos ? 0 : last + 1);
 }
 
-bool Tokenizer::Next(std::string &token)
+bool Tokenizer::Next(string_view &token)
 {
-    token = "";
+    token = string_view();
 
     if (m_next >= m_str.size())
         return false;
@@ -27,44 +28,74 @@ bool Tokenizer::Next(std::string &token)
         StateEscape
     } state = StateSpace;
 
+    // Token is [begin, begin + size) part of input string, until first escape symbol found.
+    size_t begin = 0;
+    size_t size = 0;
+    std::string *unescaped = nullptr;
+
+    auto AddChar = [&](size_t pos)
+    {
+        if (unescaped)
+            unescaped->push_back(m_str[pos]);
+        else if (size++ == 0)
+            begin = pos;
+    };
+
+    auto Empty = [&]() -> bool
+    {
+        return unescaped ? unescaped->empty() : size == 0;
+    };
+
     for (; m_next < m_str.size(); m_next++)
     {
-        char c = m_str.at(m_next);
+        char c = m_str[m_next];
         switch(state)
         {
             case StateSpace:
-                if (m_delimiters.find(c) != std::string::npos)
+                if (m_delimiters.find(c) != string_view::npos)
                     continue;
-                if (!token.empty())
+                if (!Empty())
+                {
+                    token = unescaped ? string_view(*unescaped) : m_str.substr(begin, size);
                     return true;
+                }
                 state = c == '"' ? StateQuotedToken : StateToken;
                 if (state != StateQuotedToken)
-                    token +=c;
+                    AddChar(m_next);
                 break;
             case StateToken:
-                if (m_delimiters.find(c) != std::string::npos)
+                if (m_delimiters.find(c) != string_view::npos)
                     state = StateSpace;
                 else
-                    token += c;
+                    AddChar(m_next);
                 break;
             case StateQuotedToken:
                 if (c == '\\')
+                {
                     state = StateEscape;
+                    if (!unescaped)
+                    {
+                        m_unescaped.emplace_front(m_str.data() + begin, size);
+                        unescaped = &m_unescaped.front();
+                    }
+                }
                 else if (c == '"')
                     state = StateSpace;
                 else
-                    token += c;
+                    AddChar(m_next);
                 break;
             case StateEscape:
-                token += c;
+                AddChar(m_next);
                 state = StateQuotedToken;
                 break;
         }
     }
-    return state != StateEscape || token.empty();
+
+    token = unescaped ? string_view(*unescaped) : m_str.substr(begin, size);
+    return state != StateEscape || Empty();
 }
 
-std::string Tokenizer::Remain() const
+string_view Tokenizer::Remain() const
 {
     return m_str.substr(m_next);
 }
@@ -3,20 +3,28 @@
 // See the LICENSE file in the project root for more information.
 
 #include <string>
+#include <forward_list>
+#include "utils/string_view.h"
 
 namespace netcoredbg
 {
 
+using Utility::string_view;
+
+// Tokenizer don't copy input string, tokens are views into input string (caller must care about input string
+// lifetime). Only quoted tokens with escape symbols are unescaped into tokenizer's own storage, so tokens are
+// valid until tokenizer destroyed.
 class Tokenizer
 {
-    std::string m_str;
-    std::string m_delimiters;
+    string_view m_str;
+    string_view m_delimiters;
     size_t m_next;
+    std::forward_list<std::string> m_unescaped;
 public:
 
-    Tokenizer(const std::string &str, const std::string &delimiters = " \t\n\r");
-    bool Next(std::string &token);
-    std::string Remain() const;
+    Tokenizer(string_view str, string_view delimiters = " \t\n\r");
+    bool Next(string_view &token);
+    string_view Remain() const;
 };
 
 } // namespace netcoredbg
@@ -456,6 +456,32 @@ void VSCodeProtocol::EmitEvent(const std::string &name, const nlohmann::json &bo
     EmitMessageWithLog(LOG_EVENT, message);
 }
 
+// MS vsdbg compatible "symbolOptions" launch/attach argument, only "loadAllButExcluded" modules filter mode supported:
+// "symbolOptions": { "moduleFilter": { "mode": "loadAllButExcluded", "excludedModules": [ "Some.Module.dll", "Other*.dll" ] } }
+static SymbolOptions GetSymbolOptions(const json &arguments)
+{
+    SymbolOptions options;
+    auto symbolOptionsIt = arguments.find("symbolOptions");
+    if (symbolOptionsIt == arguments.end() || !symbolOptionsIt->is_object())
+        return options;
+
+    options.searchPaths = symbolOptionsIt->value("searchPaths", std::vector<std::string>());
+    options.cachePath = symbolOptionsIt->value("cachePath", std::string());
+
+    auto moduleFilterIt = symbolOptionsIt->find("moduleFilter");
+    if (moduleFilterIt == symbolOptionsIt->end() || !moduleFilterIt->is_object())
+        return options;
+
+    if (moduleFilterIt->value("mode", std::string("loadAllButExcluded")) != "loadAllButExcluded")
+    {
+        LOGW("Unsupported symbols module filter mode, all modules symbols will be loaded");
+        return options;
+    }
+
+    options.excludedModules = moduleFilterIt->value("excludedModules", std::vector<std::string>());
+    return options;
+}
+
 static HRESULT HandleCommand(std::shared_ptr<IDebugger> &sharedDebugger, std::string &fileExec, std::vector<std::string> &execArgs,
                              const std::string &command, const json &arguments, json &body)
 {
@@ -574,6 +600,8 @@ static HRESULT HandleCommand(std::shared_ptr<IDebugger> &sharedDebugger, std::st
 
         sharedDebugger->SetJustMyCode(arguments.value("justMyCode", true)); // MS vsdbg have "justMyCode" enabled by default.
         sharedDebugger->SetStepFiltering(arguments.value("enableStepFiltering", true)); // MS vsdbg have "enableStepFiltering" enabled by default.
+        sharedDebugger->SetSymbolOptions(GetSymbolOptions(arguments));
+        sharedDebugger->SetPropertiesHelper(arguments.value("enablePropertiesHelper", false));
 
         if (!fileExec.empty())
             return sharedDebugger->Launch(fileExec, execArgs, env, cwd, arguments.value("stopAtEntry", false));
@@ -774,6 +802,7 @@ static HRESULT HandleCommand(std::shared_ptr<IDebugger> &sharedDebugger, std::st
         else
             return E_INVALIDARG;
 
+        sharedDebugger->SetSymbolOptions(GetSymbolOptions(arguments));
         return sharedDebugger->Attach(processId);
     } },
     { "setVariable", [&](const json &arguments, json &body) {
@@ -1153,6 +1182,7 @@ void VSCodeProtocol::EngineLogging(const std::string &path)
     {
         m_engineLogOutput = LogFile;
         m_engineLog.open(path);
+        m_engineLogStart = std::chrono::steady_clock::now();
     }
 }
 
@@ -1164,9 +1194,12 @@ void VSCodeProtocol::Log(const std::string &prefix, const std::string &text)
         case LogNone:
             return;
         case LogFile:
-            m_engineLog << prefix << text << std::endl;
+        {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_engineLogStart).count();
+            m_engineLog << "[" << std::fixed << std::setprecision(3) << elapsed << "] " << prefix << text << std::endl;
             m_engineLog.flush();
             return;
+        }
         case LogConsole:
         {
             json response;
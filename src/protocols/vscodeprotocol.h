@@ -3,6 +3,7 @@
 // See the LICENSE file in the project root for more information.
 #pragma once
 
+#include <chrono>
 #include <fstream>
 #include <mutex>
 #include <string>
@@ -29,6 +30,8 @@ class VSCodeProtocol : public IProtocol
         LogFile
     } m_engineLogOutput;
     std::ofstream m_engineLog;
+    // File log entries have timestamp (relative to log start), so, recorded session could be replayed with same timing.
+    std::chrono::steady_clock::time_point m_engineLogStart;
     uint64_t m_seqCounter; // Note, this counter must be covered by m_outMutex.
 
     std::string m_fileExec;
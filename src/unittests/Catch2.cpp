@@ -2,5 +2,6 @@
 // See the LICENSE file in the project root for more information.
 
 #define CATCH_CONFIG_COLOUR_NONE
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -11,11 +11,13 @@
 #include <string.h>
 #include <thread>
 #include <chrono>
+#include <vector>
 
 #include "utils/iosystem.h"
 
 #ifndef WIN32
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 typedef int Socket;
@@ -216,6 +218,80 @@ TEST_CASE("IOSystem::socket")
 }
 
 
+#ifndef WIN32
+TEST_CASE("IOSystem::connect_socket")
+{
+    char buf[1024];
+    std::string path = "/tmp/iosystem_test_" + std::to_string(getpid()) + ".sock";
+    ::unlink(path.c_str());
+
+    // nobody listen for connection
+    CHECK(!IOSystem::connect_socket(path));
+
+    Socket listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(listener != INVALID_SOCKET);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    REQUIRE(::bind(listener, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    REQUIRE(::listen(listener, 1) == 0);
+
+    // connection is queued by system, so, it could be done before accept()
+    IOSystem::FileHandle conn = IOSystem::connect_socket(path);
+    REQUIRE(conn);
+    IOSystem::FileHandle sock {::accept(listener, nullptr, nullptr)};
+    REQUIRE(sock);
+
+    auto result = IOSystem::write(conn, test_str, sizeof(test_str)-1);
+    CHECK(result.status == IOSystem::IOResult::Success);
+    CHECK(result.size == sizeof(test_str)-1);
+
+    result = IOSystem::read(sock, buf, sizeof(buf));
+    CHECK(result.status == IOSystem::IOResult::Success);
+    CHECK(result.size == sizeof(test_str)-1);
+    CHECK(!strncmp(test_str, buf, sizeof(test_str)-1));
+
+    IOSystem::close(conn);
+    IOSystem::close(sock);
+    ::close(listener);
+    ::unlink(path.c_str());
+}
+
+TEST_CASE("IOSystem::connect_socket full backlog")
+{
+    std::string path = "/tmp/iosystem_test_backlog_" + std::to_string(getpid()) + ".sock";
+    ::unlink(path.c_str());
+
+    Socket listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(listener != INVALID_SOCKET);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    REQUIRE(::bind(listener, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    REQUIRE(::listen(listener, 1) == 0);
+
+    // nobody accept connections, so, connect must fail after backlog filled instead of blocking
+    static const int MaxConnections = 64;
+    std::vector<IOSystem::FileHandle> connections;
+    for (int i = 0; i < MaxConnections; i++)
+    {
+        IOSystem::FileHandle conn = IOSystem::connect_socket(path);
+        if (!conn)
+            break;
+        connections.push_back(conn);
+    }
+    CHECK(connections.size() < size_t(MaxConnections));
+
+    for (auto &conn : connections)
+        IOSystem::close(conn);
+    ::close(listener);
+    ::unlink(path.c_str());
+}
+#endif // WIN32
+
+
 TEST_CASE("IOSystem::StdIOSwap")
 {
     char buf[1024];
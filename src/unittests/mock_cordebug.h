@@ -0,0 +1,372 @@
+// Copyright (c) 2022 Samsung Electronics Co., LTD
+// Distributed under the MIT License.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "cor.h"
+#include "cordebug.h"
+
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "mock_symbols.h"
+#include "utils/utf.h"
+
+namespace netcoredbg
+{
+namespace Mock
+{
+
+// In-process fake of ICorDebug/metadata interfaces, that provide synthetic assembly data (see mock_symbols.h).
+// Objects are reference counted as real COM objects, so, could be used with ToRelease and stored by debugger code.
+// Only methods used by metadata code are implemented, all other return E_NOTIMPL.
+// Note, frames and values are not provided, since stack trace and variables code can't be built without whole
+// debugger and evaluation stack (managed part included), so, only Modules/ModulesSources are covered.
+
+template <class T>
+class MockRefCount
+{
+public:
+    MockRefCount() : m_refCount(1) {}
+    virtual ~MockRefCount() {}
+
+protected:
+    ULONG AddRefImpl()
+    {
+        return ++m_refCount;
+    }
+
+    ULONG ReleaseImpl()
+    {
+        ULONG count = --m_refCount;
+        if (count == 0)
+            delete static_cast<T*>(this);
+        return count;
+    }
+
+private:
+    std::atomic<ULONG> m_refCount;
+};
+
+inline void CopyName(const std::string &name, WCHAR *buffer, ULONG bufferLen, ULONG *pNameLen)
+{
+    WSTRING wname = to_utf16(name);
+    if (pNameLen)
+        *pNameLen = (ULONG)wname.size() + 1;
+
+    if (buffer == nullptr || bufferLen == 0)
+        return;
+
+    size_t len = std::min((size_t)bufferLen - 1, wname.size());
+    memcpy(buffer, wname.data(), len * sizeof(WCHAR));
+    buffer[len] = 0;
+}
+
+class MockMetaDataImport final : public IMetaDataImport, public MockRefCount<MockMetaDataImport>
+{
+public:
+
+    explicit MockMetaDataImport(const AssemblyInfo &assembly) : m_assembly(assembly) {}
+
+    // IUnknown
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, VOID** ppInterface) override
+    {
+        if (riid == IID_IMetaDataImport)
+            *ppInterface = static_cast<IMetaDataImport*>(this);
+        else if (riid == IID_IUnknown)
+            *ppInterface = static_cast<IUnknown*>(this);
+        else
+        {
+            *ppInterface = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        AddRef();
+        return S_OK;
+    }
+    ULONG STDMETHODCALLTYPE AddRef() override { return AddRefImpl(); }
+    ULONG STDMETHODCALLTYPE Release() override { return ReleaseImpl(); }
+
+    // IMetaDataImport
+
+    void STDMETHODCALLTYPE CloseEnum(HCORENUM hEnum) override
+    {
+        delete static_cast<TokensEnum*>(hEnum);
+    }
+    HRESULT STDMETHODCALLTYPE CountEnum(HCORENUM hEnum, ULONG *pulCount) override
+    {
+        *pulCount = hEnum ? (ULONG)static_cast<TokensEnum*>(hEnum)->tokens.size() : 0;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE ResetEnum(HCORENUM hEnum, ULONG ulPos) override
+    {
+        if (hEnum)
+            static_cast<TokensEnum*>(hEnum)->pos = ulPos;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE EnumTypeDefs(HCORENUM *phEnum, mdTypeDef rTypeDefs[], ULONG cMax, ULONG *pcTypeDefs) override
+    {
+        if (*phEnum == nullptr)
+        {
+            TokensEnum *tokensEnum = new TokensEnum;
+            tokensEnum->tokens.reserve(m_assembly.types.size());
+            for (const auto &type : m_assembly.types)
+            {
+                tokensEnum->tokens.emplace_back(type.typeDef);
+            }
+            *phEnum = tokensEnum;
+        }
+        return FetchTokens(*phEnum, rTypeDefs, cMax, pcTypeDefs);
+    }
+    HRESULT STDMETHODCALLTYPE EnumInterfaceImpls(HCORENUM *, mdTypeDef, mdInterfaceImpl [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumTypeRefs(HCORENUM *, mdTypeRef [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE FindTypeDefByName(LPCWSTR, mdToken, mdTypeDef *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetScopeProps(LPWSTR szName, ULONG cchName, ULONG *pchName, GUID *pmvid) override
+    {
+        CopyName(m_assembly.path.substr(m_assembly.path.find_last_of('/') + 1), szName, cchName, pchName);
+        if (pmvid)
+        {
+            memset(pmvid, 0, sizeof(GUID));
+            pmvid->Data1 = (ULONG)std::hash<std::string>()(m_assembly.path);
+        }
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetModuleFromScope(mdModule *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetTypeDefProps(mdTypeDef td, LPWSTR szTypeDef, ULONG cchTypeDef, ULONG *pchTypeDef,
+                                              DWORD *pdwTypeDefFlags, mdToken *ptkExtends) override
+    {
+        const TypeInfo *type = FindType(td);
+        if (type == nullptr)
+            return CLDB_E_RECORD_NOTFOUND;
+
+        CopyName(type->name, szTypeDef, cchTypeDef, pchTypeDef);
+        if (pdwTypeDefFlags)
+            *pdwTypeDefFlags = tdPublic | tdClass;
+        if (ptkExtends)
+            *ptkExtends = mdTypeRefNil;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetInterfaceImplProps(mdInterfaceImpl, mdTypeDef *, mdToken *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetTypeRefProps(mdTypeRef, mdToken *, LPWSTR, ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE ResolveTypeRef(mdTypeRef, REFIID, IUnknown **, mdTypeDef *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumMembers(HCORENUM *, mdTypeDef, mdToken [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumMembersWithName(HCORENUM *, mdTypeDef, LPCWSTR, mdToken [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumMethods(HCORENUM *phEnum, mdTypeDef cl, mdMethodDef rMethods[], ULONG cMax, ULONG *pcTokens) override
+    {
+        if (*phEnum == nullptr)
+        {
+            TokensEnum *tokensEnum = new TokensEnum;
+            const TypeInfo *type = FindType(cl);
+            if (type != nullptr)
+                tokensEnum->tokens = type->methods;
+            *phEnum = tokensEnum;
+        }
+        return FetchTokens(*phEnum, rMethods, cMax, pcTokens);
+    }
+    HRESULT STDMETHODCALLTYPE EnumMethodsWithName(HCORENUM *, mdTypeDef, LPCWSTR, mdMethodDef [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumFields(HCORENUM *, mdTypeDef, mdFieldDef [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumFieldsWithName(HCORENUM *, mdTypeDef, LPCWSTR, mdFieldDef [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumParams(HCORENUM *, mdMethodDef, mdParamDef [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumMemberRefs(HCORENUM *, mdToken, mdMemberRef [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumMethodImpls(HCORENUM *, mdTypeDef, mdToken [], mdToken [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumPermissionSets(HCORENUM *, mdToken, DWORD, mdPermission [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE FindMember(mdTypeDef, LPCWSTR, PCCOR_SIGNATURE, ULONG, mdToken *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE FindMethod(mdTypeDef, LPCWSTR, PCCOR_SIGNATURE, ULONG, mdMethodDef *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE FindField(mdTypeDef, LPCWSTR, PCCOR_SIGNATURE, ULONG, mdFieldDef *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE FindMemberRef(mdTypeRef, LPCWSTR, PCCOR_SIGNATURE, ULONG, mdMemberRef *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetMethodProps(mdMethodDef mb, mdTypeDef *pClass, LPWSTR szMethod, ULONG cchMethod, ULONG *pchMethod,
+                                             DWORD *pdwAttr, PCCOR_SIGNATURE *ppvSigBlob, ULONG *pcbSigBlob, ULONG *pulCodeRVA, DWORD *pdwImplFlags) override
+    {
+        const MethodInfo *method = m_assembly.FindMethod(mb);
+        if (method == nullptr)
+            return CLDB_E_RECORD_NOTFOUND;
+
+        if (pClass)
+            *pClass = method->typeDef;
+        CopyName(method->name, szMethod, cchMethod, pchMethod);
+        if (pdwAttr)
+            *pdwAttr = mdPublic;
+        if (ppvSigBlob)
+            *ppvSigBlob = nullptr;
+        if (pcbSigBlob)
+            *pcbSigBlob = 0;
+        if (pulCodeRVA)
+            *pulCodeRVA = 0;
+        if (pdwImplFlags)
+            *pdwImplFlags = miIL;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetMemberRefProps(mdMemberRef, mdToken *, LPWSTR, ULONG, ULONG *, PCCOR_SIGNATURE *, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumProperties(HCORENUM *, mdTypeDef, mdProperty [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumEvents(HCORENUM *, mdTypeDef, mdEvent [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetEventProps(mdEvent, mdTypeDef *, LPCWSTR, ULONG, ULONG *, DWORD *, mdToken *, mdMethodDef *,
+                                            mdMethodDef *, mdMethodDef *, mdMethodDef [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumMethodSemantics(HCORENUM *, mdMethodDef, mdToken [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetMethodSemantics(mdMethodDef, mdToken, DWORD *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetClassLayout(mdTypeDef, DWORD *, COR_FIELD_OFFSET [], ULONG, ULONG *, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetFieldMarshal(mdToken, PCCOR_SIGNATURE *, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetRVA(mdToken, ULONG *, DWORD *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetPermissionSetProps(mdPermission, DWORD *, void const **, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetSigFromToken(mdSignature, PCCOR_SIGNATURE *, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetModuleRefProps(mdModuleRef, LPWSTR, ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumModuleRefs(HCORENUM *, mdModuleRef [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetTypeSpecFromToken(mdTypeSpec, PCCOR_SIGNATURE *, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetNameFromToken(mdToken, MDUTF8CSTR *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumUnresolvedMethods(HCORENUM *, mdToken [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetUserString(mdString, LPWSTR, ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetPinvokeMap(mdToken, DWORD *, LPWSTR, ULONG, ULONG *, mdModuleRef *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumSignatures(HCORENUM *, mdSignature [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumTypeSpecs(HCORENUM *, mdTypeSpec [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumUserStrings(HCORENUM *, mdString [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetParamForMethodIndex(mdMethodDef, ULONG, mdParamDef *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnumCustomAttributes(HCORENUM *, mdToken, mdToken, mdCustomAttribute [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetCustomAttributeProps(mdCustomAttribute, mdToken *, mdToken *, void const **, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE FindTypeRef(mdToken, LPCWSTR, mdTypeRef *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetMemberProps(mdToken, mdTypeDef *, LPWSTR, ULONG, ULONG *, DWORD *, PCCOR_SIGNATURE *, ULONG *,
+                                             ULONG *, DWORD *, DWORD *, UVCP_CONSTANT *, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetFieldProps(mdFieldDef, mdTypeDef *, LPWSTR, ULONG, ULONG *, DWORD *, PCCOR_SIGNATURE *, ULONG *,
+                                            DWORD *, UVCP_CONSTANT *, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetPropertyProps(mdProperty, mdTypeDef *, LPCWSTR, ULONG, ULONG *, DWORD *, PCCOR_SIGNATURE *, ULONG *,
+                                               DWORD *, UVCP_CONSTANT *, ULONG *, mdMethodDef *, mdMethodDef *, mdMethodDef [], ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetParamProps(mdParamDef, mdMethodDef *, ULONG *, LPWSTR, ULONG, ULONG *, DWORD *, DWORD *,
+                                            UVCP_CONSTANT *, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetCustomAttributeByName(mdToken, LPCWSTR, const void **, ULONG *) override { return S_FALSE; }
+    BOOL STDMETHODCALLTYPE IsValidToken(mdToken tk) override
+    {
+        return m_assembly.FindMethod(tk) != nullptr || FindType(tk) != nullptr;
+    }
+    HRESULT STDMETHODCALLTYPE GetNestedClassProps(mdTypeDef td, mdTypeDef *ptdEnclosingClass) override
+    {
+        const TypeInfo *type = FindType(td);
+        if (type == nullptr || type->enclosingClass == mdTypeDefNil)
+            return CLDB_E_RECORD_NOTFOUND;
+
+        *ptdEnclosingClass = type->enclosingClass;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetNativeCallConvFromSig(void const *, ULONG, ULONG *) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE IsGlobal(mdToken, int *) override { return E_NOTIMPL; }
+
+private:
+
+    struct TokensEnum
+    {
+        std::vector<mdToken> tokens;
+        size_t pos = 0;
+    };
+
+    const AssemblyInfo &m_assembly;
+
+    const TypeInfo *FindType(mdTypeDef td) const
+    {
+        if (TypeFromToken(td) != mdtTypeDef || RidFromToken(td) < 2 || RidFromToken(td) - 2 >= m_assembly.types.size())
+            return nullptr;
+
+        return &m_assembly.types[RidFromToken(td) - 2];
+    }
+
+    static HRESULT FetchTokens(HCORENUM hEnum, mdToken rTokens[], ULONG cMax, ULONG *pcTokens)
+    {
+        TokensEnum *tokensEnum = static_cast<TokensEnum*>(hEnum);
+        ULONG count = 0;
+        while (count < cMax && tokensEnum->pos < tokensEnum->tokens.size())
+        {
+            rTokens[count++] = tokensEnum->tokens[tokensEnum->pos++];
+        }
+
+        if (pcTokens)
+            *pcTokens = count;
+        return count > 0 ? S_OK : S_FALSE;
+    }
+};
+
+class MockModule final : public ICorDebugModule, public MockRefCount<MockModule>
+{
+public:
+
+    explicit MockModule(const AssemblyInfo &assembly) : m_assembly(assembly) {}
+
+    // IUnknown
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, VOID** ppInterface) override
+    {
+        if (riid == IID_ICorDebugModule)
+            *ppInterface = static_cast<ICorDebugModule*>(this);
+        else if (riid == IID_IUnknown)
+            *ppInterface = static_cast<IUnknown*>(this);
+        else
+        {
+            *ppInterface = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        AddRef();
+        return S_OK;
+    }
+    ULONG STDMETHODCALLTYPE AddRef() override { return AddRefImpl(); }
+    ULONG STDMETHODCALLTYPE Release() override { return ReleaseImpl(); }
+
+    // ICorDebugModule
+
+    HRESULT STDMETHODCALLTYPE GetProcess(ICorDebugProcess **) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetBaseAddress(CORDB_ADDRESS *pAddress) override
+    {
+        *pAddress = m_assembly.baseAddress;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetAssembly(ICorDebugAssembly **) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetName(ULONG32 cchName, ULONG32 *pcchName, WCHAR szName[]) override
+    {
+        ULONG nameLen;
+        CopyName(m_assembly.path, szName, cchName, &nameLen);
+        if (pcchName)
+            *pcchName = nameLen;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE EnableJITDebugging(BOOL, BOOL) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE EnableClassLoadCallbacks(BOOL) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetFunctionFromToken(mdMethodDef, ICorDebugFunction **) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetFunctionFromRVA(CORDB_ADDRESS, ICorDebugFunction **) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetClassFromToken(mdTypeDef, ICorDebugClass **) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE CreateBreakpoint(ICorDebugModuleBreakpoint **) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetEditAndContinueSnapshot(ICorDebugEditAndContinueSnapshot **) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetMetaDataInterface(REFIID riid, IUnknown **ppObj) override
+    {
+        MockMetaDataImport *pMDImport = new MockMetaDataImport(m_assembly);
+        HRESULT Status = pMDImport->QueryInterface(riid, (VOID**)ppObj);
+        pMDImport->Release();
+        return Status;
+    }
+    HRESULT STDMETHODCALLTYPE GetToken(mdModule *pToken) override
+    {
+        *pToken = mdModuleNil + 1;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE IsDynamic(BOOL *pDynamic) override
+    {
+        *pDynamic = FALSE;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE GetGlobalVariableValue(mdFieldDef, ICorDebugValue **) override { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE GetSize(ULONG32 *pcBytes) override
+    {
+        *pcBytes = m_assembly.size;
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE IsInMemory(BOOL *pInMemory) override
+    {
+        *pInMemory = FALSE;
+        return S_OK;
+    }
+
+private:
+
+    const AssemblyInfo &m_assembly;
+};
+
+} // namespace Mock
+} // namespace netcoredbg
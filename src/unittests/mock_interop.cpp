@@ -0,0 +1,393 @@
+// Copyright (c) 2022 Samsung Electronics Co., LTD
+// Distributed under the MIT License.
+// See the LICENSE file in the project root for more information.
+
+// Fake implementation of managed part interop, that use synthetic assemblies (see mock_symbols.h) instead of
+// real PDB files and don't need CoreCLR initialization. Only functions used by metadata code are implemented.
+
+#include "mock_symbols.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <cctype>
+#include <algorithm>
+#include <mutex>
+#include <limits>
+#include "managed/interop.h"
+#include "metadata/modules_sources.h"
+#include "utils/utf.h"
+
+namespace netcoredbg
+{
+namespace Mock
+{
+
+namespace
+{
+    std::mutex g_symbolsMutex;
+    std::unordered_map<std::string, const AssemblyInfo*> g_symbols;
+
+    const AssemblyInfo *GetAssembly(PVOID pSymbolReaderHandle)
+    {
+        return static_cast<const AssemblyInfo*>(pSymbolReaderHandle);
+    }
+
+    MethodInfo MakeMethod(mdTypeDef typeDef, mdMethodDef methodDef, const std::string &name, unsigned document,
+                          int32_t startLine, int32_t endLine, int32_t startColumn, int32_t endColumn, mdMethodDef nestedIn)
+    {
+        MethodInfo method;
+        method.typeDef = typeDef;
+        method.methodDef = methodDef;
+        method.name = name;
+        method.document = document;
+        method.startLine = startLine;
+        method.endLine = endLine;
+        method.startColumn = startColumn;
+        method.endColumn = endColumn;
+        method.nestedIn = nestedIn;
+        return method;
+    }
+} // unnamed namespace
+
+const MethodInfo *AssemblyInfo::FindMethod(mdMethodDef methodDef) const
+{
+    auto find = methodsIndex.find(methodDef);
+    return find == methodsIndex.end() ? nullptr : &methods[find->second];
+}
+
+AssemblyInfo GenerateAssembly(const std::string &name, CORDB_ADDRESS baseAddress, unsigned filesCount, unsigned methodsPerFile)
+{
+    AssemblyInfo assembly;
+    assembly.path = "/mock/bin/" + name + ".dll";
+    assembly.baseAddress = baseAddress;
+    assembly.size = 0x10000;
+    assembly.documents.reserve(filesCount);
+    assembly.types.reserve(filesCount + 1);
+
+    mdTypeDef typeDef = mdtTypeDef | 2; // 0x02000001 is <Module>
+    mdMethodDef methodDef = mdtMethodDef | 1;
+    for (unsigned file = 0; file < filesCount; file++, typeDef++)
+    {
+        unsigned document = (unsigned)assembly.documents.size();
+        assembly.documents.emplace_back("/mock/src/" + name + "/Dir" + std::to_string(file % 10) + "/File" + std::to_string(file) + ".cs");
+
+        assembly.types.emplace_back();
+        TypeInfo &type = assembly.types.back();
+        type.typeDef = typeDef;
+        type.name = name + ".Type" + std::to_string(file);
+
+        // Field initializers are compiled into all constructors, so, constructors have same code lines.
+        for (int i = 0; i < 2; i++)
+        {
+            assembly.methods.emplace_back(MakeMethod(typeDef, methodDef++, ".ctor", document, ConstructorStartLine(), ConstructorStartLine() + 2, 5, 30, 0));
+        }
+
+        for (unsigned method = 0; method < methodsPerFile; method++)
+        {
+            mdMethodDef parent = methodDef;
+            assembly.methods.emplace_back(MakeMethod(typeDef, methodDef++, "Method" + std::to_string(method), document,
+                                                     MethodStartLine(method), MethodEndLine(method), 9, 10, 0));
+            if (!HaveNestedMethod(method))
+                continue;
+
+            assembly.methods.emplace_back(MakeMethod(typeDef, methodDef++, "<Method" + std::to_string(method) + ">b__0", document,
+                                                     NestedMethodStartLine(method), NestedMethodStartLine(method) + 2, 20, 40, parent));
+        }
+    }
+
+    if (filesCount > 0)
+    {
+        assembly.types.emplace_back();
+        TypeInfo &type = assembly.types.back();
+        type.typeDef = typeDef;
+        type.name = "Nested";
+        type.enclosingClass = assembly.types.front().typeDef;
+    }
+
+    for (size_t i = 0; i < assembly.methods.size(); i++)
+    {
+        assembly.methodsIndex.emplace(assembly.methods[i].methodDef, i);
+        assembly.types[RidFromToken(assembly.methods[i].typeDef) - 2].methods.emplace_back(assembly.methods[i].methodDef);
+    }
+
+    return assembly;
+}
+
+void RegisterSymbols(const AssemblyInfo *assembly)
+{
+    std::lock_guard<std::mutex> lock(g_symbolsMutex);
+    g_symbols[assembly->path] = assembly;
+}
+
+void UnregisterSymbols(const AssemblyInfo *assembly)
+{
+    std::lock_guard<std::mutex> lock(g_symbolsMutex);
+    g_symbols.erase(assembly->path);
+}
+
+// Synthetic sequence points: one per line of method code with IL offset `(line - startLine) * 2`,
+// lines of nested method (lambda) don't belong to parent method.
+static bool FindSequencePointLine(const AssemblyInfo &assembly, const MethodInfo &method, int32_t sourceLine, int32_t &spLine)
+{
+    const MethodInfo *nested = assembly.FindMethod(method.methodDef + 1);
+    if (nested && nested->nestedIn != method.methodDef)
+        nested = nullptr;
+
+    for (int32_t line = std::max(sourceLine, method.startLine); line <= method.endLine; line++)
+    {
+        if (nested && line >= nested->startLine && line <= nested->endLine)
+            continue;
+
+        spLine = line;
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace Mock
+
+namespace Interop
+{
+
+SequencePoint::~SequencePoint() noexcept
+{
+    Interop::SysFreeString(document);
+}
+
+static BSTR AllocDocument(const std::string &str)
+{
+    auto wstr = to_utf16(str);
+    BSTR bstr = Interop::SysAllocStringLen((int32_t)wstr.size());
+    if (bstr == nullptr)
+        return nullptr;
+
+    memmove(bstr, wstr.data(), wstr.size() * sizeof(decltype(wstr[0])));
+    return bstr;
+}
+
+HRESULT LoadSymbolsForPortablePDB(const std::string &modulePath, BOOL, BOOL, ULONG64, ULONG64, ULONG64, ULONG64, VOID **ppSymbolReaderHandle)
+{
+    std::lock_guard<std::mutex> lock(Mock::g_symbolsMutex);
+
+    auto find = Mock::g_symbols.find(modulePath);
+    if (find == Mock::g_symbols.end())
+        return E_FAIL;
+
+    *ppSymbolReaderHandle = (PVOID)find->second;
+    return S_OK;
+}
+
+void DisposeSymbols(PVOID)
+{
+    // Symbols data is owned by test.
+}
+
+HRESULT GetSequencePointByILOffset(PVOID pSymbolReaderHandle, mdMethodDef MethodToken, ULONG32 IlOffset, SequencePoint *sequencePoint)
+{
+    const Mock::AssemblyInfo *assembly = Mock::GetAssembly(pSymbolReaderHandle);
+    const Mock::MethodInfo *method;
+    int32_t line;
+    if (assembly == nullptr || (method = assembly->FindMethod(MethodToken)) == nullptr ||
+        !Mock::FindSequencePointLine(*assembly, *method, method->startLine + (int32_t)IlOffset / 2, line))
+    {
+        return E_FAIL;
+    }
+
+    sequencePoint->startLine = line;
+    sequencePoint->endLine = line;
+    sequencePoint->startColumn = method->startColumn;
+    sequencePoint->endColumn = method->endColumn;
+    sequencePoint->offset = (line - method->startLine) * 2;
+    Interop::SysFreeString(sequencePoint->document);
+    sequencePoint->document = AllocDocument(assembly->documents[method->document]);
+    return S_OK;
+}
+
+HRESULT GetSequencePoints(PVOID pSymbolReaderHandle, mdMethodDef MethodToken, std::vector<MethodSequencePoint> &sequencePoints)
+{
+    const Mock::AssemblyInfo *assembly = Mock::GetAssembly(pSymbolReaderHandle);
+    const Mock::MethodInfo *method;
+    if (assembly == nullptr || (method = assembly->FindMethod(MethodToken)) == nullptr)
+        return E_FAIL;
+
+    std::vector<int32_t> lines;
+    int32_t line = method->startLine;
+    while (Mock::FindSequencePointLine(*assembly, *method, line, line))
+    {
+        lines.emplace_back(line++);
+    }
+
+    sequencePoints.clear();
+    for (int32_t spLine : lines)
+    {
+        // Same as managed part, document index is row number (1-based).
+        sequencePoints.push_back(MethodSequencePoint{spLine, method->startColumn, spLine, method->endColumn,
+                                                     (spLine - method->startLine) * 2, (int32_t)method->document + 1});
+    }
+    return S_OK;
+}
+
+HRESULT GetDocumentName(PVOID pSymbolReaderHandle, int32_t documentIndex, std::string &documentName)
+{
+    const Mock::AssemblyInfo *assembly = Mock::GetAssembly(pSymbolReaderHandle);
+    if (assembly == nullptr || documentIndex < 1 || (size_t)documentIndex > assembly->documents.size())
+        return E_FAIL;
+
+    documentName = assembly->documents[documentIndex - 1];
+    return S_OK;
+}
+
+HRESULT GetDocumentNames(PVOID pSymbolReaderHandle, std::vector<std::string> &documentNames)
+{
+    const Mock::AssemblyInfo *assembly = Mock::GetAssembly(pSymbolReaderHandle);
+    if (assembly == nullptr)
+        return E_FAIL;
+
+    documentNames = assembly->documents;
+    return S_OK;
+}
+
+HRESULT GetNextUserCodeILOffset(PVOID, mdMethodDef, ULONG32, ULONG32 &, bool *)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT GetNamedLocalVariableAndScope(PVOID, mdMethodDef, ULONG, WCHAR *, ULONG, ULONG32 *, ULONG32 *)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT GetHoistedLocalScopes(PVOID, mdMethodDef, std::vector<HoistedLocalScope> &)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT GetStepRangesFromIP(PVOID, ULONG32, mdMethodDef, ULONG32 *, ULONG32 *)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT GetModuleMethodsRanges(PVOID pSymbolReaderHandle, uint32_t constrTokensNum, PVOID constrTokens, uint32_t normalTokensNum, PVOID normalTokens,
+                               std::vector<FileMethodsData> &filesData, std::vector<method_data_t> &methodsData)
+{
+    const Mock::AssemblyInfo *assembly = Mock::GetAssembly(pSymbolReaderHandle);
+    if (assembly == nullptr)
+        return E_FAIL;
+
+    std::vector<std::vector<method_data_t>> documentsMethods(assembly->documents.size());
+    auto addMethods = [&](uint32_t tokensNum, PVOID tokens)
+    {
+        for (uint32_t i = 0; i < tokensNum; i++)
+        {
+            const Mock::MethodInfo *method = assembly->FindMethod(((mdMethodDef*)tokens)[i]);
+            if (method == nullptr)
+                continue;
+
+            documentsMethods[method->document].emplace_back(method->methodDef, method->startLine, method->endLine,
+                                                            method->startColumn, method->endColumn);
+        }
+    };
+    addMethods(constrTokensNum, constrTokens);
+    addMethods(normalTokensNum, normalTokens);
+
+    filesData.clear();
+    methodsData.clear();
+    for (size_t i = 0; i < documentsMethods.size(); i++)
+    {
+        if (documentsMethods[i].empty())
+            continue;
+
+        filesData.push_back(FileMethodsData{(int32_t)i + 1, (int32_t)documentsMethods[i].size()});
+        methodsData.insert(methodsData.end(), documentsMethods[i].begin(), documentsMethods[i].end());
+    }
+    return S_OK;
+}
+
+HRESULT ResolveBreakPoints(PVOID pSymbolReaderHandles[], int32_t tokenNum, PVOID Tokens, int32_t sourceLine, int32_t nestedToken,
+                           const std::string &, std::vector<ResolvedBreakpoint> &resolved)
+{
+    resolved.clear();
+    int32_t resolvedLine = std::numeric_limits<int32_t>::max();
+    for (int32_t i = 0; i < tokenNum; i++)
+    {
+        const Mock::AssemblyInfo *assembly = Mock::GetAssembly(pSymbolReaderHandles[i]);
+        const Mock::MethodInfo *method;
+        int32_t line;
+        if (assembly == nullptr || (method = assembly->FindMethod(((mdMethodDef*)Tokens)[i])) == nullptr ||
+            !Mock::FindSequencePointLine(*assembly, *method, sourceLine, line) || line > resolvedLine)
+        {
+            continue;
+        }
+
+        // Code after closest nested method start belong to parent method, but breakpoint should be resolved into nested one.
+        const Mock::MethodInfo *nested = nestedToken != 0 ? assembly->FindMethod(nestedToken) : nullptr;
+        if (nested && nested->startLine <= line)
+            continue;
+
+        if (line < resolvedLine)
+        {
+            resolved.clear();
+            resolvedLine = line;
+        }
+        resolved.push_back(ResolvedBreakpoint{line, line, (uint32_t)(line - method->startLine) * 2, (uint32_t)method->methodDef});
+    }
+
+    return S_OK;
+}
+
+HRESULT GetSource(PVOID, const std::string, PVOID *, int32_t *)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT LoadDeltaPdb(const std::string &, VOID **, std::unordered_set<mdMethodDef> &)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT SetSymbolSearchPaths(const std::vector<std::string> &, const std::string &)
+{
+    return S_OK;
+}
+
+HRESULT StringToUpper(std::string &String)
+{
+    for (auto &ch : String)
+    {
+        ch = (char)std::toupper((unsigned char)ch);
+    }
+    return S_OK;
+}
+
+BSTR SysAllocStringLen(int32_t size)
+{
+    // Same layout as OLE BSTR have: length prefix (in bytes), string data and terminating null.
+    char *mem = (char*)malloc(sizeof(UINT) + (size + 1) * sizeof(WCHAR));
+    if (mem == nullptr)
+        return nullptr;
+
+    *(UINT*)mem = size * sizeof(WCHAR);
+    BSTR bstr = (BSTR)(mem + sizeof(UINT));
+    bstr[size] = 0;
+    return bstr;
+}
+
+void SysFreeString(BSTR ptrBSTR)
+{
+    if (ptrBSTR != nullptr)
+        free((char*)ptrBSTR - sizeof(UINT));
+}
+
+PVOID CoTaskMemAlloc(int32_t size)
+{
+    return malloc(size);
+}
+
+void CoTaskMemFree(PVOID ptr)
+{
+    free(ptr);
+}
+
+} // namespace Interop
+} // namespace netcoredbg
@@ -0,0 +1,74 @@
+// Copyright (c) 2022 Samsung Electronics Co., LTD
+// Distributed under the MIT License.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "cor.h"
+#include "cordebug.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace netcoredbg
+{
+namespace Mock
+{
+
+// Synthetic assembly description, that used as source of "metadata" for MockMetaDataImport and as "PDB" for
+// fake Interop implementation (see mock_interop.cpp). All line numbers and IL offsets are generated by simple
+// rule, so, any test or benchmark result could be reproduced without real .NET assemblies and runtime.
+struct MethodInfo
+{
+    mdTypeDef typeDef;
+    mdMethodDef methodDef;
+    std::string name;
+    unsigned document;   // index in AssemblyInfo::documents
+    int32_t startLine;
+    int32_t endLine;
+    int32_t startColumn;
+    int32_t endColumn;
+    mdMethodDef nestedIn; // parent method token for lambdas, or 0
+};
+
+struct TypeInfo
+{
+    mdTypeDef typeDef;
+    std::string name;
+    std::vector<mdMethodDef> methods;
+    mdTypeDef enclosingClass = mdTypeDefNil;
+};
+
+struct AssemblyInfo
+{
+    std::string path;
+    CORDB_ADDRESS baseAddress;
+    ULONG32 size;
+    std::vector<std::string> documents;
+    std::vector<TypeInfo> types;
+    std::vector<MethodInfo> methods;
+    std::unordered_map<mdMethodDef, size_t> methodsIndex; // token -> index in methods
+
+    const MethodInfo *FindMethod(mdMethodDef methodDef) const;
+};
+
+// Each generated source file have one type with two constructors (share same code lines, as field initializers do),
+// and `methodsPerFile` methods 10 lines each, every 4th method have nested lambda. First file's type also have nested
+// type `Nested` without methods.
+// Method N of file F (counted from 0) start at line `MethodStartLine(N)`.
+AssemblyInfo GenerateAssembly(const std::string &name, CORDB_ADDRESS baseAddress, unsigned filesCount, unsigned methodsPerFile);
+
+inline int32_t ConstructorStartLine() { return 3; }
+inline int32_t MethodStartLine(unsigned methodNum) { return 10 + (int32_t)methodNum * 12; }
+inline int32_t MethodEndLine(unsigned methodNum) { return MethodStartLine(methodNum) + 9; }
+inline bool HaveNestedMethod(unsigned methodNum) { return methodNum % 4 == 0; }
+inline int32_t NestedMethodStartLine(unsigned methodNum) { return MethodStartLine(methodNum) + 3; }
+
+// Make assembly "PDB" available for Interop::LoadSymbolsForPortablePDB() calls (search by assembly path).
+// Note, assembly data must be alive until UnregisterSymbols() call.
+void RegisterSymbols(const AssemblyInfo *assembly);
+void UnregisterSymbols(const AssemblyInfo *assembly);
+
+} // namespace Mock
+} // namespace netcoredbg
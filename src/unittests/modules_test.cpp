@@ -0,0 +1,477 @@
+// Copyright (c) 2022 Samsung Electronics Co., LTD
+// Distributed under the MIT License.
+// See the LICENSE file in the project root for more information.
+
+// Modules and ModulesSources tests on synthetic assemblies (see mock_symbols.h), no .NET runtime needed.
+// Benchmarks are hidden from default run, use `modules "[benchmark]"` in order to run them.
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metadata/modules.h"
+#include "mock_cordebug.h"
+#include "mock_symbols.h"
+
+using namespace netcoredbg;
+
+namespace
+{
+
+// Load synthetic assemblies into Modules same way as ManagedCallback::LoadModule() does.
+class MockModules
+{
+public:
+    MockModules(unsigned assembliesCount, unsigned filesCount, unsigned methodsPerFile)
+    {
+        m_assemblies.reserve(assembliesCount);
+        for (unsigned i = 0; i < assembliesCount; i++)
+        {
+            m_assemblies.emplace_back(Mock::GenerateAssembly("Assembly" + std::to_string(i), 0x10000000 + i * 0x100000, filesCount, methodsPerFile));
+        }
+        for (const auto &assembly : m_assemblies)
+        {
+            Mock::RegisterSymbols(&assembly);
+        }
+    }
+
+    ~MockModules()
+    {
+        for (const auto &assembly : m_assemblies)
+        {
+            Mock::UnregisterSymbols(&assembly);
+        }
+    }
+
+    HRESULT LoadAll(Modules &modules)
+    {
+        HRESULT Status;
+        for (const auto &assembly : m_assemblies)
+        {
+            ToRelease<ICorDebugModule> iCorModule(new Mock::MockModule(assembly));
+            Module module;
+            std::string outputText;
+            IfFailRet(modules.TryLoadModuleSymbols(iCorModule, module, true, false, outputText));
+        }
+        return S_OK;
+    }
+
+    const Mock::AssemblyInfo &Assembly(size_t index) const { return m_assemblies[index]; }
+    Mock::AssemblyInfo &Assembly(size_t index) { return m_assemblies[index]; }
+
+private:
+    std::vector<Mock::AssemblyInfo> m_assemblies;
+};
+
+} // unnamed namespace
+
+TEST_CASE("Modules::TryLoadModuleSymbols")
+{
+    MockModules mockModules(2, 20, 10);
+    Modules modules;
+    REQUIRE(SUCCEEDED(mockModules.LoadAll(modules)));
+
+    const Mock::AssemblyInfo &assembly = mockModules.Assembly(1);
+    unsigned index;
+    REQUIRE(SUCCEEDED(modules.GetIndexBySourceFullPath(assembly.documents[5], index)));
+    std::string fullPath;
+    REQUIRE(SUCCEEDED(modules.GetSourceFullPathByIndex(index, fullPath)));
+    CHECK(fullPath == assembly.documents[5]);
+    CHECK(FAILED(modules.GetIndexBySourceFullPath("/mock/src/Unknown.cs", index)));
+
+    std::vector<std::string> files;
+    modules.FindFileNames("File1", 100, [&](const char *path) { files.emplace_back(path); });
+    // File1.cs, File10.cs ... File19.cs file names, plus full paths for each one in both assemblies.
+    CHECK(files.size() == 11 * 3);
+}
+
+TEST_CASE("Modules::ResolveBreakpoint")
+{
+    MockModules mockModules(1, 4, 8);
+    Modules modules;
+    REQUIRE(SUCCEEDED(mockModules.LoadAll(modules)));
+    const Mock::AssemblyInfo &assembly = mockModules.Assembly(0);
+
+    unsigned index;
+    std::vector<ModulesSources::resolved_bp_t> points;
+
+    SECTION("method line")
+    {
+        REQUIRE(SUCCEEDED(modules.ResolveBreakpoint(0, assembly.documents[2], index, Mock::MethodStartLine(1) + 2, points)));
+        REQUIRE(points.size() == 1);
+        CHECK(points[0].startLine == Mock::MethodStartLine(1) + 2);
+        CHECK(points[0].ilOffset == 4);
+    }
+
+    SECTION("line out of methods moved to next method")
+    {
+        REQUIRE(SUCCEEDED(modules.ResolveBreakpoint(0, "File3.cs", index, Mock::MethodEndLine(2) + 1, points)));
+        REQUIRE(points.size() == 1);
+        CHECK(points[0].startLine == Mock::MethodStartLine(3));
+        CHECK(points[0].ilOffset == 0);
+    }
+
+    SECTION("nested method")
+    {
+        REQUIRE(SUCCEEDED(modules.ResolveBreakpoint(0, "Dir1/File1.cs", index, Mock::NestedMethodStartLine(4) + 1, points)));
+        REQUIRE(points.size() == 1);
+        CHECK(points[0].startLine == Mock::NestedMethodStartLine(4) + 1);
+        const Mock::MethodInfo *method = assembly.FindMethod(points[0].methodToken);
+        REQUIRE(method != nullptr);
+        CHECK(method->nestedIn != 0);
+    }
+
+    SECTION("constructors with same code")
+    {
+        REQUIRE(SUCCEEDED(modules.ResolveBreakpoint(0, "File0.cs", index, Mock::ConstructorStartLine() + 1, points)));
+        CHECK(points.size() == 2);
+    }
+
+    SECTION("unknown file")
+    {
+        CHECK(FAILED(modules.ResolveBreakpoint(0, "File4.cs", index, 1, points)));
+    }
+}
+
+TEST_CASE("Modules::ResolveBreakpoint paths cache")
+{
+    MockModules mockModules(1, 4, 8);
+    Modules modules;
+    unsigned index;
+    std::vector<ModulesSources::resolved_bp_t> points;
+
+    // Failed resolution is cached, but cache must be reset when new sources indexed.
+    CHECK(FAILED(modules.ResolveBreakpoint(0, "File3.cs", index, Mock::MethodStartLine(1), points)));
+    REQUIRE(SUCCEEDED(mockModules.LoadAll(modules)));
+
+    unsigned fullPathIndex;
+    REQUIRE(SUCCEEDED(modules.GetIndexBySourceFullPath(mockModules.Assembly(0).documents[3], fullPathIndex)));
+    for (unsigned i = 0; i < 2; i++)
+    {
+        points.clear();
+        REQUIRE(SUCCEEDED(modules.ResolveBreakpoint(0, "File3.cs", index, Mock::MethodStartLine(1), points)));
+        CHECK(index == fullPathIndex);
+        CHECK(points.size() == 1);
+    }
+}
+
+TEST_CASE("Modules::ResolveBreakpoint long lines")
+{
+    MockModules mockModules(1, 1, 8);
+    // Columns that don't fit packed methods index data (minified or generated code).
+    for (auto &method : mockModules.Assembly(0).methods)
+    {
+        method.startColumn += 70000;
+        method.endColumn += 70000;
+    }
+    Modules modules;
+    REQUIRE(SUCCEEDED(mockModules.LoadAll(modules)));
+
+    unsigned index;
+    std::vector<ModulesSources::resolved_bp_t> points;
+    REQUIRE(SUCCEEDED(modules.ResolveBreakpoint(0, "File0.cs", index, Mock::ConstructorStartLine() + 1, points)));
+    CHECK(points.size() == 2);
+
+    points.clear();
+    REQUIRE(SUCCEEDED(modules.ResolveBreakpoint(0, "File0.cs", index, Mock::NestedMethodStartLine(4) + 1, points)));
+    REQUIRE(points.size() == 1);
+    const Mock::MethodInfo *method = mockModules.Assembly(0).FindMethod(points[0].methodToken);
+    REQUIRE(method != nullptr);
+    CHECK(method->nestedIn != 0);
+}
+
+TEST_CASE("Modules::DeferredSourcesIndexing")
+{
+    // NuGet package module sources indexing is postponed till first request.
+    Mock::AssemblyInfo assembly = Mock::GenerateAssembly("Package", 0x10000000, 4, 8);
+    assembly.path = "/home/user/.nuget/packages/package/1.0.0/lib/net6.0/Package.dll";
+    Mock::RegisterSymbols(&assembly);
+    {
+        Modules modules;
+        ToRelease<ICorDebugModule> iCorModule(new Mock::MockModule(assembly));
+        Module module;
+        std::string outputText;
+        // Note, with enabled JMC symbols load for NuGet package module will be skipped.
+        REQUIRE(SUCCEEDED(modules.TryLoadModuleSymbols(iCorModule, module, false, false, outputText)));
+        CHECK(module.symbolStatus == SymbolsLoaded);
+
+        unsigned index;
+        REQUIRE(SUCCEEDED(modules.GetIndexBySourceFullPath(assembly.documents[1], index)));
+        std::vector<ModulesSources::resolved_bp_t> points;
+        REQUIRE(SUCCEEDED(modules.ResolveBreakpoint(0, "File2.cs", index, Mock::MethodStartLine(1) + 2, points)));
+        CHECK(points.size() == 1);
+    }
+    Mock::UnregisterSymbols(&assembly);
+}
+
+TEST_CASE("Modules::SkippedSymbols")
+{
+    Mock::AssemblyInfo assembly = Mock::GenerateAssembly("Package", 0x10000000, 4, 8);
+    assembly.path = "/home/user/.nuget/packages/package/1.0.0/lib/net6.0/Package.dll";
+    Mock::RegisterSymbols(&assembly);
+    {
+        Modules modules;
+        ToRelease<ICorDebugModule> iCorModule(new Mock::MockModule(assembly));
+        Module module;
+        std::string outputText;
+        unsigned index;
+        std::vector<ModulesSources::resolved_bp_t> points;
+
+        SECTION("non-user code with enabled JMC")
+        {
+            REQUIRE(SUCCEEDED(modules.TryLoadModuleSymbols(iCorModule, module, true, false, outputText)));
+            CHECK(module.symbolStatus == SymbolsSkipped);
+            CHECK(FAILED(modules.ResolveBreakpoint(0, "File2.cs", index, Mock::MethodStartLine(1) + 2, points)));
+
+            // Load symbols on JMC disable.
+            std::vector<Module> loaded;
+            REQUIRE(SUCCEEDED(modules.LoadSkippedModulesSymbols([&](ICorDebugModule *, const Module &module, const std::string &)
+            {
+                loaded.push_back(module);
+            })));
+            REQUIRE(loaded.size() == 1);
+            CHECK(loaded[0].symbolStatus == SymbolsLoaded);
+            CHECK(loaded[0].baseAddress == assembly.baseAddress);
+            REQUIRE(SUCCEEDED(modules.ResolveBreakpoint(0, "File2.cs", index, Mock::MethodStartLine(1) + 2, points)));
+            CHECK(points.size() == 1);
+        }
+
+        SECTION("excluded module")
+        {
+            SymbolOptions options;
+            options.excludedModules.emplace_back("Pack*.dll");
+            modules.SetSymbolOptions(options);
+            REQUIRE(SUCCEEDED(modules.TryLoadModuleSymbols(iCorModule, module, false, false, outputText)));
+            CHECK(module.symbolStatus == SymbolsSkipped);
+
+            unsigned count = 0;
+            REQUIRE(SUCCEEDED(modules.LoadSkippedModulesSymbols([&](ICorDebugModule *, const Module &, const std::string &) { count++; })));
+            CHECK(count == 0);
+        }
+    }
+    Mock::UnregisterSymbols(&assembly);
+}
+
+TEST_CASE("Modules::Snapshots")
+{
+    MockModules mockModules(8, 20, 10);
+    Modules modules;
+    const Mock::AssemblyInfo &assembly = mockModules.Assembly(0);
+    ToRelease<ICorDebugModule> iCorModule(new Mock::MockModule(assembly));
+    Module module;
+    std::string outputText;
+    REQUIRE(SUCCEEDED(modules.TryLoadModuleSymbols(iCorModule, module, true, false, outputText)));
+
+    // Readers work with published snapshot, while other modules are loaded.
+    std::thread loader([&]()
+    {
+        for (unsigned i = 1; i < 8; i++)
+        {
+            ToRelease<ICorDebugModule> iCorModule(new Mock::MockModule(mockModules.Assembly(i)));
+            Module module;
+            std::string outputText;
+            modules.TryLoadModuleSymbols(iCorModule, module, true, false, outputText);
+        }
+    });
+
+    unsigned failed = 0;
+    for (unsigned i = 0; i < 200; i++)
+    {
+        unsigned index;
+        std::vector<ModulesSources::resolved_bp_t> points;
+        if (FAILED(modules.ResolveBreakpoint(0, assembly.documents[i % 20], index, Mock::MethodStartLine(1) + 2, points)) || points.empty())
+            failed++;
+    }
+    loader.join();
+    CHECK(failed == 0);
+
+    unsigned count = 0;
+    modules.ForEachModule([&](ICorDebugModule *) { count++; return S_OK; });
+    CHECK(count == 8);
+}
+
+TEST_CASE("Modules::FindTypeByName")
+{
+    MockModules mockModules(3, 4, 2);
+    Modules modules;
+    std::vector<ToRelease<ICorDebugModule>> iCorModules;
+    auto loadModule = [&](unsigned index)
+    {
+        iCorModules.emplace_back(new Mock::MockModule(mockModules.Assembly(index)));
+        Module module;
+        std::string outputText;
+        return modules.TryLoadModuleSymbols(iCorModules.back(), module, true, false, outputText);
+    };
+    REQUIRE(SUCCEEDED(loadModule(0)));
+    REQUIRE(SUCCEEDED(loadModule(1)));
+
+    ToRelease<ICorDebugModule> iCorModule;
+    mdTypeDef typeDef = mdTypeDefNil;
+    REQUIRE(SUCCEEDED(modules.FindTypeByName("Assembly1.Type2", nullptr, mdTypeDefNil, &iCorModule, typeDef)));
+    CHECK(iCorModule.GetPtr() == iCorModules[1].GetPtr());
+    CHECK(typeDef == mockModules.Assembly(1).types[2].typeDef);
+
+    SECTION("nested type")
+    {
+        const mdTypeDef enclosingClass = mockModules.Assembly(0).types[0].typeDef;
+        CHECK(FAILED(modules.FindTypeByName("Assembly0.Type0.Nested", nullptr, mdTypeDefNil, nullptr, typeDef)));
+        REQUIRE(SUCCEEDED(modules.FindTypeByName("Assembly0.Type0.Nested", iCorModules[0], enclosingClass, nullptr, typeDef)));
+        CHECK(typeDef == mockModules.Assembly(0).types.back().typeDef);
+    }
+
+    SECTION("search in module")
+    {
+        CHECK(FAILED(modules.FindTypeByName("Assembly1.Type2", iCorModules[0], mdTypeDefNil, nullptr, typeDef)));
+        CHECK(FAILED(modules.FindTypeByName("Assembly1", nullptr, mdTypeDefNil, nullptr, typeDef)));
+    }
+
+    SECTION("module load and unload")
+    {
+        CHECK(FAILED(modules.FindTypeByName("Assembly2.Type0", nullptr, mdTypeDefNil, nullptr, typeDef)));
+        REQUIRE(SUCCEEDED(loadModule(2)));
+        CHECK(SUCCEEDED(modules.FindTypeByName("Assembly2.Type0", nullptr, mdTypeDefNil, nullptr, typeDef)));
+        modules.RemoveModuleTypes(iCorModules[2]);
+        CHECK(FAILED(modules.FindTypeByName("Assembly2.Type0", nullptr, mdTypeDefNil, nullptr, typeDef)));
+    }
+}
+
+TEST_CASE("Modules::FindTypeByName same type in different modules")
+{
+    // Same assembly loaded twice from different locations (for example, into different load contexts).
+    std::vector<Mock::AssemblyInfo> assemblies;
+    assemblies.emplace_back(Mock::GenerateAssembly("Shared", 0x10000000, 4, 2));
+    assemblies.emplace_back(Mock::GenerateAssembly("Shared", 0x10100000, 4, 2));
+    assemblies.back().path = "/mock/plugins/Shared.dll";
+    for (const auto &assembly : assemblies)
+    {
+        Mock::RegisterSymbols(&assembly);
+    }
+    {
+        Modules modules;
+        std::vector<ToRelease<ICorDebugModule>> iCorModules;
+        auto loadModule = [&](unsigned index)
+        {
+            iCorModules.emplace_back(new Mock::MockModule(assemblies[index]));
+            Module module;
+            std::string outputText;
+            return modules.TryLoadModuleSymbols(iCorModules.back(), module, true, false, outputText);
+        };
+        ToRelease<ICorDebugModule> iCorModule;
+        mdTypeDef typeDef = mdTypeDefNil;
+
+        SECTION("index built after modules load")
+        {
+            REQUIRE(SUCCEEDED(loadModule(0)));
+            REQUIRE(SUCCEEDED(loadModule(1)));
+            REQUIRE(SUCCEEDED(modules.FindTypeByName("Shared.Type1", nullptr, mdTypeDefNil, &iCorModule, typeDef)));
+            CHECK(iCorModule.GetPtr() == iCorModules[0].GetPtr());
+        }
+
+        SECTION("module added into built index")
+        {
+            REQUIRE(SUCCEEDED(loadModule(0)));
+            CHECK(FAILED(modules.FindTypeByName("Shared.Type5", nullptr, mdTypeDefNil, nullptr, typeDef)));
+            REQUIRE(SUCCEEDED(loadModule(1)));
+            REQUIRE(SUCCEEDED(modules.FindTypeByName("Shared.Type1", nullptr, mdTypeDefNil, &iCorModule, typeDef)));
+            CHECK(iCorModule.GetPtr() == iCorModules[0].GetPtr());
+
+            // First loaded module unloaded, type should be found in second one.
+            modules.RemoveModuleTypes(iCorModules[0]);
+            iCorModule.Free();
+            REQUIRE(SUCCEEDED(modules.FindTypeByName("Shared.Type1", nullptr, mdTypeDefNil, &iCorModule, typeDef)));
+            CHECK(iCorModule.GetPtr() == iCorModules[1].GetPtr());
+        }
+    }
+    for (const auto &assembly : assemblies)
+    {
+        Mock::UnregisterSymbols(&assembly);
+    }
+}
+
+TEST_CASE("FuncNameMatcher")
+{
+    FuncNameMatcher matcher;
+
+    SECTION("name components")
+    {
+        REQUIRE(SUCCEEDED(matcher.Init("ClassA.MethodB")));
+        CHECK(matcher.Match("Program.ClassA.MethodB"));
+        CHECK(matcher.Match("Program.ClassB.ClassA.MethodB"));
+        CHECK_FALSE(matcher.Match("Program.ClassB.MethodB"));
+        CHECK_FALSE(matcher.Match("MethodB"));
+    }
+
+    SECTION("glob")
+    {
+        REQUIRE(SUCCEEDED(matcher.Init("MyApp.Services.*.Handle*")));
+        CHECK(matcher.Match("MyApp.Services.OrderService.HandleAsync"));
+        CHECK(matcher.Match("MyApp.Services.OrderService.Handle"));
+        CHECK_FALSE(matcher.Match("MyApp.Services.Orders.OrderService.Handle"));
+        CHECK_FALSE(matcher.Match("MyApp.Other.OrderService.Handle"));
+    }
+
+    SECTION("regex")
+    {
+        REQUIRE(SUCCEEDED(matcher.Init("/^MyApp\\..*Handler\\.Handle/")));
+        CHECK(matcher.Match("MyApp.Orders.OrderHandler.HandleAsync"));
+        CHECK_FALSE(matcher.Match("Other.MyApp.OrderHandler.Handle"));
+        CHECK(FAILED(matcher.Init("/(/")));
+    }
+}
+
+TEST_CASE("Modules benchmarks", "[.][benchmark]")
+{
+    const unsigned assembliesCount = 10;
+    const unsigned filesCount = 200;
+    const unsigned methodsPerFile = 50;
+    MockModules mockModules(assembliesCount, filesCount, methodsPerFile);
+
+    BENCHMARK("symbols indexing (10 assemblies, 2000 files)")
+    {
+        Modules modules;
+        return mockModules.LoadAll(modules);
+    };
+
+    MockModules largeModule(1, 10, 10000);
+
+    BENCHMARK("symbols indexing (1 assembly, 100000 methods)")
+    {
+        Modules modules;
+        return largeModule.LoadAll(modules);
+    };
+
+    Modules modules;
+    REQUIRE(SUCCEEDED(mockModules.LoadAll(modules)));
+
+    BENCHMARK("breakpoint resolution by full path")
+    {
+        unsigned index;
+        std::vector<ModulesSources::resolved_bp_t> points;
+        for (unsigned i = 0; i < 100; i++)
+        {
+            const Mock::AssemblyInfo &assembly = mockModules.Assembly(i % assembliesCount);
+            modules.ResolveBreakpoint(0, assembly.documents[(i * 7) % filesCount], index, Mock::MethodStartLine(i % methodsPerFile) + 5, points);
+        }
+        return points.size();
+    };
+
+    BENCHMARK("breakpoint resolution by file name")
+    {
+        unsigned index;
+        std::vector<ModulesSources::resolved_bp_t> points;
+        for (unsigned i = 0; i < 100; i++)
+        {
+            modules.ResolveBreakpoint(0, "File" + std::to_string((i * 7) % filesCount) + ".cs", index, Mock::MethodStartLine(i % methodsPerFile) + 5, points);
+        }
+        return points.size();
+    };
+
+    BENCHMARK("source file names search")
+    {
+        size_t count = 0;
+        modules.FindFileNames("Dir1/File1", 1000, [&](const char *) { count++; });
+        return count;
+    };
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2022 Samsung Electronics Co., LTD
+// Distributed under the MIT License.
+// See the LICENSE file in the project root for more information.
+
+#include <catch2/catch.hpp>
+#include <string>
+#include <vector>
+#include "protocols/tokenizer.h"
+
+using namespace netcoredbg;
+
+static std::vector<std::string> Tokenize(const std::string &str)
+{
+    std::vector<std::string> result;
+    Tokenizer tokenizer(str);
+    string_view token;
+    while (tokenizer.Next(token))
+        result.emplace_back(token.data(), token.size());
+    return result;
+}
+
+TEST_CASE("Tokenizer")
+{
+    using V = std::vector<std::string>;
+
+    CHECK(Tokenize("") == V{});
+    CHECK(Tokenize("  \t ") == V{});
+    CHECK(Tokenize("1-break-insert  --thread 1 Program.cs:10 \r\n") == V{"1-break-insert", "--thread", "1", "Program.cs:10"});
+    CHECK(Tokenize("-var-create - * \"a + b\"") == V{"-var-create", "-", "*", "a + b"});
+    CHECK(Tokenize("p \"say \\\"hi\\\"\" x") == V{"p", "say \"hi\"", "x"});
+    CHECK(Tokenize("a\"b c") == V{"a\"b", "c"});
+    CHECK(Tokenize("\"unterminated quote") == V{"unterminated quote"});
+    CHECK(Tokenize("\"escape at end\\") == V{});
+}
+
+TEST_CASE("Tokenizer tokens are views into input")
+{
+    std::string str = "-exec-run \"no escapes\" \"with \\\\ escape\"";
+    Tokenizer tokenizer(str);
+    string_view token;
+
+    REQUIRE(tokenizer.Next(token));
+    CHECK(token.data() == str.data());
+    REQUIRE(tokenizer.Next(token));
+    CHECK(token == "no escapes");
+    CHECK(token.data() == str.data() + str.find("no escapes"));
+    REQUIRE(tokenizer.Next(token));
+    CHECK(token == "with \\ escape");
+    CHECK(!tokenizer.Next(token));
+}
+
+TEST_CASE("Tokenizer::Remain")
+{
+    std::string str = "-break-condition 1 i == 5 && s != \"a\"  ";
+    Tokenizer tokenizer(str);
+    string_view token;
+
+    REQUIRE(tokenizer.Next(token));
+    REQUIRE(tokenizer.Next(token));
+    CHECK(token == "1");
+    CHECK(tokenizer.Remain() == "i == 5 && s != \"a\"");
+}
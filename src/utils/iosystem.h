@@ -9,6 +9,7 @@
 #include <utility>
 #include <type_traits>
 #include <chrono>
+#include <string>
 
 #include "utils/platform.h"
 
@@ -147,6 +148,11 @@ template <typename Traits> struct IOSystemImpl
     /// In case of error, empty file handle will be returned.
     static FileHandle listen_socket(unsigned tcp_port) { return Traits::listen_socket(tcp_port); }
 
+    /// Function connects to local (unix domain) socket with given path and return file
+    /// handle related to the connection. In case of error, empty file handle will be returned.
+    /// Function never blocks longer than short timeout (in case listener don't accept connections).
+    static FileHandle connect_socket(const std::string &path) { return Traits::connect_socket(path); }
+
     /// Function perform reading from the file: it may read up to `count' bytes to `buf'.
     static IOResult read(FileHandle fh, void *buf, size_t count) { return Traits::read(fh.handle, buf, count); }
 
@@ -16,6 +16,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
 #include <netinet/in.h>
 #include <stdexcept>
 #include <algorithm>
@@ -230,6 +232,59 @@ Class::FileHandle Class::listen_socket(unsigned port)
     return newsockfd;
 }
 
+// Function connects to local (unix domain) socket with given path and return file
+// descriptor related to the connection. In case of error, empty file handle will be returned.
+// Note, connection is non-blocking and can't wait more than ConnectTimeout (caller could hold locks
+// and listener could be stopped or have full backlog), returned descriptor is non-blocking too.
+Class::FileHandle Class::connect_socket(const std::string &path)
+{
+    static const int ConnectTimeout = 100; // milliseconds
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    if (path.size() >= sizeof(addr.sun_path))
+        return {};
+
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+
+    int sockFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sockFd < 0)
+        return {};
+
+    int flags = fcntl(sockFd, F_GETFL);
+    if (flags < 0 || fcntl(sockFd, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        ::close(sockFd);
+        return {};
+    }
+
+    if (::connect(sockFd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+        return sockFd;
+
+    // Linux fails with EAGAIN in case of full backlog, but other systems could queue connection.
+    if (errno != EINPROGRESS)
+    {
+        ::close(sockFd);
+        return {};
+    }
+
+    struct pollfd pfd;
+    pfd.fd = sockFd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+    int error = 0;
+    socklen_t len = sizeof(error);
+    if (::poll(&pfd, 1, ConnectTimeout) <= 0 ||
+        getsockopt(sockFd, SOL_SOCKET, SO_ERROR, &error, &len) < 0 || error != 0)
+    {
+        ::close(sockFd);
+        return {};
+    }
+
+    return sockFd;
+}
+
 // Enable/disable handle inheritance for child processes.
 Class::IOResult Class::set_inherit(const FileHandle &fh, bool inherit)
 {
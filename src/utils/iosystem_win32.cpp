@@ -280,6 +280,13 @@ Class::FileHandle Class::listen_socket(unsigned port)
     return FileHandle(newsockfd);
 }
 
+// Function connects to local (unix domain) socket with given path and return file
+// handle related to the connection. Not implemented for Windows, empty file handle returned.
+Class::FileHandle Class::connect_socket(const std::string &)
+{
+    return {};
+}
+
 // Function enables or disables inheritance of file handle for child processes.
 Class::IOResult Class::set_inherit(const FileHandle& fh, bool inherit)
 {
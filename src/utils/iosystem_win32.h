@@ -68,6 +68,7 @@ template <> struct IOSystemTraits<Win32PlatformTag>
 
     static std::pair<FileHandle, FileHandle> unnamed_pipe();
     static FileHandle listen_socket(unsigned tcp_port);
+    static FileHandle connect_socket(const std::string &path);
     static IOResult set_inherit(const FileHandle &, bool);
     static IOResult read(const FileHandle &, void *buf, size_t count);
     static IOResult write(const FileHandle &, const void *buf, size_t count);
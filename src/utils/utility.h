@@ -6,6 +6,8 @@
 
 #pragma once
 #include <stddef.h>
+#include <string>
+#include "utils/string_view.h"
 
 namespace netcoredbg
 {
@@ -63,6 +65,42 @@ static inline constexpr Owner *container_of(Member *ptr, const Member Owner::*me
 }
 
 
+/// Match string with pattern, where `*` is any sequence of characters and `?` is any character.
+inline bool MatchPattern(string_view str, string_view pattern)
+{
+    size_t s = 0;
+    size_t p = 0;
+    size_t starPattern = string_view::npos;
+    size_t starStr = 0;
+
+    while (s < str.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == str[s]))
+        {
+            s++;
+            p++;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            starPattern = p++;
+            starStr = s;
+        }
+        else if (starPattern != string_view::npos)
+        {
+            p = starPattern + 1;
+            s = ++starStr;
+        }
+        else
+            return false;
+    }
+
+    while (p < pattern.size() && pattern[p] == '*')
+        p++;
+
+    return p == pattern.size();
+}
+
+
 // This is helper class which simplifies implementation of singleton classes.
 //
 // Usage example:
@@ -10,7 +10,7 @@ Example of using script:
 
 def do(f):
     for line in open(f).readlines():
-        r = re.match(r'^-> \(C\) ({.+})', line)
+        r = re.match(r'^(?:\[[0-9.]+\] )?-> \(C\) ({.+})', line)
         if r != None:
             cmd = r.group(1)
             print ("Content-Length: {}\n".format(len(cmd)))
@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+import argparse, json, re, subprocess, sys, threading, time
+
+'''
+Replay VSCode protocol session recorded by `--engineLogging=<file>` against fresh netcoredbg
+and compare per-request latency with baseline (recorded session or previously saved replay).
+
+Example of using script:
+    $ netcoredbg --interpreter=vscode --engineLogging=session.log     <- record session from IDE
+    $ protocol-replay.py --netcoredbg ../../bin/netcoredbg --save baseline.json session.log
+    ... rebuild netcoredbg with changes ...
+    $ protocol-replay.py --netcoredbg ../../bin/netcoredbg --baseline baseline.json session.log
+'''
+
+LOG_LINE = re.compile(r'^\[([0-9.]+)\] (?:->|<-) \((C|R|E)\) ({.+})\s*$')
+
+# Debugger provided identifiers, that could be different from run to run.
+ID_KINDS = {'threadId': 'thread', 'frameId': 'frame', 'variablesReference': 'variables'}
+# Arrays, where `id` field of each element is debugger provided identifier.
+LIST_ID_KINDS = {'threads': 'thread', 'stackFrames': 'frame'}
+
+
+class Entry:
+    def __init__(self, time, kind, msg):
+        self.time = time
+        self.kind = kind
+        self.msg = msg
+
+
+def message_key(kind, msg):
+    if kind == 'R':
+        return ('R', msg.get('command'))
+    return ('E', msg.get('event'))
+
+
+def is_trigger(entry):
+    # Output events count depend on debuggee and debugger logging, can't be used for synchronization.
+    return entry.kind != 'C' and not (entry.kind == 'E' and entry.msg.get('event') == 'output')
+
+
+def parse_log(path):
+    entries = []
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            r = LOG_LINE.match(line)
+            if r is None:
+                continue
+            entries.append(Entry(float(r.group(1)), r.group(2), json.loads(r.group(3))))
+
+    if not entries:
+        sys.exit('{}: no timestamped protocol messages found (was session recorded with --engineLogging=<file>?)'.format(path))
+    return entries
+
+
+class Session:
+    '''Recorded session: requests with synchronization point (last response or event before request) and think time.'''
+
+    def __init__(self, entries):
+        self.requests = []
+        self.recorded = {}      # (key, index) -> recorded message
+        self.latency = {}       # request seq -> recorded latency
+        counts = {}
+        sent = {}
+        trigger = None
+        for entry in entries:
+            if entry.kind == 'C':
+                self.requests.append((entry.msg, trigger, entry.time - (trigger[1] if trigger else 0.0)))
+                sent[entry.msg['seq']] = entry.time
+                continue
+
+            key = message_key(entry.kind, entry.msg)
+            index = counts.get(key, 0)
+            counts[key] = index + 1
+            self.recorded[(key, index)] = entry.msg
+            if entry.kind == 'R' and entry.msg.get('request_seq') in sent:
+                self.latency[entry.msg['request_seq']] = entry.time - sent[entry.msg['request_seq']]
+            if is_trigger(entry):
+                trigger = ((key, index), entry.time)
+
+
+class Replay:
+    def __init__(self, netcoredbg, args, session):
+        self.session = session
+        self.cond = threading.Condition()
+        self.counts = {}
+        self.times = {}         # (key, index) -> arrival time
+        self.responses = {}     # request seq -> arrival time
+        self.ids = {kind: {} for kind in set(ID_KINDS.values())}
+        self.proc = subprocess.Popen([netcoredbg, '--interpreter=vscode'] + args, stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        self.start = time.monotonic()
+        self.reader = threading.Thread(target=self.read_messages, daemon=True)
+        self.reader.start()
+
+    def read_messages(self):
+        out = self.proc.stdout
+        while True:
+            length = None
+            while True:
+                header = out.readline()
+                if not header:
+                    with self.cond:
+                        self.cond.notify_all()
+                    return
+                header = header.strip()
+                if not header:
+                    break
+                if header.startswith(b'Content-Length:'):
+                    length = int(header[len(b'Content-Length:'):])
+            if length is None:
+                continue
+
+            now = time.monotonic()
+            msg = json.loads(out.read(length).decode('utf-8'))
+            kind = 'R' if msg.get('type') == 'response' else 'E'
+            key = message_key(kind, msg)
+            with self.cond:
+                index = self.counts.get(key, 0)
+                self.counts[key] = index + 1
+                self.times[(key, index)] = now
+                if kind == 'R':
+                    self.responses[msg.get('request_seq')] = now
+                recorded = self.session.recorded.get((key, index))
+                if recorded is not None:
+                    self.collect_ids(recorded, msg, None)
+                self.cond.notify_all()
+
+    def collect_ids(self, recorded, replayed, list_kind):
+        if isinstance(recorded, dict) and isinstance(replayed, dict):
+            for k, value in recorded.items():
+                if k not in replayed:
+                    continue
+                kind = ID_KINDS.get(k) or (list_kind if k == 'id' else None)
+                if kind and isinstance(value, int) and isinstance(replayed[k], int):
+                    self.ids[kind][value] = replayed[k]
+                else:
+                    self.collect_ids(value, replayed[k], LIST_ID_KINDS.get(k))
+        elif isinstance(recorded, list) and isinstance(replayed, list):
+            for a, b in zip(recorded, replayed):
+                self.collect_ids(a, b, list_kind)
+
+    def remap_ids(self, value):
+        if isinstance(value, dict):
+            result = {}
+            for k, v in value.items():
+                kind = ID_KINDS.get(k)
+                result[k] = self.ids[kind].get(v, v) if kind and isinstance(v, int) else self.remap_ids(v)
+            return result
+        if isinstance(value, list):
+            return [self.remap_ids(v) for v in value]
+        return value
+
+    def wait_for(self, point, timeout):
+        deadline = time.monotonic() + timeout
+        with self.cond:
+            while point not in self.times:
+                remaining = deadline - time.monotonic()
+                if remaining <= 0 or self.proc.poll() is not None:
+                    return None
+                self.cond.wait(remaining)
+            return self.times[point]
+
+    def send(self, msg):
+        with self.cond:
+            msg = self.remap_ids(msg)
+        data = json.dumps(msg, separators=(',', ':')).encode('utf-8')
+        sent = time.monotonic()
+        self.proc.stdin.write(b'Content-Length: ' + str(len(data)).encode() + b'\r\n\r\n' + data)
+        self.proc.stdin.flush()
+        return sent
+
+    def finish(self, timeout):
+        try:
+            self.proc.stdin.close()
+            self.proc.wait(timeout)
+        except (BrokenPipeError, subprocess.TimeoutExpired):
+            self.proc.kill()
+            self.proc.wait()
+
+
+def replay(options, session):
+    '''Replay session once, return request seq -> latency.'''
+    rp = Replay(options.netcoredbg, options.args, session)
+    sent = {}
+    for msg, trigger, think in session.requests:
+        ready = rp.start
+        if trigger is not None:
+            ready = rp.wait_for(trigger[0], options.timeout)
+            if ready is None:
+                print('warning: no {} #{} before request {} ({}), sent anyway'.format(
+                      trigger[0][0], trigger[0][1], msg['seq'], msg.get('command')), file=sys.stderr)
+                ready = time.monotonic()
+        delay = ready + think * options.speed - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+        sent[msg['seq']] = (rp.send(msg), msg.get('command'))
+
+    deadline = time.monotonic() + options.timeout
+    with rp.cond:
+        while any(seq not in rp.responses for seq in sent) and rp.proc.poll() is None and time.monotonic() < deadline:
+            rp.cond.wait(deadline - time.monotonic())
+    rp.finish(options.timeout)
+
+    return {seq: (rp.responses[seq] - start if seq in rp.responses else None, command) for seq, (start, command) in sent.items()}
+
+
+def median(values):
+    values = sorted(values)
+    return values[len(values) // 2] if values else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Replay netcoredbg VSCode protocol session and compare requests latency.')
+    parser.add_argument('log', help='session log recorded by netcoredbg --engineLogging=<file>')
+    parser.add_argument('--netcoredbg', required=True, help='path to netcoredbg')
+    parser.add_argument('--baseline', help='replay results saved by --save (recorded session latency shown for information only by default)')
+    parser.add_argument('--save', help='save replay results (could be used as --baseline later)')
+    parser.add_argument('--repeat', type=int, default=1, help='replay session N times and use median latency')
+    parser.add_argument('--speed', type=float, default=1.0, help='think time multiplier (0 - send requests as fast as possible)')
+    parser.add_argument('--timeout', type=float, default=30.0, help='seconds to wait for response or event before next request')
+    parser.add_argument('--threshold', type=float, default=20.0, help='regression threshold in percents')
+    parser.add_argument('--min-diff', type=float, default=5.0, help='ignore latency increase less than this value in milliseconds')
+    parser.add_argument('--fail-on-regression', action='store_true', help='exit with error code in case of regression (requires --baseline)')
+    parser.add_argument('args', nargs='*', help='additional netcoredbg arguments (after --)')
+    options = parser.parse_args()
+
+    # Recorded latency is measured by debugger itself and have no client side overhead, so, it can't be compared
+    # with replay latency, regressions could be detected only against replay results saved by --save.
+    if options.fail_on_regression and not options.baseline:
+        parser.error('--fail-on-regression requires --baseline')
+
+    session = Session(parse_log(options.log))
+
+    runs = [replay(options, session) for _ in range(options.repeat)]
+    results = {}
+    for seq, (_, command) in runs[0].items():
+        results[seq] = (median([run[seq][0] for run in runs if run[seq][0] is not None]), command)
+
+    if options.baseline:
+        with open(options.baseline) as f:
+            baseline = {r['seq']: r['latency'] for r in json.load(f)['requests']}
+    else:
+        baseline = session.latency
+
+    if options.save:
+        with open(options.save, 'w') as f:
+            json.dump({'log': options.log, 'requests': [{'seq': seq, 'command': command, 'latency': latency}
+                                                        for seq, (latency, command) in sorted(results.items())]}, f, indent=2)
+
+    def ms(value):
+        return '{:10.1f}'.format(value * 1000) if value is not None else '{:>10}'.format('-')
+
+    regressions = 0
+    print('{:>6} {:<28} {:>10} {:>10} {:>10} {:>8}'.format('seq', 'command', 'base(ms)' if options.baseline else 'rec(ms)',
+                                                            'replay(ms)', 'diff(ms)', 'diff(%)'))
+    for seq, (latency, command) in sorted(results.items()):
+        base = baseline.get(seq)
+        diff = latency - base if latency is not None and base is not None and options.baseline else None
+        percent = diff * 100 / base if diff is not None and base > 0 else None
+        mark = ''
+        if latency is None or (percent is not None and percent > options.threshold and diff * 1000 >= options.min_diff):
+            regressions += 1
+            mark = ' <-'
+        print('{:>6} {:<28} {} {} {} {:>8}{}'.format(seq, command, ms(base), ms(latency), ms(diff),
+                                                      '{:.1f}'.format(percent) if percent is not None else '-', mark))
+
+    total_base = sum(v for v in baseline.values() if v is not None)
+    total = sum(latency for latency, _ in results.values() if latency is not None)
+    if options.baseline:
+        print('Total: base {:.1f} ms, replay {:.1f} ms. Regressions: {}.'.format(total_base * 1000, total * 1000, regressions))
+    else:
+        print('Total: recorded {:.1f} ms (information only), replay {:.1f} ms. No response: {}.'.format(
+              total_base * 1000, total * 1000, regressions))
+
+    return 1 if options.fail_on_regression and regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())